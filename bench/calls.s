@@ -0,0 +1,55 @@
+#
+# Benchmark kernel: 100000 calls of a function reserving a stack frame and
+# calling a leaf function, exercising the method cache and the stack cache.
+#
+
+                .word   76;
+                add     r10 = r0, 100000;
+                add     r1  = r0, 0x100000;
+                mts     s5  = r1;
+                mts     s6  = r1;
+loop:           call    foo;
+                nop;
+                nop;
+                nop;
+                subi    r10 = r10, 1;
+                cmpneq  p1  = r10, r0;
+          (p1)  br      loop;
+                nop;
+                nop;
+                halt;
+                nop;
+                nop;
+                nop;
+                .word   80;
+foo:            sres    4;
+                mfs     r20 = srb;
+                mfs     r21 = sro;
+                sws     [r0 + 0] = r20;
+                sws     [r0 + 1] = r21;
+                addi    r2  = r2, 1;
+                call    bar;
+                nop;
+                nop;
+                nop;
+                lws     r20 = [r0 + 0];
+                lws     r21 = [r0 + 1];
+                nop;
+                mts     srb = r20;
+                mts     sro = r21;
+                sfree   4;
+                ret;
+                nop;
+                nop;
+                nop;
+                .word   40;
+bar:            sres    8;
+                sws     [r0 + 3] = r2;
+                lws     r3  = [r0 + 3];
+                nop;
+                add     r4  = r4, r3;
+                sfree   8;
+                ret;
+                nop;
+                nop;
+                nop;
@@ -0,0 +1,23 @@
+#
+# Benchmark kernel: arithmetic and multiplications, partly dual-issued, in a
+# loop of 400000 iterations without memory accesses.
+#
+
+                .word   92;
+                add     r10 = r0, 400000;
+                addi    r1  = r0, 1     ||  addi    r2  = r0, 3;
+                addi    r3  = r0, 0     ||  addi    r4  = r0, 7;
+loop:           add     r3  = r3, r1    ||  xor     r4  = r4, r2;
+                mul           r3, r4;
+                sli     r5  = r3, 3     ||  sri     r6  = r4, 2;
+                sub     r1  = r5, r6    ||  or      r2  = r2, r1;
+                mfs     r7  = sl;
+                subi    r10 = r10, 1;
+                cmpneq  p1  = r10, r0;
+          (p1)  br      loop;
+                add     r8  = r8, r7;
+                andi    r2  = r2, 255;
+                halt;
+                nop;
+                nop;
+                nop;
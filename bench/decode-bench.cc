@@ -0,0 +1,124 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Micro-benchmark measuring the time needed to decode the text sections of
+// a Patmos binary.
+//
+
+#include "basic-types.h"
+#include "decoder.h"
+#include "instruction.h"
+#include "loader.h"
+#include "simulation-core.h"
+#include "streams.h"
+#include "symbol.h"
+
+#include <boost/format.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+  // check arguments
+  if (argc < 2 || argc > 3)
+  {
+    std::cerr << "Usage: decode-bench <input> [<iterations>]\n";
+    return 1;
+  }
+
+  unsigned int iterations = argc == 3 ? std::atoi(argv[2]) : 200;
+
+  patmos::symbol_map_t symbols;
+  patmos::section_list_t text;
+
+  std::istream &in = *patmos::get_stream<std::ifstream>(argv[1], std::cin);
+  patmos::loader_t *loader = patmos::create_loader(in);
+  loader->load_symbols(symbols, text);
+
+  // collect the raw instruction words of all text sections, padded by one
+  // word so that the last bundle can always be read.
+  std::vector<patmos::word_t> words;
+  for (patmos::section_list_t::iterator t = text.begin(), te = text.end();
+       t != te; t++)
+  {
+    for (patmos::uword_t offset = t->offset; offset < t->offset + t->size;
+         offset += sizeof(patmos::word_t))
+    {
+      words.push_back(loader->read_word(offset));
+    }
+  }
+  words.push_back(0);
+
+  patmos::decoder_t decoder(false);
+  patmos::instruction_data_t id[patmos::NUM_SLOTS];
+
+  uint64_t num_bundles = 0;
+  uint64_t num_errors = 0;
+
+  std::chrono::steady_clock::time_point start =
+                                             std::chrono::steady_clock::now();
+
+  for (unsigned int i = 0; i < iterations; i++)
+  {
+    for (unsigned int w = 0; w + 1 < words.size(); )
+    {
+      unsigned int size = decoder.decode(&words[w], id);
+      if (size == 0)
+      {
+        num_errors++;
+        size = 1;
+      }
+
+      num_bundles++;
+      w += size;
+    }
+  }
+
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+  std::cout << boost::format("Words: %1%\nBundles decoded: %2%\n"
+                             "Errors: %3%\nTime: %4$.3f ms\n"
+                             "Decode: %5$.2f ns/bundle\n")
+            % (words.size() - 1) % num_bundles % num_errors % (ns / 1e6)
+            % (num_bundles ? ns / num_bundles : 0.0);
+
+  delete loader;
+  patmos::free_stream(&in);
+
+  return 0;
+}
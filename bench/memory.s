@@ -0,0 +1,28 @@
+#
+# Benchmark kernel: streams 16 times over 128 KB of the main memory through
+# the data cache, two loads and a store per 32 bytes.
+#
+
+                .word   100;
+                add     r10 = r0, 16;
+pass:           add     r1  = r0, 0x10000;
+                add     r2  = r0, 0x30000;
+loop:           lwc     r3  = [r1 + 0];
+                lwc     r4  = [r1 + 4];
+                add     r6  = r6, r3;
+                add     r6  = r6, r4;
+                swc     [r1 + 1] = r6;
+                addi    r1  = r1, 32;
+                cmplt   p1  = r1, r2;
+          (p1)  br      loop;
+                nop;
+                nop;
+                subi    r10 = r10, 1;
+                cmpneq  p2  = r10, r0;
+          (p2)  br      pass;
+                nop;
+                nop;
+                halt;
+                nop;
+                nop;
+                nop;
@@ -0,0 +1,442 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Benchmark measuring the simulation speed of pasim, running a set of
+// programs under several configurations and writing the host time, the
+// simulated MIPS, and the peak memory usage to a JSON file, which can be
+// compared to the results of another version of the simulator.
+//
+
+#include <boost/format.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/// A configuration of the simulator, i.e., a set of command-line options.
+struct config_t
+{
+  /// The name of the configuration.
+  std::string Name;
+
+  /// The options passed to pasim.
+  std::vector<std::string> Options;
+};
+
+/// The outcome of simulating a program in a configuration.
+struct result_t
+{
+  std::string Program;
+  std::string Config;
+
+  /// Whether the simulation ran and its statistics could be read.
+  bool Is_ok;
+
+  /// Simulated cycles of core 0 and retired operations of all cores.
+  uint64_t Cycles;
+  uint64_t Retired;
+
+  /// Fastest host time of all repetitions, in seconds.
+  double Host_time;
+
+  /// Largest resident set size of all repetitions, in KB.
+  uint64_t Peak_rss;
+
+  result_t() : Is_ok(false), Cycles(0), Retired(0), Host_time(0), Peak_rss(0)
+  {
+  }
+
+  /// @return The retired operations per second of host time, in millions.
+  double mips() const { return Host_time > 0 ? Retired / Host_time / 1e6 : 0; }
+};
+
+/// Run pasim once.
+/// @param args The arguments, starting with the path of pasim.
+/// @param host_time The host time of the run, in seconds.
+/// @param peak_rss The peak resident set size of the run, in KB.
+/// @return True if pasim terminated normally, its exit code is the exit code
+/// of the simulated program.
+static bool run_pasim(const std::vector<std::string> &args, double &host_time,
+                      uint64_t &peak_rss)
+{
+  std::vector<char*> argv;
+  for(unsigned int i = 0; i < args.size(); i++)
+    argv.push_back(const_cast<char*>(args[i].c_str()));
+  argv.push_back(NULL);
+
+  std::chrono::steady_clock::time_point start =
+                                             std::chrono::steady_clock::now();
+
+  pid_t pid = fork();
+  if (pid < 0)
+    return false;
+
+  if (pid == 0)
+  {
+    // no UART input, discard the UART output
+    int null = open("/dev/null", O_RDWR);
+    dup2(null, STDIN_FILENO);
+    dup2(null, STDOUT_FILENO);
+    dup2(null, STDERR_FILENO);
+
+    execv(argv[0], &argv[0]);
+    _exit(127);
+  }
+
+  int status;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) != pid)
+    return false;
+
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  host_time = std::chrono::duration<double>(end - start).count();
+
+#ifdef __APPLE__
+  // reported in bytes
+  peak_rss = usage.ru_maxrss / 1024;
+#else
+  peak_rss = usage.ru_maxrss;
+#endif
+
+  return WIFEXITED(status);
+}
+
+/// Read the simulated cycles and the retired operations from the statistics
+/// written by pasim, summing up the retired operations of all cores of a
+/// multi-core simulation.
+/// @param file The JSON file containing the statistics.
+/// @param result The result to update.
+/// @return True if the statistics could be read.
+static bool read_stats(const std::string &file, result_t &result)
+{
+  try
+  {
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(file, tree);
+
+    if (tree.count("cycles"))
+    {
+      result.Cycles = tree.get<uint64_t>("cycles");
+      result.Retired = tree.get<uint64_t>("retired");
+      return true;
+    }
+
+    result.Cycles = tree.get<uint64_t>("core0.cycles");
+    result.Retired = 0;
+    for(boost::property_tree::ptree::const_iterator i(tree.begin()),
+        ie(tree.end()); i != ie; i++)
+    {
+      result.Retired += i->second.get<uint64_t>("retired");
+    }
+    return true;
+  }
+  catch(boost::property_tree::ptree_error &e)
+  {
+    return false;
+  }
+}
+
+/// Simulate a program in a configuration several times.
+/// @param pasim The path of pasim.
+/// @param program The path of the program.
+/// @param config The configuration.
+/// @param repetitions The number of runs.
+/// @return The result of the fastest run.
+static result_t simulate(const std::string &pasim, const std::string &program,
+                         const config_t &config, unsigned int repetitions)
+{
+  result_t result;
+  result.Program = program.substr(program.find_last_of('/') + 1);
+  result.Config = config.Name;
+
+  char stats[] = "/tmp/sim-bench-XXXXXX";
+  int fd = mkstemp(stats);
+  if (fd < 0)
+    return result;
+  close(fd);
+
+  std::vector<std::string> args(1, pasim);
+  args.insert(args.end(), config.Options.begin(), config.Options.end());
+  args.push_back("-v");
+  args.push_back("--stats-format=json");
+  args.push_back(std::string("--stats-file=") + stats);
+  args.push_back(program);
+
+  result.Is_ok = true;
+  for(unsigned int i = 0; i < repetitions && result.Is_ok; i++)
+  {
+    double host_time;
+    uint64_t peak_rss;
+    result.Is_ok = run_pasim(args, host_time, peak_rss) &&
+                   read_stats(stats, result);
+
+    result.Host_time = i ? std::min(result.Host_time, host_time) : host_time;
+    result.Peak_rss = std::max(result.Peak_rss, peak_rss);
+  }
+
+  std::remove(stats);
+
+  return result;
+}
+
+/// Write the results as a JSON document.
+/// @param os The stream to write to.
+/// @param results The results.
+static void write_results(std::ostream &os,
+                          const std::vector<result_t> &results)
+{
+  os << "{\n  \"results\": [";
+  for(unsigned int i = 0; i < results.size(); i++)
+  {
+    const result_t &r(results[i]);
+    os << (i ? ",\n" : "\n")
+       << boost::format("    {\"program\": \"%1%\", \"config\": \"%2%\", "
+                        "\"status\": \"%3%\", \"cycles\": %4%, "
+                        "\"retired\": %5%, \"host_time\": %6$.6f, "
+                        "\"mips\": %7$.3f, \"peak_rss_kb\": %8%}")
+          % r.Program % r.Config % (r.Is_ok ? "ok" : "error") % r.Cycles
+          % r.Retired % r.Host_time % r.mips() % r.Peak_rss;
+  }
+  os << "\n  ]\n}\n";
+}
+
+/// Read results written by write_results.
+/// @param file The name of the JSON file.
+/// @param results The results read from the file.
+/// @return True on success, otherwise an error was printed.
+static bool read_results(const std::string &file,
+                         std::vector<result_t> &results)
+{
+  try
+  {
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(file, tree);
+
+    const boost::property_tree::ptree &list(tree.get_child("results"));
+    for(boost::property_tree::ptree::const_iterator i(list.begin()),
+        ie(list.end()); i != ie; i++)
+    {
+      result_t r;
+      r.Program = i->second.get<std::string>("program");
+      r.Config = i->second.get<std::string>("config");
+      r.Is_ok = i->second.get<std::string>("status") == "ok";
+      r.Cycles = i->second.get<uint64_t>("cycles");
+      r.Retired = i->second.get<uint64_t>("retired");
+      r.Host_time = i->second.get<double>("host_time");
+      r.Peak_rss = i->second.get<uint64_t>("peak_rss_kb");
+      results.push_back(r);
+    }
+    return true;
+  }
+  catch(boost::property_tree::ptree_error &e)
+  {
+    std::cerr << file << ": " << e.what() << "\n";
+    return false;
+  }
+}
+
+/// Print the results of a second run next to the results of a first run,
+/// e.g., of two versions of the simulator.
+/// @param os The stream to print to.
+/// @param base The results of the first run.
+/// @param results The results of the second run.
+static void compare_results(std::ostream &os,
+                            const std::vector<result_t> &base,
+                            const std::vector<result_t> &results)
+{
+  os << boost::format("%1$-16s %2$-10s %3$10s %4$10s %5$8s %6$10s %7$s\n")
+     % "program" % "config" % "MIPS" % "base MIPS" % "speedup" % "RSS KB"
+     % "";
+
+  for(unsigned int i = 0; i < results.size(); i++)
+  {
+    const result_t &r(results[i]);
+
+    const result_t *b = NULL;
+    for(unsigned int j = 0; j < base.size() && !b; j++)
+    {
+      if (base[j].Program == r.Program && base[j].Config == r.Config)
+        b = &base[j];
+    }
+
+    if (!b || !b->Is_ok || !r.Is_ok)
+    {
+      os << boost::format("%1$-16s %2$-10s %3$10s\n") % r.Program % r.Config
+         % (r.Is_ok ? "no base" : "error");
+      continue;
+    }
+
+    os << boost::format("%1$-16s %2$-10s %3$10.3f %4$10.3f %5$7.2fx %6$10d %7$s\n")
+       % r.Program % r.Config % r.mips() % b->mips()
+       % (r.Host_time > 0 ? b->Host_time / r.Host_time : 0.0) % r.Peak_rss
+       % (b->Cycles != r.Cycles ? "(cycles differ)" : "");
+  }
+}
+
+/// Print the usage of the benchmark.
+static void usage()
+{
+  std::cerr << "Usage: sim-bench [-o <output>] [-r <repetitions>] "
+               "[-c <name>=<options>]... <pasim> <program>...\n"
+               "       sim-bench --compare <base> <results>\n";
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+
+  // compare two result files
+  if (!args.empty() && args[0] == "--compare")
+  {
+    std::vector<result_t> base, results;
+    if (args.size() != 3)
+    {
+      usage();
+      return 1;
+    }
+    if (!read_results(args[1], base) || !read_results(args[2], results))
+      return 1;
+
+    compare_results(std::cout, base, results);
+    return 0;
+  }
+
+  std::string output("-");
+  unsigned int repetitions = 1;
+  std::vector<config_t> configs;
+
+  unsigned int a = 0;
+  for(; a + 1 < args.size() && args[a][0] == '-'; a += 2)
+  {
+    if (args[a] == "-o")
+      output = args[a + 1];
+    else if (args[a] == "-r")
+      repetitions = std::max(std::atoi(args[a + 1].c_str()), 1);
+    else if (args[a] == "-c" &&
+             args[a + 1].find('=') != std::string::npos)
+    {
+      std::string::size_type eq = args[a + 1].find('=');
+
+      config_t config;
+      config.Name = args[a + 1].substr(0, eq);
+
+      std::istringstream options(args[a + 1].substr(eq + 1));
+      std::string option;
+      while (options >> option)
+        config.Options.push_back(option);
+
+      configs.push_back(config);
+    }
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  if (a + 2 > args.size())
+  {
+    usage();
+    return 1;
+  }
+
+  // by default, simulate with the default options only
+  if (configs.empty())
+  {
+    configs.push_back(config_t());
+    configs.back().Name = "default";
+  }
+
+  std::string pasim(args[a]);
+
+  std::vector<result_t> results;
+  std::cout << boost::format("%1$-16s %2$-10s %3$12s %4$10s %5$10s %6$10s\n")
+               % "program" % "config" % "cycles" % "time s" % "MIPS"
+               % "RSS KB";
+
+  for(unsigned int c = 0; c < configs.size(); c++)
+  {
+    for(unsigned int p = a + 1; p < args.size(); p++)
+    {
+      results.push_back(simulate(pasim, args[p], configs[c], repetitions));
+
+      const result_t &r(results.back());
+      if (r.Is_ok)
+      {
+        std::cout << boost::format("%1$-16s %2$-10s %3$12d %4$10.3f "
+                                   "%5$10.3f %6$10d\n")
+                     % r.Program % r.Config % r.Cycles % r.Host_time
+                     % r.mips() % r.Peak_rss;
+      }
+      else
+      {
+        std::cout << boost::format("%1$-16s %2$-10s %3$12s\n")
+                     % r.Program % r.Config % "error";
+      }
+    }
+  }
+
+  if (output == "-")
+    write_results(std::cout, results);
+  else
+  {
+    std::ofstream os(output.c_str());
+    if (!os.good())
+    {
+      std::cerr << "Failed to open file: " << output << "\n";
+      return 1;
+    }
+    write_results(os, results);
+  }
+
+  for(unsigned int i = 0; i < results.size(); i++)
+  {
+    if (!results[i].Is_ok)
+      return 1;
+  }
+
+  return 0;
+}
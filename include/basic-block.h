@@ -0,0 +1,191 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+
+//
+// Basic blocks of translated bundles, executed by the bb engine.
+//
+
+#ifndef PATMOS_BASIC_BLOCK_H
+#define PATMOS_BASIC_BLOCK_H
+
+#include "simulation-core.h"
+
+#include <deque>
+#include <map>
+
+namespace patmos
+{
+  /// A bundle translated for the bb engine: the decoded instructions, the
+  /// simulation functions bound to their classes, and the properties that the
+  /// pipeline otherwise derives from the instructions in every cycle.
+  class translated_bundle_t
+  {
+  public:
+    /// Address of the bundle.
+    uword_t Address;
+
+    /// Raw (big-endian) instruction words the bundle was translated from.
+    word_t IW[NUM_SLOTS];
+
+    /// Number of words occupied by the bundle.
+    unsigned int Size;
+
+    /// The decoded instructions of the bundle.
+    instruction_data_t Ops[NUM_SLOTS];
+
+    /// Simulation functions of the instructions per pipeline stage, NULL for
+    /// empty slots and for the IF stage.
+    stage_function_t Functions[NUM_STAGES][NUM_SLOTS];
+
+    /// Number of delay slots for interrupt triggering of the first
+    /// instruction.
+    unsigned int Intr_delay_slots;
+
+    /// Flag indicating whether the bundle is a NOP.
+    bool Is_NOP;
+
+    /// Flag indicating whether the bundle contains a control-flow
+    /// instruction, i.e., ends a basic block.
+    bool Is_flow_control;
+
+    /// Name of the operations that may not be enabled simultaneously in both
+    /// slots, NULL if the instructions do not conflict.
+    const char *Conflict;
+
+    /// Destination register of a load in the first slot, r0 if the first
+    /// instruction is not a load.
+    GPR_e Load_dst;
+
+    /// Source registers of the instructions.
+    GPR_e Src1[NUM_SLOTS];
+    GPR_e Src2[NUM_SLOTS];
+  };
+
+  /// A basic block, i.e., a sequence of bundles ending with a control-flow
+  /// instruction. Blocks are translated lazily, bundle by bundle, as they are
+  /// fetched.
+  class basic_block_t
+  {
+  public:
+    /// The translated bundles, the references to the bundles stay valid when
+    /// the block grows.
+    typedef std::deque<translated_bundle_t> bundles_t;
+
+    /// Address of the first bundle.
+    uword_t Address;
+
+    /// Address following the last translated bundle.
+    uword_t End;
+
+    /// The translated bundles.
+    bundles_t Bundles;
+
+    /// The block entered when falling through the end of the block, if known.
+    basic_block_t *Next;
+
+    /// The block most recently entered from this block by control flow, if
+    /// known.
+    basic_block_t *Branch;
+
+    /// Construct an empty block.
+    /// @param address Address of the first bundle.
+    basic_block_t(uword_t address) : Address(address), End(address),
+                                     Next(NULL), Branch(NULL)
+    {
+    }
+
+    /// Check if the last bundle of the block ends the block.
+    bool is_complete() const
+    {
+      return !Bundles.empty() && Bundles.back().Is_flow_control;
+    }
+  };
+
+  /// Cache of the basic blocks translated by a simulator. Consecutive fetches
+  /// follow the bundles of the current block and the links between the
+  /// blocks, so that the blocks only need to be looked up by their address
+  /// when entered from a new place.
+  class block_cache_t
+  {
+  private:
+    /// Map of the translated blocks by their address.
+    typedef std::map<uword_t, basic_block_t*> blocks_t;
+
+    /// The translated blocks.
+    blocks_t Blocks;
+
+    /// The block of the most recently fetched bundle.
+    basic_block_t *Current;
+
+    /// Index of the bundle following the most recently fetched bundle.
+    unsigned int Index;
+
+    /// Get the block starting at an address, creating an empty block if
+    /// needed, and link it to the current block.
+    /// @param address The address of the block.
+    /// @return The block.
+    basic_block_t *enter(uword_t address);
+
+    /// Translate a bundle and append it to a block.
+    /// @param s The simulator executing the bundle.
+    /// @param block The block.
+    /// @param iw The instruction words of the bundle.
+    void translate(simulator_t &s, basic_block_t &block, const word_t *iw);
+
+    /// Prevent copying, the blocks are owned by the cache.
+    block_cache_t(const block_cache_t &);
+    block_cache_t &operator=(const block_cache_t &);
+  public:
+    /// Construct an empty cache.
+    block_cache_t();
+
+    /// Free the translated blocks.
+    ~block_cache_t();
+
+    /// Get the translated bundle at an address, translating it if needed.
+    /// If the bundle was modified since its translation, all blocks are
+    /// dropped and the simulator has to forget the references to their
+    /// bundles.
+    /// @param s The simulator executing the bundle.
+    /// @param address The address of the bundle.
+    /// @param iw The instruction words fetched from the address.
+    /// @return The translated bundle, or NULL if the blocks were dropped.
+    const translated_bundle_t *fetch(simulator_t &s, uword_t address,
+                                     const word_t *iw);
+
+    /// Drop all translated blocks.
+    void flush();
+  };
+}
+
+#endif // PATMOS_BASIC_BLOCK_H
@@ -147,6 +147,17 @@ namespace patmos
              (slot_mask & (1 << (slot & 1))) != 0;
     }
 
+    /// Check whether the format may match any instruction word whose bits
+    /// selected by a mask have the given value.
+    /// @param mask A bit mask selecting the bits to check.
+    /// @param bits The value of the selected bits.
+    /// @return False if no instruction word with the given bits can match the
+    /// format; true otherwise.
+    bool may_match(word_t mask, word_t bits) const
+    {
+      return ((bits ^ Opcode) & mask & Bit_mask) == 0;
+    }
+
     /// Return whether the instruction format is a long format (exclusively ALUl
     /// format).
     /// @return Return whether the instruction format is a long format
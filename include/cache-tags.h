@@ -0,0 +1,211 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Tag store shared by set-associative caches.
+//
+
+#ifndef PATMOS_CACHE_TAGS_H
+#define PATMOS_CACHE_TAGS_H
+
+#include "basic-types.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace patmos
+{
+  class checkpoint_writer_t;
+  class checkpoint_reader_t;
+
+  /// Tags of a set-associative cache, stored as structure of arrays.
+  /// The tags of a set are contiguous and compared with SIMD instructions
+  /// where available, valid bits are packed into words. The ways to evict
+  /// are selected by a replacement policy, see replacement-policy.h.
+  class set_assoc_tags_t
+  {
+  private:
+    /// Number of tags compared at once, sets are padded to a multiple of it.
+    static const unsigned int LANES = 8;
+
+    /// Number of valid bits per word.
+    static const unsigned int VALID_BITS = 64;
+
+    /// The number of sets.
+    unsigned int Num_sets;
+
+    /// The number of ways per set.
+    unsigned int Associativity;
+
+    /// Number of tags stored per set, including padding.
+    unsigned int Set_stride;
+
+    /// Number of valid words per set.
+    unsigned int Valid_stride;
+
+    /// The tags of all ways.
+    std::vector<uword_t> Tags;
+
+    /// The valid bits of all ways.
+    std::vector<uint64_t> Valid;
+
+    /// Compare a chunk of tags of a set.
+    /// @param tags Pointer to the first tag to compare.
+    /// @param count Number of tags to compare, a multiple of LANES.
+    /// @param tag The tag to look for.
+    /// @return A bit mask of the matching tags.
+    static uint64_t compare(const uword_t *tags, unsigned int count, uword_t tag)
+    {
+      uint64_t match = 0;
+#if defined(__AVX2__)
+      __m256i key = _mm256_set1_epi32(tag);
+      for(unsigned int i = 0; i < count; i += 8)
+      {
+        __m256i t = _mm256_loadu_si256((const __m256i*)(tags + i));
+        uint64_t m = _mm256_movemask_ps(
+                       _mm256_castsi256_ps(_mm256_cmpeq_epi32(t, key)));
+        match |= m << i;
+      }
+#elif defined(__SSE2__)
+      __m128i key = _mm_set1_epi32(tag);
+      for(unsigned int i = 0; i < count; i += 4)
+      {
+        __m128i t = _mm_loadu_si128((const __m128i*)(tags + i));
+        uint64_t m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(t, key)));
+        match |= m << i;
+      }
+#else
+      for(unsigned int i = 0; i < count; i++)
+      {
+        match |= (uint64_t)(tags[i] == tag) << i;
+      }
+#endif
+      return match;
+    }
+
+  public:
+    /// Construct a tag store, all ways are invalid.
+    /// @param num_sets The number of sets.
+    /// @param associativity The number of ways per set.
+    set_assoc_tags_t(unsigned int num_sets, unsigned int associativity);
+
+    /// Return the number of ways per set.
+    unsigned int associativity() const
+    {
+      return Associativity;
+    }
+
+    /// Find a tag in a set.
+    /// @param set The set to search.
+    /// @param tag The tag to look for.
+    /// @return The way holding the tag, or the associativity if the tag is
+    /// not in the set.
+    unsigned int find(unsigned int set, uword_t tag) const
+    {
+      const uword_t *tags = &Tags[set * Set_stride];
+      const uint64_t *valid = &Valid[set * Valid_stride];
+
+      for(unsigned int w = 0; w < Set_stride; w += VALID_BITS)
+      {
+        unsigned int count = std::min(VALID_BITS, Set_stride - w);
+        uint64_t match = compare(tags + w, count, tag) & valid[w / VALID_BITS];
+        if (match)
+          return w + __builtin_ctzll(match);
+      }
+
+      return Associativity;
+    }
+
+    /// Find an invalid way in a set.
+    /// @param set The set.
+    /// @return The first invalid way, or the associativity if all ways of the
+    /// set are valid.
+    unsigned int find_invalid(unsigned int set) const;
+
+    /// Store a tag in a way and mark the way as valid.
+    /// @param set The set of the way.
+    /// @param way The way.
+    /// @param tag The new tag of the way.
+    void insert(unsigned int set, unsigned int way, uword_t tag)
+    {
+      Tags[set * Set_stride + way] = tag;
+      Valid[set * Valid_stride + way / VALID_BITS] |=
+                                              (uint64_t)1 << (way % VALID_BITS);
+    }
+
+    /// Mark a way as invalid.
+    /// @param set The set of the way.
+    /// @param way The way.
+    void remove(unsigned int set, unsigned int way)
+    {
+      Valid[set * Valid_stride + way / VALID_BITS] &=
+                                            ~((uint64_t)1 << (way % VALID_BITS));
+    }
+
+    /// Check whether a way holds a valid tag.
+    /// @param set The set of the way.
+    /// @param way The way.
+    bool is_valid(unsigned int set, unsigned int way) const
+    {
+      return (Valid[set * Valid_stride + way / VALID_BITS] >>
+              (way % VALID_BITS)) & 1;
+    }
+
+    /// Return the tag of a way.
+    /// @param set The set of the way.
+    /// @param way The way.
+    uword_t tag(unsigned int set, unsigned int way) const
+    {
+      return Tags[set * Set_stride + way];
+    }
+
+    /// Get the valid ways of a set.
+    /// @param set The set.
+    /// @param ways The ways, replaced.
+    void get_valid_ways(unsigned int set, std::vector<unsigned int> &ways) const;
+
+    /// Invalidate all ways.
+    void invalidate();
+
+    /// Write the tags to a checkpoint.
+    void save_state(checkpoint_writer_t &cw) const;
+
+    /// Restore the tags from a checkpoint.
+    void restore_state(checkpoint_reader_t &cr);
+  };
+}
+
+#endif // PATMOS_CACHE_TAGS_H
@@ -0,0 +1,177 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Reading and writing checkpoints of the simulation state.
+//
+
+#ifndef PATMOS_CHECKPOINT_H
+#define PATMOS_CHECKPOINT_H
+
+#include "basic-types.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace patmos
+{
+  /// Size of the pages in which memory contents are stored in a checkpoint.
+  static const unsigned int CHECKPOINT_PAGE_BYTES = 4096;
+
+  /// Write the state of a simulation to a checkpoint file.
+  /// The file starts with a header, followed by the state of the simulator and
+  /// its components in a fixed order, each component writing its own state
+  /// field by field. Memory contents are stored in pages, leaving out pages
+  /// that are not in use.
+  class checkpoint_writer_t
+  {
+  private:
+    /// The name of the checkpoint file.
+    std::string Filename;
+
+    /// The stream to the checkpoint file.
+    std::ofstream Stream;
+
+    /// The number of bytes written so far.
+    uint64_t Offset;
+
+  public:
+    /// Create a new checkpoint file and write its header.
+    /// @param filename The name of the checkpoint file.
+    checkpoint_writer_t(const std::string &filename);
+
+    /// Write raw data to the checkpoint.
+    /// @param data The data to write.
+    /// @param size The number of bytes to write.
+    void write(const void *data, uint64_t size);
+
+    /// Write a value of a plain type to the checkpoint.
+    template<typename T>
+    void write(const T &value)
+    {
+      write(&value, sizeof(T));
+    }
+
+    /// Write a configuration parameter of a component, which is checked
+    /// against the configuration when the checkpoint is restored.
+    /// \see checkpoint_reader_t::check_config
+    void write_config(uint64_t value)
+    {
+      write(value);
+    }
+
+    /// Write the content of a memory, page by page.
+    /// @param data The content of the memory.
+    /// @param size The number of bytes of the memory.
+    /// @param pages Flags indicating the pages in use, only those are written.
+    void write_pages(const byte_t *data, uint64_t size,
+                     const std::vector<bool> &pages);
+
+    /// Flush the checkpoint file and check that it was written completely.
+    void finish();
+  };
+
+  /// Read the state of a simulation from a checkpoint file.
+  /// The components read their state in the same order in which it was
+  /// written.
+  /// \see checkpoint_writer_t
+  class checkpoint_reader_t
+  {
+  private:
+    /// The name of the checkpoint file.
+    std::string Filename;
+
+    /// The stream from the checkpoint file.
+    std::ifstream Stream;
+
+    /// The size of the checkpoint file in bytes.
+    uint64_t Size;
+
+    /// The number of bytes read so far.
+    uint64_t Offset;
+
+    /// Skip over data in the checkpoint.
+    /// @param size The number of bytes to skip.
+    void skip(uint64_t size);
+
+  public:
+    /// Open a checkpoint file and check its header.
+    /// @param filename The name of the checkpoint file.
+    checkpoint_reader_t(const std::string &filename);
+
+    /// Report an invalid checkpoint file.
+    /// @param msg A description of the problem.
+    void error(const std::string &msg) const;
+
+    /// Read raw data from the checkpoint.
+    /// @param data A buffer receiving the data.
+    /// @param size The number of bytes to read.
+    void read(void *data, uint64_t size);
+
+    /// Read a value of a plain type from the checkpoint.
+    template<typename T>
+    void read(T &value)
+    {
+      read(&value, sizeof(T));
+    }
+
+    /// Read a value of a plain type from the checkpoint.
+    template<typename T>
+    T read()
+    {
+      T value;
+      read(value);
+      return value;
+    }
+
+    /// Read a configuration parameter of a component and check that it
+    /// matches the current configuration.
+    /// @param value The configuration parameter of the simulation.
+    /// @param what A description of the parameter for the error message.
+    void check_config(uint64_t value, const char *what);
+
+    /// Read the content of a memory, page by page. Pages that are not stored
+    /// in the checkpoint are cleared if they are in use, other pages of the
+    /// buffer are not accessed.
+    /// @param data A buffer receiving the content of the memory.
+    /// @param size The number of bytes of the memory.
+    /// @param pages Flags indicating the pages of the buffer in use, updated
+    /// to the pages stored in the checkpoint.
+    void read_pages(byte_t *data, uint64_t size, std::vector<bool> &pages);
+
+    /// Check that the whole checkpoint has been read.
+    void finish();
+  };
+}
+
+#endif // PATMOS_CHECKPOINT_H
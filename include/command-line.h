@@ -51,6 +51,7 @@ namespace patmos
   {
     DF_SHORT,
     DF_TRACE,
+    DF_BTRACE,
     DF_INSTRUCTIONS,
     DF_BLOCKS,
     DF_CALLS,
@@ -139,7 +140,12 @@ namespace patmos
     SAC_NO,
     SAC_DM,
     SAC_LRU,
-    SAC_FIFO
+    SAC_FIFO,
+    SAC_PLRU,
+    SAC_BPLRU,
+    SAC_RANDOM,
+    SAC_SRRIP,
+    SAC_BRRIP
   };
   struct set_assoc_cache_type
   {
@@ -160,6 +166,58 @@ namespace patmos
   /// @param mck The set-associative cache kind.
   std::ostream &operator <<(std::ostream &os, set_assoc_cache_type dck);
 
+  /// Parsing prefetcher kinds of set-associative caches as command-line
+  /// options.
+  enum prefetch_kind_e
+  {
+    /// No prefetching.
+    PF_NO,
+    /// Prefetch the lines following a missing or prefetched line.
+    PF_NEXT,
+    /// Prefetch lines at the distance of the last two accesses, once the
+    /// distance repeats.
+    PF_STRIDE
+  };
+  struct prefetch_type
+  {
+    prefetch_kind_e kind;
+    /// Number of lines to prefetch.
+    unsigned degree;
+    prefetch_type() {};
+    prefetch_type(prefetch_kind_e kind_, unsigned degree_) :
+      kind(kind_), degree(degree_) {};
+  };
+
+  /// Parse a prefetcher kind from a string in a stream
+  /// @param in An input stream to read from.
+  /// @param pf The prefetcher kind.
+  std::istream &operator >>(std::istream &in, prefetch_type &pf);
+
+  /// Write a prefetcher kind as a string to an output stream.
+  /// @param os An output stream.
+  /// @param pf The prefetcher kind.
+  std::ostream &operator <<(std::ostream &os, prefetch_type pf);
+
+  /// Parsing write policies of the data cache as command-line options.
+  enum write_policy_e
+  {
+    /// Writes are passed on to the memory immediately.
+    WP_THROUGH,
+    /// Writes update the cache only, dirty lines are written back to the
+    /// memory when they are evicted.
+    WP_BACK
+  };
+
+  /// Parse a write policy from a string in a stream
+  /// @param in An input stream to read from.
+  /// @param wp The write policy.
+  std::istream &operator >>(std::istream &in, write_policy_e &wp);
+
+  /// Write a write policy as a string to an output stream.
+  /// @param os An output stream.
+  /// @param wp The write policy.
+  std::ostream &operator <<(std::ostream &os, write_policy_e wp);
+
   /// Parsing instruction cache kinds as command-line options.
   enum instr_cache_e
   {
@@ -215,6 +273,68 @@ namespace patmos
   /// @param sck The stack cache kind.
   std::ostream &operator <<(std::ostream &os, stack_cache_e sck);
 
+  /// Parsing execution engines as command-line options.
+  enum engine_e
+  {
+    /// Cycle-accurate pipeline simulation.
+    EN_CYCLE,
+    /// Cycle-accurate pipeline simulation executing basic blocks that are
+    /// translated once, falls back to the cycle engine while debug output is
+    /// printed.
+    EN_BB
+  };
+
+  /// Parse an execution engine from a string in a stream
+  /// @param in An input stream to read from.
+  /// @param en The execution engine.
+  std::istream &operator >>(std::istream &in, engine_e &en);
+
+  /// Write an execution engine as a string to an output stream.
+  /// @param os An output stream.
+  /// @param en The execution engine.
+  std::ostream &operator <<(std::ostream &os, engine_e en);
+
+  /// Parsing synchronization modes of multi-core simulations as command-line
+  /// options.
+  enum sync_e
+  {
+    /// All cores are synchronized after every cycle.
+    SY_CYCLE,
+    /// Cores run ahead of each other for at most a quantum of cycles.
+    SY_QUANTUM
+  };
+
+  /// Parse a synchronization mode from a string in a stream
+  /// @param in An input stream to read from.
+  /// @param sy The synchronization mode.
+  std::istream &operator >>(std::istream &in, sync_e &sy);
+
+  /// Write a synchronization mode as a string to an output stream.
+  /// @param os An output stream.
+  /// @param sy The synchronization mode.
+  std::ostream &operator <<(std::ostream &os, sync_e sy);
+
+  /// Parsing formats of statistics as command-line options.
+  enum stats_format_e
+  {
+    /// Human-readable tables.
+    SF_TEXT,
+    /// Comma-separated values, with a header line naming the columns.
+    SF_CSV,
+    /// JSON, objects nested along the hierarchy of the counter names.
+    SF_JSON
+  };
+
+  /// Parse a statistics format from a string in a stream
+  /// @param in An input stream to read from.
+  /// @param sf The statistics format.
+  std::istream &operator >>(std::istream &in, stats_format_e &sf);
+
+  /// Write a statistics format as a string to an output stream.
+  /// @param os An output stream.
+  /// @param sf The statistics format.
+  std::ostream &operator <<(std::ostream &os, stats_format_e sf);
+
   /// Parsing memory/cache sizes as command-line options.
   class byte_size_t
   {
@@ -292,6 +412,55 @@ namespace patmos
   /// @param os An output stream.
   /// @param a The address.
   std::ostream &operator <<(std::ostream &os, const address_t &a);
+
+  /// Parsing points of the simulation as command-line options, either a cycle
+  /// or a symbol whose address is reached by the program counter.
+  class sim_point_t
+  {
+    private:
+      uint64_t Cycle;
+
+      std::string Symbol;
+
+    public:
+      /// Construct a new simulation point.
+      /// @param cycle The initial cycle.
+      sim_point_t(uint64_t cycle = 0) : Cycle(cycle)
+      {
+      }
+
+      void set_symbol(const std::string &sym) {
+        Symbol = sym;
+      }
+
+      /// Check whether the point is given by a symbol.
+      bool is_symbol() const
+      {
+        return !Symbol.empty();
+      }
+
+      /// Return the cycle of the simulation point.
+      uint64_t cycle() const
+      {
+        return Cycle;
+      }
+
+      /// Return the symbol of the simulation point.
+      const std::string &symbol() const
+      {
+        return Symbol;
+      }
+  };
+
+  /// Read a simulation point as a cycle or a symbol.
+  /// @param in An input stream to read from.
+  /// @param p The result simulation point.
+  std::istream &operator >>(std::istream &in, sim_point_t &p);
+
+  /// Write a simulation point.
+  /// @param os An output stream.
+  /// @param p The simulation point.
+  std::ostream &operator <<(std::ostream &os, const sim_point_t &p);
 }
 
 #endif // PATMOS_COMMAND_LINE_H
@@ -0,0 +1,96 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Concrete types of the memory and the caches of a core, used to resolve the
+// calls of the main simulation loop at compile time.
+//
+
+#ifndef PATMOS_CORE_COMPONENTS_H
+#define PATMOS_CORE_COMPONENTS_H
+
+#include "data-cache.h"
+#include "instr-spm.h"
+#include "memory.h"
+#include "replacement-policy.h"
+#include "stack-cache.h"
+
+namespace patmos
+{
+  /// A final variant of a memory or cache class. Calls through a reference of
+  /// this type are bound at compile time.
+  template<typename T>
+  class final_t final : public T
+  {
+  public:
+    using T::T;
+  };
+
+  /// The types of the memory and the caches the main simulation loop of a
+  /// core is instantiated for. The calls of the loop are virtual unless the
+  /// types are final.
+  template<typename MEMORY, typename INSTR_CACHE, typename DATA_CACHE,
+           typename STACK_CACHE>
+  struct core_components_t
+  {
+    typedef MEMORY memory_type;
+    typedef INSTR_CACHE instr_cache_type;
+    typedef DATA_CACHE data_cache_type;
+    typedef STACK_CACHE stack_cache_type;
+  };
+
+  /// Components of any configuration, accessed through their interfaces.
+  typedef core_components_t<memory_t, instr_cache_t, data_cache_t,
+                            stack_cache_t> generic_core_t;
+
+  /// Fixed-delay main memory of the default configuration.
+  typedef final_t<fixed_delay_memory_t> default_memory_t;
+
+  /// Instruction SPM of the default configuration, its backing method cache
+  /// is accessed through the interface.
+  typedef final_t<instr_spm_t> default_instr_cache_t;
+
+  /// Direct-mapped data cache of the default configuration, also used for
+  /// the set-associative LRU caches.
+  typedef final_t<set_assoc_data_cache_t<lru_replacement_t> >
+                                                        default_data_cache_t;
+
+  /// Block stack cache of the default configuration.
+  typedef final_t<block_stack_cache_t> default_stack_cache_t;
+
+  /// Components of the default configuration.
+  typedef core_components_t<default_memory_t, default_instr_cache_t,
+                            default_data_cache_t, default_stack_cache_t>
+                                                        default_core_t;
+}
+
+#endif // PATMOS_CORE_COMPONENTS_H
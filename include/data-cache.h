@@ -37,7 +37,12 @@
 #ifndef PATMOS_DATA_CACHE_H
 #define PATMOS_DATA_CACHE_H
 
+#include "cache-tags.h"
+#include "command-line.h"
 #include "memory.h"
+#include "replacement-policy.h"
+
+#include <deque>
 
 namespace patmos
 {
@@ -47,7 +52,9 @@ namespace patmos
   public:
     virtual ~data_cache_t() {}
 
-    virtual void flush_cache() = 0;
+    /// Invalidate the content of the cache, dirty data is written back to the
+    /// memory first.
+    virtual void flush_cache(simulator_t &s) = 0;
   };
 
   /// An ideal data cache.
@@ -122,6 +129,12 @@ namespace patmos
       // to propagate this down to the memory here.
     }
 
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      // the memory is asked by the simulation main loop.
+      return std::numeric_limits<uint64_t>::max();
+    }
+
     /// Print the internal state of the memory to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) const
@@ -139,7 +152,7 @@ namespace patmos
 
     virtual void reset_stats() {}
 
-    virtual void flush_cache() {}
+    virtual void flush_cache(simulator_t &s) {}
   };
 
   /// A data cache always accessing a memory.
@@ -184,24 +197,30 @@ namespace patmos
   };
 
 
-  /// An associative, block-based data cache using LRU or FIF replacement policy and
-  /// a write-through strategy with no write allocation.
-  template<bool LRU_REPLACEMENT>
+  /// An associative, block-based data cache using a replacement policy from
+  /// replacement-policy.h. The cache keeps the data of its lines, writes are
+  /// either passed on to the memory (write-through) or kept in the cache
+  /// until a dirty line is evicted (write-back). Write misses optionally
+  /// allocate a line.
+  /// Optionally, lines evicted from the cache are kept in a small
+  /// fully-associative victim buffer, and a prefetcher loads the next lines
+  /// or lines at a detected stride while the memory is idle.
+  template<typename REPLACEMENT>
   class set_assoc_data_cache_t : public ideal_data_cache_t
   {
   private:
-    /// Representation of the tag of a cache line.
-    struct cache_tag_t
+    /// A line of the victim buffer.
+    struct victim_line_t
     {
-      /// Flag indicating whether the block is valid.
+      /// Flag indicating whether the line is valid.
       bool Is_valid;
 
-      /// The full address of the tag.
-      unsigned int Block_address;
-    };
+      /// Flag indicating whether the line has to be written back.
+      bool Is_dirty;
 
-    /// Array of cache tags
-    typedef cache_tag_t* cache_tags_t;
+      /// The address of the block held by the line.
+      uword_t Block_address;
+    };
 
     /// The number of blocks in the cache.
     unsigned int Num_blocks;
@@ -216,11 +235,72 @@ namespace patmos
     /// i.e., Num_blocks / Associativity.
     unsigned int Num_indexes;
 
+    /// The write policy of the cache.
+    write_policy_e Write_policy;
+
+    /// Flag indicating whether write misses allocate a cache line.
+    bool Is_write_allocate;
+
     /// Flag indicating whether the cache is waiting for a pending request.
     bool Is_busy;
 
-    /// Tag information of all the data cache's content.
-    cache_tags_t *Content;
+    /// Flag indicating that the pending write-through of a write access
+    /// follows the allocation of its line, i.e., that the access missed.
+    bool Is_write_allocated;
+
+    /// Tag information of all the data cache's content, the tags are the
+    /// full block addresses.
+    set_assoc_tags_t Tags;
+
+    /// The data of all cache lines, stored per set and way.
+    byte_t *Line_data;
+
+    /// Flags indicating whether a line was modified and has to be written
+    /// back to the memory on eviction, per set and way.
+    std::vector<bool> Is_dirty;
+
+    /// The replacement state of all sets.
+    REPLACEMENT Replacement;
+
+    /// Flags indicating whether a line was loaded by the prefetcher and not
+    /// accessed since, per set and way.
+    std::vector<bool> Is_prefetched;
+
+    /// The lines of the victim buffer, empty if there is none.
+    std::vector<victim_line_t> Victims;
+
+    /// The data of the lines of the victim buffer.
+    std::vector<byte_t> Victim_data;
+
+    /// The next line of the victim buffer to replace, in FIFO order.
+    unsigned int Victim_next;
+
+    /// The kind and degree of the prefetcher.
+    prefetch_type Prefetch;
+
+    /// Addresses of blocks to prefetch.
+    std::deque<uword_t> Prefetch_queue;
+
+    /// Flag indicating whether a prefetch is waiting for the memory.
+    bool Is_prefetching;
+
+    /// Flag indicating whether the pending prefetch is for instructions.
+    bool Is_prefetch_fetch;
+
+    /// Flag indicating whether a miss is waiting for the pending prefetch.
+    bool Is_prefetch_late;
+
+    /// The address of the block of the pending prefetch.
+    uword_t Prefetch_address;
+
+    /// Buffer receiving the data of the pending prefetch.
+    std::vector<byte_t> Prefetch_data;
+
+    /// The block address of the last access triggering the prefetcher.
+    uword_t Last_trigger_address;
+
+    /// The distance between the last two accesses triggering the prefetcher.
+    uword_t Last_stride;
 
     /// Number of stall cycles caused by method cache misses.
     unsigned int Num_stall_cycles;
@@ -249,18 +329,117 @@ namespace patmos
     /// Number of bytes written to the cache under a miss
     unsigned int Num_write_miss_bytes;
 
+    /// Number of lines allocated on a write miss.
+    unsigned int Num_allocations;
+
+    /// Number of dirty lines written back to the memory on eviction.
+    unsigned int Num_write_backs;
+
+    /// Number of blocks written to the memory by write accesses.
+    unsigned int Num_write_throughs;
+
+    /// Number of valid lines replaced by another block.
+    unsigned int Num_evictions;
+
+    /// Number of misses served from the victim buffer.
+    unsigned int Num_victim_hits;
+
+    /// Number of prefetches sent to the memory.
+    unsigned int Num_prefetches;
+
+    /// Number of prefetched lines accessed before their eviction.
+    unsigned int Num_useful_prefetches;
+
+    /// Number of misses on a block while its prefetch was pending.
+    unsigned int Num_late_prefetches;
+
+    /// Number of prefetches not loaded into the cache, because the memory
+    /// rejected the access or a dirty line would have to be written back.
+    unsigned int Num_dropped_prefetches;
+
     /// Align an address to the block size.
     /// @param address The memory address to read from.
     /// @param size The number of bytes to read.
     unsigned int get_block_address(uword_t address, uword_t size);
 
+    /// Get the set of a block in the cache.
+    /// @param block_address The address of the block.
+    unsigned int get_set(uword_t block_address) const
+    {
+      return (block_address / Num_block_bytes) % Num_indexes;
+    }
+
+    /// Get the data of a cache line.
+    /// @param set The set of the line.
+    /// @param way The way of the line.
+    byte_t *get_line(unsigned int set, unsigned int way) const
+    {
+      return Line_data + (set * Associativity + way) * Num_block_bytes;
+    }
+
+    /// Load a block into the least-recently used line of its cache set,
+    /// writing back the line's dirty data first. The loaded block becomes the
+    /// most-recently used line.
+    /// @param set The set of the block.
+    /// @param block_address The address of the block.
+    /// @param is_fetch Flag indicating whether the access is an instruction
+    /// fetch.
+    /// @param way The way the block was loaded into.
+    /// @return True when the block is in the cache, false while waiting for
+    /// the memory.
+    bool fill(simulator_t &s, unsigned int set, uword_t block_address,
+              bool is_fetch, unsigned int &way);
+
+    /// Find a block in the victim buffer.
+    /// @param block_address The address of the block.
+    /// @return The line holding the block, or the size of the victim buffer
+    /// if the block is not in the buffer.
+    unsigned int find_victim(uword_t block_address) const;
+
+    /// Move a valid cache line into the victim buffer, writing back the dirty
+    /// line it replaces in the buffer first.
+    /// @param set The set of the cache line.
+    /// @param way The way of the cache line.
+    /// @return True when the line was moved, false while waiting for the
+    /// memory.
+    bool evict_to_victims(simulator_t &s, unsigned int set, unsigned int way);
+
+    /// Notify the prefetcher of a miss or of a hit on a prefetched line.
+    /// @param block_address The address of the accessed block.
+    /// @param is_fetch Flag indicating whether the access is an instruction
+    /// fetch.
+    void trigger_prefetch(uword_t block_address, bool is_fetch);
+
+    /// Load the data of a completed prefetch into the cache.
+    void install_prefetch(simulator_t &s);
+
+    /// Count a hit on a line, notifying the prefetcher on the first hit on a
+    /// prefetched line.
+    /// @param set The set of the line.
+    /// @param way The way of the line.
+    /// @param is_fetch Flag indicating whether the access is an instruction
+    /// fetch.
+    void hit_prefetched(unsigned int set, unsigned int way, bool is_fetch);
+
   public:
     /// Construct a new data cache instance.
     /// @param memory The memory that is accessed through the cache.
+    /// @param associativity The number of lines per cache set.
     /// @param num_blocks The size of the cache in blocks.
+    /// @param num_block_bytes The size of a cache block in bytes.
+    /// @param write_policy The write policy of the cache.
+    /// @param write_allocate Flag indicating whether write misses allocate a
+    /// cache line.
+    /// @param seed Seed of randomized replacement policies.
+    /// @param num_victims The number of lines of the victim buffer.
+    /// @param prefetch The kind of the prefetcher.
     set_assoc_data_cache_t(memory_t &memory, unsigned int associativity,
                            unsigned int num_blocks,
-                           unsigned int num_block_bytes);
+                           unsigned int num_block_bytes,
+                           write_policy_e write_policy = WP_THROUGH,
+                           bool write_allocate = false, uword_t seed = 1,
+                           unsigned int num_victims = 0,
+                           prefetch_type prefetch = prefetch_type(PF_NO, 0));
 
     virtual ~set_assoc_data_cache_t();
 
@@ -280,11 +459,33 @@ namespace patmos
     /// otherwise.
     virtual bool write(simulator_t &s, uword_t address, byte_t *value, uword_t size);
 
+    /// Read some values from the memory -- DO NOT SIMULATE TIMING.
+    /// Data of cached blocks is taken from the cache.
+    /// @param address The memory address to read from.
+    /// @param value A pointer to a destination to store the value read from
+    /// the memory.
+    /// @param size The number of bytes to read.
+    virtual void read_peek(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch);
+
+    /// Write some values into the memory -- DO NOT SIMULATE TIMING, just write.
+    /// Cached blocks are updated as well.
+    /// @param address The memory address to write to.
+    /// @param value The value to be written to the memory.
+    /// @param size The number of bytes to write.
+    virtual void write_peek(simulator_t &s, uword_t address, byte_t *value, uword_t size);
+
     /// Check if the memory is busy handling some request.
     /// @return False in case the memory is currently handling some request,
     /// otherwise true.
     virtual bool is_ready();
 
+    /// Notify the cache that a cycle has passed, issuing prefetches.
+    virtual void tick(simulator_t &s);
+
+    virtual uint64_t get_idle_cycles(simulator_t &s);
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles);
+
     /// Print the internal state of the memory to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) const;
@@ -296,7 +497,13 @@ namespace patmos
 
     virtual void reset_stats();
 
-    virtual void flush_cache();
+    virtual void add_counters(stats_counters_t &counters);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
+
+    virtual void flush_cache(simulator_t &s);
   };
 }
 
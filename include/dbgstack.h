@@ -58,6 +58,8 @@ namespace patmos
     bool profiling_stats;
     bool hitmiss_stats;
 
+    stats_format_e format;
+
     debug_cache_e debug_cache;
 
     std::ostream *debug_out;
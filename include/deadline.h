@@ -43,8 +43,10 @@
 #ifndef PATMOS_DEADLINE_H
 #define PATMOS_DEADLINE_H
 
+#include <algorithm>
 #include <ostream>
 
+#include "checkpoint.h"
 #include "memory-map.h"
 
 namespace patmos
@@ -83,6 +85,7 @@ namespace patmos
         // set the delay counter
         //  +1 to ignore the current tick (as in HW)
         Delay_counter = get_word(value, size) + 1;
+        update_ticked();
       }
       else {
         simulation_exception_t::unmapped(address);
@@ -90,8 +93,34 @@ namespace patmos
       return true;
     }
 
+    virtual bool is_ticked() const { return Delay_counter > 0; }
+
     virtual void tick(simulator_t &s) {
-      if (Delay_counter > 0) Delay_counter--;
+      if (Delay_counter > 0 && --Delay_counter == 0) {
+        update_ticked();
+      }
+    }
+
+    virtual uint64_t get_idle_cycles(simulator_t &s) {
+      // a pending read completes once the counter has reached 0
+      return Delay_counter > 0 ? Delay_counter
+                               : std::numeric_limits<uint64_t>::max();
+    }
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles) {
+      Delay_counter -= std::min<uint64_t>(Delay_counter, cycles);
+      if (Delay_counter == 0) {
+        update_ticked();
+      }
+    }
+
+    virtual void save_state(checkpoint_writer_t &cw) const {
+      cw.write(Delay_counter);
+    }
+
+    virtual void restore_state(checkpoint_reader_t &cr) {
+      cr.read(Delay_counter);
+      update_ticked();
     }
   };
 }
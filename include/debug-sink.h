@@ -0,0 +1,388 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Writing the debug output from a background thread.
+//
+
+#ifndef PATMOS_DEBUG_SINK_H
+#define PATMOS_DEBUG_SINK_H
+
+#include "basic-types.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace patmos
+{
+  // forward definitions
+  class symbol_map_t;
+
+  /// Number of events buffered between the simulation and the writer thread,
+  /// a power of two.
+  static const unsigned int DEBUG_SINK_EVENTS = 1 << 16;
+
+  /// Number of bytes of text held by a single event.
+  static const unsigned int DEBUG_EVENT_TEXT = 40;
+
+  /// Number of registers printed by a single event of the register dump.
+  static const unsigned int DEBUG_EVENT_REGISTERS = 8;
+
+  /// Kinds of control-flow changes printed by the calls debug format.
+  enum debug_call_e
+  {
+    DC_CALL,
+    DC_RETURN,
+    DC_INTERRUPT
+  };
+
+  /// Print the header of the register dump of the debug output, i.e., the
+  /// cycle, the predicates, BASE, PC and the symbol of the PC.
+  /// @param os The output stream to print to.
+  /// @param cycle The current cycle.
+  /// @param pc The current program counter.
+  /// @param base The current base address.
+  /// @param prr The values of the predicate registers, one bit each.
+  /// @param nopc Skip printing the cycle, BASE, PC and the symbol.
+  /// @param symbols The symbols of the program.
+  void print_debug_header(std::ostream &os, uint64_t cycle, uword_t pc,
+                          uword_t base, unsigned int prr, bool nopc,
+                          const symbol_map_t &symbols);
+
+  /// Print the values of consecutive registers of the register dump of the
+  /// debug output.
+  /// @param os The output stream to print to.
+  /// @param prefix The prefix of the register names, 'r' or 's'.
+  /// @param first The index of the first register.
+  /// @param values The values of the registers.
+  /// @param count The number of registers.
+  /// @param is_short Print the registers in the short format (see DF_SHORT).
+  void print_debug_registers(std::ostream &os, char prefix,
+                             unsigned int first, const word_t *values,
+                             unsigned int count, bool is_short);
+
+  /// Print the entry of a block of the blocks debug format (see DF_BLOCKS).
+  /// @param os The output stream to print to.
+  /// @param pc The program counter at the start of the block.
+  /// @param cycle The current cycle.
+  /// @param nopc Skip printing the PC and the cycle.
+  /// @param symbols The symbols of the program.
+  void print_debug_block(std::ostream &os, uword_t pc, uint64_t cycle,
+                         bool nopc, const symbol_map_t &symbols);
+
+  /// Print a call, return or interrupt of the calls debug format (see
+  /// DF_CALLS).
+  /// @param os The output stream to print to.
+  /// @param kind The kind of the control-flow change.
+  /// @param pc The current program counter.
+  /// @param cycle The current cycle.
+  /// @param indent The number of levels to indent the entry.
+  /// @param nd Whether the control-flow change is non-delayed.
+  /// @param from The address of the control-flow instruction.
+  /// @param to The target of the control-flow change.
+  /// @param nopc Skip printing the PC and the cycle.
+  /// @param symbols The symbols of the program.
+  void print_debug_call(std::ostream &os, debug_call_e kind, uword_t pc,
+                        uint64_t cycle, unsigned int indent, bool nd,
+                        uword_t from, uword_t to, bool nopc,
+                        const symbol_map_t &symbols);
+
+  /// Print the arguments of a call (r3 to r8) or the return values of a
+  /// return (r1 and r2) of the calls debug format.
+  /// @param os The output stream to print to.
+  /// @param is_call Whether the values are the arguments of a call.
+  /// @param values The values of the registers.
+  void print_debug_call_values(std::ostream &os, bool is_call,
+                               const word_t *values);
+
+  /// An event of the debug output, either a piece of formatted text or the
+  /// raw data of a record of the debug output, to be formatted by the writer
+  /// thread.
+  struct debug_event_t
+  {
+    enum kind_e
+    {
+      TEXT,
+      TRACE,
+      BTRACE,
+      HEADER,
+      REGISTERS,
+      BLOCK,
+      CALL,
+      CALL_VALUES
+    };
+
+    /// Flags of an event.
+    enum flags_e
+    {
+      NOPC = 1,
+      SHORT = 2,
+      ND = 4
+    };
+
+    /// The kind of the event.
+    uint8_t Kind;
+
+    /// Number of bytes of text of a TEXT event, the number of registers of a
+    /// REGISTERS event, the kind of a CALL event.
+    uint8_t Size;
+
+    /// Combination of flags_e.
+    uint8_t Flags;
+
+    /// Prefix of the registers of a REGISTERS event.
+    char Prefix;
+
+    /// The address of a TRACE, BTRACE, BLOCK or CALL event, the PC of a
+    /// HEADER event, the first register of a REGISTERS event.
+    uword_t Address;
+
+    /// The cycle of the event.
+    uint64_t Cycle;
+
+    /// The number of traced bundles of a TRACE or BTRACE event, the base of a
+    /// HEADER event, the indentation of a CALL event.
+    uint64_t Count;
+
+    /// The symbols of a HEADER, BLOCK or CALL event.
+    const symbol_map_t *Symbols;
+
+    union
+    {
+      /// The text of a TEXT event.
+      char Text[DEBUG_EVENT_TEXT];
+
+      /// The register values of a HEADER, REGISTERS or CALL_VALUES event, the
+      /// target of a CALL event.
+      word_t Values[DEBUG_EVENT_TEXT / sizeof(word_t)];
+    };
+  };
+
+  /// A stream buffer passing the debug output to a background thread, which
+  /// formats the raw records and writes everything to the actual output
+  /// stream. The events are passed through a lock-free ring buffer, which
+  /// supports a single simulation thread writing to the stream buffer.
+  class debug_sink_t : public std::streambuf
+  {
+  private:
+    /// The actual output stream, only used by the writer thread.
+    std::ostream &Stream;
+
+    /// The ring buffer of events.
+    std::vector<debug_event_t> Events;
+
+    /// Number of events written by the simulation thread.
+    std::atomic<uint64_t> Head;
+
+    /// Number of events processed by the writer thread.
+    std::atomic<uint64_t> Tail;
+
+    /// The last value of Tail seen by the simulation thread.
+    uint64_t Cached_tail;
+
+    /// Buffer collecting the text written to the stream buffer.
+    char Pending[DEBUG_EVENT_TEXT];
+
+    /// Signal the writer thread to stop once all events are processed.
+    std::atomic<bool> Is_done;
+
+    /// Whether writing the output failed.
+    bool Is_failed;
+
+    /// Writer of the binary trace, used by the writer thread.
+    trace_writer_t *Trace_writer;
+
+    /// Number of events passed to the writer thread.
+    uint64_t Num_events;
+
+    /// Number of times the simulation waited for the writer thread.
+    uint64_t Num_stalls;
+
+    /// The writer thread.
+    std::thread Writer;
+
+    /// Wait until the writer thread has processed some events.
+    void wait_for_space();
+
+    /// Get the next free event of the ring buffer.
+    debug_event_t &next_event()
+    {
+      uint64_t head = Head.load(std::memory_order_relaxed);
+      if (head - Cached_tail == Events.size())
+      {
+        Cached_tail = Tail.load(std::memory_order_acquire);
+        if (head - Cached_tail == Events.size())
+          wait_for_space();
+      }
+      return Events[head & (Events.size() - 1)];
+    }
+
+    /// Pass the event returned by next_event to the writer thread.
+    void push()
+    {
+      Head.store(Head.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+      Num_events++;
+    }
+
+    /// Pass the text written so far to the writer thread.
+    void push_text();
+
+    /// Get the next free event, after passing the text written so far.
+    /// @param kind The kind of the event.
+    debug_event_t &add_event(debug_event_t::kind_e kind)
+    {
+      // keep the order with respect to text written before
+      if (pptr() != pbase())
+        push_text();
+
+      debug_event_t &e = next_event();
+      e.Kind = kind;
+      return e;
+    }
+
+    /// Main loop of the writer thread.
+    void write_events();
+
+    /// Format and write a single event.
+    void write_event(const debug_event_t &e);
+
+  protected:
+    virtual int_type overflow(int_type c);
+
+    virtual int sync();
+
+  public:
+    /// Construct a debug sink and start the writer thread.
+    /// @param stream The actual output stream.
+    debug_sink_t(std::ostream &stream);
+
+    /// Write all remaining events and stop the writer thread.
+    ~debug_sink_t();
+
+    /// Add a record of the instruction trace.
+    /// @param address The address of the retired bundle.
+    /// @param cycle The cycle in which the bundle retired.
+    /// @param count The number of traced bundles so far.
+    /// @param binary Write the record in the binary trace format.
+    void trace(uword_t address, uint64_t cycle, uint64_t count, bool binary)
+    {
+      debug_event_t &e = add_event(binary ? debug_event_t::BTRACE :
+                                            debug_event_t::TRACE);
+      e.Address = address;
+      e.Cycle = cycle;
+      e.Count = count;
+      push();
+    }
+
+    /// Add the header of a register dump, see print_debug_header.
+    void header(uint64_t cycle, uword_t pc, uword_t base, unsigned int prr,
+                bool nopc, const symbol_map_t &symbols)
+    {
+      debug_event_t &e = add_event(debug_event_t::HEADER);
+      e.Flags = nopc ? debug_event_t::NOPC : 0;
+      e.Address = pc;
+      e.Cycle = cycle;
+      e.Count = base;
+      e.Symbols = &symbols;
+      e.Values[0] = prr;
+      push();
+    }
+
+    /// Add the values of consecutive registers of a register dump, see
+    /// print_debug_registers.
+    void registers(char prefix, unsigned int first, const word_t *values,
+                   unsigned int count, bool is_short)
+    {
+      for(unsigned int i = 0; i < count; i += DEBUG_EVENT_REGISTERS)
+      {
+        debug_event_t &e = add_event(debug_event_t::REGISTERS);
+        e.Size = std::min(count - i, DEBUG_EVENT_REGISTERS);
+        e.Flags = is_short ? debug_event_t::SHORT : 0;
+        e.Prefix = prefix;
+        e.Address = first + i;
+        std::copy(values + i, values + i + e.Size, e.Values);
+        push();
+      }
+    }
+
+    /// Add the entry of a block, see print_debug_block.
+    void block(uword_t pc, uint64_t cycle, bool nopc,
+               const symbol_map_t &symbols)
+    {
+      debug_event_t &e = add_event(debug_event_t::BLOCK);
+      e.Flags = nopc ? debug_event_t::NOPC : 0;
+      e.Address = pc;
+      e.Cycle = cycle;
+      e.Symbols = &symbols;
+      push();
+    }
+
+    /// Add a call, return or interrupt, see print_debug_call.
+    void call(debug_call_e kind, uword_t pc, uint64_t cycle,
+              unsigned int indent, bool nd, uword_t from, uword_t to,
+              bool nopc, const symbol_map_t &symbols)
+    {
+      debug_event_t &e = add_event(debug_event_t::CALL);
+      e.Size = kind;
+      e.Flags = (nopc ? debug_event_t::NOPC : 0) | (nd ? debug_event_t::ND : 0);
+      e.Address = from;
+      e.Cycle = cycle;
+      e.Count = indent;
+      e.Symbols = &symbols;
+      e.Values[0] = to;
+      e.Values[1] = pc;
+      push();
+    }
+
+    /// Add the arguments or return values of a call, see
+    /// print_debug_call_values.
+    void call_values(bool is_call, const word_t *values)
+    {
+      debug_event_t &e = add_event(debug_event_t::CALL_VALUES);
+      e.Flags = is_call;
+      std::copy(values, values + (is_call ? 6 : 2), e.Values);
+      push();
+    }
+
+    /// Print statistics on the events passed to the writer thread.
+    /// @param os The output stream to print to.
+    void print_stats(std::ostream &os) const;
+  };
+}
+
+#endif // PATMOS_DEBUG_SINK_H
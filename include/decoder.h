@@ -52,6 +52,30 @@ namespace patmos
   class loader_t;
   class symbol_map_t;
   class section_info_t;
+  class decode_cache_entry_t;
+  class simulator_t;
+
+  /// Bit position of the opcode bits used to index the decoding table.
+  static const unsigned int DECODE_TABLE_SHIFT = 22;
+
+  /// Number of opcode bits used to index the decoding table.
+  static const unsigned int DECODE_TABLE_BITS = 5;
+
+  /// Number of entries in the cache of decoded bundles.
+  static const unsigned int NUM_DECODE_CACHE_ENTRIES = 4096;
+
+  /// Simulation function of an instruction in a pipeline stage.
+  typedef void (*stage_function_t)(simulator_t &s, instruction_data_t &ops);
+
+  /// Simulation functions of an instruction class in the pipeline stages,
+  /// bound to the class, i.e., they do not dispatch through the virtual
+  /// functions of instruction_t.
+  struct stage_functions_t
+  {
+    stage_function_t DR;
+    stage_function_t EX;
+    stage_function_t MW;
+  };
 
   class decoder_callback_t
   {
@@ -81,6 +105,22 @@ namespace patmos
     /// simulator.
     static instructions_t Instructions;
 
+    /// A list of binary formats that may match an instruction word.
+    typedef std::vector<const binary_format_t*> formats_t;
+
+    /// Binary formats indexed by the major opcode bits of the instruction
+    /// word, derived from the Instructions vector. Decoding thus only needs
+    /// to check the formats of a single entry.
+    static formats_t Decode_table[1 << DECODE_TABLE_BITS];
+
+    /// The simulation functions bound to the instruction classes, indexed by
+    /// the ID of the instructions.
+    static std::vector<stage_functions_t> Stage_functions;
+
+    /// Functions creating a new instance of the instruction classes, indexed
+    /// by the ID of the instructions.
+    static std::vector<instruction_t *(*)()> Instruction_factories;
+
     /// ID of the instruction used to encode NOPs
     static int NOP_ID;
 
@@ -97,6 +137,13 @@ namespace patmos
     /// error.
     unsigned int decode(word_t iw, word_t imm, unsigned int slot,
                         instruction_data_t &result);
+
+    /// Direct-mapped cache of decoded bundles, indexed by the bundle address.
+    decode_cache_entry_t *Decode_cache;
+
+    /// Prevent copying, the decode cache is owned by the decoder.
+    decoder_t(const decoder_t &);
+    decoder_t &operator=(const decoder_t &);
   public:
     /// Allow the use of loads, stores, and branch in the second issue slot
     /// as long as only one of each is enabled per bundle. I.e. is two loads
@@ -106,6 +153,9 @@ namespace patmos
     /// Construct a new instance of a Patmos decoder.
     decoder_t(bool use_permissive_dual_issue);
 
+    /// Free the decode cache.
+    ~decoder_t();
+
     /// Decode a binary encoded instruction bundle.
     /// @param iwp Pointer to binary data of the instruction bundle, the pointer
     /// has to point to an array of at least two elements.
@@ -118,6 +168,25 @@ namespace patmos
     /// error.
     unsigned int decode(word_t *iwp, instruction_data_t *result, bool throw_error=true);
 
+    /// Decode a binary encoded instruction bundle fetched from the given
+    /// address, reusing the result of an earlier decoding of the same bundle
+    /// if available. Invalid instructions are returned as in decode with
+    /// throw_error set to false.
+    /// The cache is tagged with the address and the instruction words, thus
+    /// modified code is never served from the cache. The address of each
+    /// returned instruction is set to its fetch address.
+    /// @param address The address the bundle was fetched from.
+    /// @param iwp Pointer to binary data of the instruction bundle, the pointer
+    /// has to point to an array of at least two elements.
+    /// @param result A pointer to an array to store the data of the decoded
+    /// instructions.
+    /// @return The number of words occupied by the decoded instructions.
+    unsigned int decode_cached(uword_t address, word_t *iwp,
+                               instruction_data_t *result);
+
+    /// Invalidate all entries of the decode cache.
+    void flush_decode_cache();
+
     /// Decode a stream of instructions provided by a binary loader.
     /// @return 0 on success, or any error code returned by the callback handler
     int decode(loader_t &loader, section_info_t &section,
@@ -139,6 +208,19 @@ namespace patmos
     /// Return instruction by ID.
     /// @return The instruction having the given ID.
     static instruction_t &get_instruction(int ID);
+
+    /// Return the simulation functions bound to the class of an instruction
+    /// known to the decoder or of the invalid instruction.
+    /// @param I The instruction.
+    /// @return The simulation functions of the instruction's class.
+    static const stage_functions_t &get_stage_functions(const instruction_t &I);
+
+    /// Create a new instance of the class of an instruction, e.g., to collect
+    /// statistics separately from the instruction known to the decoder.
+    /// @param ID The ID of the instruction.
+    /// @return A new instruction with the same ID and name, owned by the
+    /// caller.
+    static instruction_t *create_instruction(int ID);
   };
 }
 
@@ -164,6 +164,10 @@ namespace patmos
 
       virtual bool write(simulator_t &s, uword_t address, byte_t *value, uword_t size);
 
+      virtual void save_state(checkpoint_writer_t &cw) const;
+
+      virtual void restore_state(checkpoint_reader_t &cr);
+
       virtual void tick(simulator_t &s);
 
       /// Enables firing of interupts and exception handler ISRs. Does not disable
@@ -79,6 +79,15 @@ namespace patmos
     /// Notify the cache that a cycle passed.
     virtual void tick(simulator_t &s) = 0;
 
+    /// Get the number of upcoming cycles that can be skipped while the
+    /// pipeline is stalled with instruction fetching disabled.
+    /// \see memory_t::get_idle_cycles
+    virtual uint64_t get_idle_cycles(simulator_t &s) { return 0; }
+
+    /// Skip a number of idle cycles.
+    /// \see memory_t::skip_cycles
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles) {}
+
     /// Print debug information to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) = 0;
@@ -91,8 +100,22 @@ namespace patmos
     /// Reset statistics.
     virtual void reset_stats() = 0;
 
+    /// Add the counters sampled during the simulation to a set of counters.
+    /// By default, the cache has no such counters.
+    /// @param counters The set of counters.
+    virtual void add_counters(stats_counters_t &counters) {}
+
     /// Flush the cache.
-    virtual void flush_cache() = 0;
+    virtual void flush_cache(simulator_t &s) = 0;
+
+    /// Write the state of the cache to a checkpoint, not including any
+    /// statistics. By default, the cache has no state.
+    /// @param cw The checkpoint to write to.
+    virtual void save_state(checkpoint_writer_t &cw) const {}
+
+    /// Restore the state of the cache from a checkpoint.
+    /// @param cr The checkpoint to read from.
+    virtual void restore_state(checkpoint_reader_t &cr) {}
   };
 
 
@@ -147,6 +170,12 @@ namespace patmos
 
     virtual void tick(simulator_t &s) {}
 
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      // the memory and backing caches are only accessed by fetches
+      return std::numeric_limits<uint64_t>::max();
+    }
+
     virtual void print(const simulator_t &s, std::ostream &os) {}
 
     virtual void print_stats(const simulator_t &s, std::ostream &os,
@@ -154,7 +183,11 @@ namespace patmos
 
     virtual void reset_stats();
 
-    virtual void flush_cache() {}
+    virtual void flush_cache(simulator_t &s) {}
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
 
@@ -190,6 +223,12 @@ namespace patmos
       no_instr_cache_t::tick(s);
     }
 
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      // the backing cache might prefetch
+      return Backing_cache->get_idle_cycles(s);
+    }
+
     /// Print debug information to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os)
@@ -222,8 +261,28 @@ namespace patmos
       no_instr_cache_t::reset_stats();
     }
 
-    virtual void flush_cache() {
-      Backing_cache->flush_cache();
+    virtual void flush_cache(simulator_t &s) {
+      Backing_cache->flush_cache(s);
+    }
+
+    virtual void add_counters(stats_counters_t &counters) {
+      if (IS_OWNING_CACHE) {
+        Backing_cache->add_counters(counters);
+      }
+    }
+
+    virtual void save_state(checkpoint_writer_t &cw) const {
+      if (IS_OWNING_CACHE) {
+        Backing_cache->save_state(cw);
+      }
+      no_instr_cache_t::save_state(cw);
+    }
+
+    virtual void restore_state(checkpoint_reader_t &cr) {
+      if (IS_OWNING_CACHE) {
+        Backing_cache->restore_state(cr);
+      }
+      no_instr_cache_t::restore_state(cr);
     }
   };
 
@@ -95,6 +95,14 @@ namespace patmos
 
     virtual void tick(simulator_t &s) { Cache->tick(s); }
 
+    virtual uint64_t get_idle_cycles(simulator_t &s) {
+      return Cache->get_idle_cycles(s);
+    }
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles) {
+      Cache->skip_cycles(s, cycles);
+    }
+
     virtual void print(const simulator_t &s, std::ostream &os) {
       Cache->print(s, os);
     }
@@ -104,7 +112,17 @@ namespace patmos
 
     virtual void reset_stats();
 
-    virtual void flush_cache();
+    virtual void add_counters(stats_counters_t &counters);
+
+    virtual void flush_cache(simulator_t &s);
+
+    virtual void save_state(checkpoint_writer_t &cw) const {
+      Cache->save_state(cw);
+    }
+
+    virtual void restore_state(checkpoint_reader_t &cr) {
+      Cache->restore_state(cr);
+    }
   };
 
 }
@@ -105,6 +105,10 @@ namespace patmos
     /// Returns true if the instruction is a multiply instruction
     virtual bool is_multiply() const { return false; }
 
+    /// Returns true if repeating the EX stage of the instruction while the
+    /// pipeline is stalled has effects besides recomputing its results
+    virtual bool has_ex_side_effects() const { return false; }
+
     /// Returns the number of delay slot cycles of this instruction
     virtual unsigned get_delay_slots(const instruction_data_t &ops) const = 0;
 
@@ -364,9 +368,6 @@ namespace patmos
 
     // -------------------------- DR -------------------------------------------
 
-    /// Decoded immediate from DR stage.
-    word_t DR_Imm;
-
     /// Read value from special register at the DR stage.
     word_t DR_Ss;
 
@@ -388,11 +389,13 @@ namespace patmos
     /// Value of the instruction's predicate as read at the DR stage.
     bit_t DR_Pred;
 
-    /// Current base address of the method cache, as read at the DR stage.
-    GPR_op_t DR_Base;
+    // The MW flags are kept next to the DR flags to avoid padding.
+
+    /// Discard instructions in MW stage (stalling).
+    bool MW_Discard;
 
-    /// Current method offset of the method cache, as read at the DR stage.
-    GPR_op_t DR_Offset;
+    /// Keep track if this is the first cycle in the MW stage.
+    bool MW_Initialized;
 
     // -------------------------- EX -------------------------------------------
 
@@ -428,13 +431,6 @@ namespace patmos
     /// Method offset as read in EX stage.
     word_t EX_Offset;
 
-    // -------------------------- MW -------------------------------------------
-    /// Discard instructions in MW stage (stalling).
-    word_t MW_Discard;
-
-    /// Keep track if this is the first cycle in the MW stage.
-    word_t MW_Initialized;
-
     // ------------------------ CONSTRUCTOR  -----------------------------------
 
     /// Create a bubble..
@@ -446,6 +442,29 @@ namespace patmos
     /// executed.
     instruction_data_t(const instruction_t &i, PRR_e pred);
 
+    /// Turn the instruction into a bubble, without clearing the values of the
+    /// pipeline stages.
+    void reset()
+    {
+      I = NULL;
+      Address = 0;
+      Pred = pn0;
+      GPR_EX_Rd.reset();
+    }
+
+    /// Take over a decoded instruction, i.e., its instruction class, address,
+    /// predicate and operands, and discard the state of the previous
+    /// instruction.
+    /// @param decoded The decoded instruction.
+    void set_decoded(const instruction_data_t &decoded)
+    {
+      I = decoded.I;
+      Address = decoded.Address;
+      Pred = decoded.Pred;
+      OPS = decoded.OPS;
+      GPR_EX_Rd.reset();
+    }
+
     // -------------------- CONSTRUCTOR FUNCTIONS ------------------------------
 
     /// Create an invalid instruction
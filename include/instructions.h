@@ -1400,7 +1400,7 @@ namespace patmos
     {
       ops.DR_Pred = s.PRR.get(ops.Pred).get();
       ops.DR_Rs1 = s.GPR.get(ops.OPS.LDT.Ra);
-      ops.MW_Discard = 0;
+      ops.MW_Discard = false;
     }
 
     // EX implemented by sub classes
@@ -1423,8 +1423,7 @@ namespace patmos
           
           // TODO this is a very quick hack for now, should be moved to a 
           //      Debug class (see stores).
-          if (!s.Debug_mem_address.empty() &&
-              s.Debug_mem_address.count(ops.EX_Address))
+          if (s.Watchpoints.contains(ops.EX_Address, WK_READ))
           {
             std::cerr << "*** Load: " << result 
                       << " = [0x" << std::hex << ops.EX_Address << std::dec << " ";
@@ -1434,7 +1433,7 @@ namespace patmos
           }
           
           store_GPR_MW_result(s, ops, ops.OPS.LDT.Rd, result);
-          ops.MW_Discard = 1;
+          ops.MW_Discard = true;
         }
         else
         {
@@ -1591,7 +1590,7 @@ namespace patmos
       ops.DR_Pred = s.PRR.get(ops.Pred).get();
       ops.DR_Rs1 = s.GPR.get(ops.OPS.STT.Ra);
       ops.DR_Rs2 = s.GPR.get(ops.OPS.STT.Rs1);
-      ops.MW_Discard = 0;
+      ops.MW_Discard = false;
     }
 
     /// Pipeline function to simulate the behavior of the instruction in
@@ -1614,8 +1613,7 @@ namespace patmos
           // s.Debug class, which properly prints out (or not) all the debug related
           // stuff (including traces, RTC events, ..), like
           // s.Debug.print_store(ops.EX_Address, ops.Ex_Rs);
-          if (!s.Debug_mem_address.empty() &&
-              s.Debug_mem_address.count(ops.EX_Address))
+          if (s.Watchpoints.contains(ops.EX_Address, WK_WRITE))
           {
             std::cerr << "*** Store: [0x" << std::hex << ops.EX_Address << std::dec << " ";
             s.Symbols.print(std::cerr, ops.EX_Address);
@@ -1623,7 +1621,7 @@ namespace patmos
             << " (PC: 0x" <<std::hex << s.PC << std::dec << ", cycle: " << s.Cycle << ")\n";
           }
           
-          ops.MW_Discard = 1;
+          ops.MW_Discard = true;
         }
       }
     }
@@ -1728,6 +1726,7 @@ namespace patmos
   public:
     virtual bool is_main_mem_op() const { return true; }
     virtual bool is_stack_op() const { return true; }
+    virtual bool has_ex_side_effects() const { return true; }
     virtual void EX(simulator_t &s, instruction_data_t &ops) const
     {
       // Get the size argument
@@ -1756,7 +1755,7 @@ namespace patmos
         s.pipeline_stall(SMW);
       }
       else {
-        ops.MW_Discard = 1;
+        ops.MW_Discard = true;
       }
     }
     
@@ -1780,7 +1779,7 @@ namespace patmos
       ops.DR_Pred = s.PRR.get(ops.Pred).get();
       ops.DR_Ss = s.SPR.get(ss).get();
       ops.DR_St = s.SPR.get(st).get();
-      ops.MW_Discard = 0;
+      ops.MW_Discard = false;
     }
     
     virtual void print_operands(const simulator_t &s, std::ostream &os,
@@ -1832,7 +1831,7 @@ namespace patmos
       ops.DR_Ss = s.SPR.get(ss).get();
       ops.DR_St = s.SPR.get(st).get();
       ops.DR_Rs1 = s.GPR.get(ops.OPS.STCr.Rs);
-      ops.MW_Discard = 0;
+      ops.MW_Discard = false;
     }
     
     virtual void print_operands(const simulator_t &s, std::ostream &os,
@@ -2229,6 +2228,7 @@ namespace patmos
   };
 
   class i_trap_t : public i_cfl_t {
+  public:
     virtual void print(std::ostream &os, const instruction_data_t &ops,
                        const symbol_map_t &symbols) const
     {
@@ -2238,6 +2238,8 @@ namespace patmos
 
     virtual bool is_main_mem_op() const { return true; }
 
+    virtual bool has_ex_side_effects() const { return true; }
+
     virtual void DR(simulator_t &s, instruction_data_t &ops) const
     {
       ops.DR_Pred = s.PRR.get(ops.Pred).get();
@@ -38,6 +38,7 @@
 #define PATMOS_MEMORY_MAP_H
 
 #include "memory.h"
+#include "stats-counters.h"
 
 #include <ostream>
 #include <vector>
@@ -46,6 +47,7 @@ namespace patmos
 {
   class simulator_t;
   class excunit_t;
+  class memory_map_t;
 
   /// Default address of the UART status register.
   static const uword_t IOMAP_BASE_ADDRESS = 0xF0000000;
@@ -107,6 +109,10 @@ namespace patmos
   /// Number of bytes mapped to the EthMac device.
   static const uword_t ETHMAC_MAP_SIZE = 0x10000;
 
+  /// Number of address bits per page of the device lookup table of the
+  /// memory map, the devices are mapped at this granularity by default.
+  static const unsigned int DEVICE_PAGE_BITS = 16;
+
   class mapped_device_t {
   protected:
     /// Base address of this device
@@ -115,10 +121,20 @@ namespace patmos
     // Number of bytes mapped to this device
     uword_t Mapped_bytes;
 
+    /// Notify the memory map the device is added to that the result of
+    /// is_ticked may have changed, e.g., because an event has been armed.
+    void update_ticked();
+
+  private:
+    friend class memory_map_t;
+
+    /// The memory map the device is added to, if any.
+    memory_map_t *Map;
+
   public:
 
     mapped_device_t(uword_t base_address, uword_t mapped_bytes)
-    : Base_address(base_address), Mapped_bytes(mapped_bytes)
+    : Base_address(base_address), Mapped_bytes(mapped_bytes), Map(NULL)
     {}
 
     virtual ~mapped_device_t() {}
@@ -175,9 +191,25 @@ namespace patmos
       set_word(value, size, 0);
     }
 
-    /// Notify the device that a cycle has passed.
+    /// Check whether the device needs to be notified of every cycle. Only
+    /// such devices are ticked by the memory map. Devices whose result
+    /// changes must call update_ticked.
+    virtual bool is_ticked() const { return false; }
+
+    /// Notify the device that a cycle has passed, see is_ticked.
     virtual void tick(simulator_t &s) { }
 
+    /// Get the number of upcoming cycles in which ticking the device does not
+    /// raise an event or complete an access, see memory_t::get_idle_cycles.
+    /// Devices that are ticked or whose accesses may stall must override
+    /// this as well.
+    virtual uint64_t get_idle_cycles(simulator_t &s) {
+      return std::numeric_limits<uint64_t>::max();
+    }
+
+    /// Skip a number of idle cycles, see memory_t::skip_cycles.
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles) { }
+
     /// Print the internal state of the memory to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) const { }
@@ -189,6 +221,15 @@ namespace patmos
 
     /// Reset the statistics.
     virtual void reset_stats() { }
+
+    /// Write the state of the device to a checkpoint, not including any
+    /// statistics. By default, the device has no state.
+    /// @param cw The checkpoint to write to.
+    virtual void save_state(checkpoint_writer_t &cw) const { }
+
+    /// Restore the state of the device from a checkpoint.
+    /// @param cr The checkpoint to read from.
+    virtual void restore_state(checkpoint_reader_t &cr) { }
   };
 
 
@@ -220,12 +261,32 @@ namespace patmos
     virtual void peek(simulator_t &s, uword_t address, byte_t *value, uword_t size);
   };
 
+  /// Performance counters of the caches and the memory, the registers read
+  /// the live statistics counters of the simulator accessing them.
   class perfcounters_t : public mapped_device_t
   {
+  private:
+    /// Number of registers of the device.
+    static const unsigned int NUM_REGISTERS = PERFCOUNTERS_MAP_SIZE / 4;
+
+    /// The counters of the simulator, set up by its first read.
+    stats_counters_t Counters;
+
+    /// Flag indicating whether the counters are set up.
+    bool Is_attached;
+
+    /// The indices of the counters summed up by each register.
+    std::vector<unsigned int> Registers[NUM_REGISTERS];
+
+    /// Set up the counters of a simulator and find the counters of the
+    /// registers, registers without counters in the simulator read zero.
+    /// @param s The simulator.
+    void attach(simulator_t &s);
+
   public:
 
   perfcounters_t(uword_t base_address)
-    : mapped_device_t(base_address, PERFCOUNTERS_MAP_SIZE)
+    : mapped_device_t(base_address, PERFCOUNTERS_MAP_SIZE), Is_attached(false)
     {}
 
     virtual bool read(simulator_t &s, uword_t address, byte_t *value, uword_t size);
@@ -266,6 +327,10 @@ namespace patmos
     virtual bool write(simulator_t &s, uword_t address, byte_t *value, uword_t size);
 
     virtual uword_t xlate(uword_t address, mmu_op_t op);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   class led_t : public mapped_device_t
@@ -282,6 +347,10 @@ namespace patmos
     virtual bool read(simulator_t &s, uword_t address, byte_t *value, uword_t size);
 
     virtual bool write(simulator_t &s, uword_t address, byte_t *value, uword_t size);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   class ethmac_t : public mapped_device_t
@@ -311,7 +380,13 @@ namespace patmos
 
     virtual bool write(simulator_t &s, uword_t address, byte_t *value, uword_t size);
 
+    virtual bool is_ticked() const {
+      return fd >= 0 && ((tx && !tx_ready) || (rx && !rx_ready));
+    }
+
     virtual void tick(simulator_t &s);
+
+    virtual uint64_t get_idle_cycles(simulator_t &s);
   };
 
   /// Map several devices into the address space of another memory device
@@ -329,12 +404,46 @@ namespace patmos
     /// List of start-address,high-address pairs per device
     AddressList Device_map;
 
+    /// The devices to tick, see mapped_device_t::is_ticked.
+    DeviceList Ticked_devices;
+
+    /// Whether Ticked_devices has to be rebuilt before the next tick.
+    bool Is_ticked_changed;
+
+    /// Index + 1 of the only device mapped to a page of the mapped address
+    /// range, 0 if there is none, SHARED_PAGE if there are several.
+    std::vector<unsigned int> Device_pages;
+
+    /// Marks a page of Device_pages to which several devices are mapped.
+    static const unsigned int SHARED_PAGE = ~0u;
+
     uword_t Base_address;
 
     uword_t High_address;
 
+    /// Check whether an address is in the mapped address range.
+    bool is_mapped(uword_t address) const
+    {
+      return address - Base_address <= High_address - Base_address;
+    }
+
   protected:
-    mapped_device_t& find_device(uword_t address);
+    /// Find the device an address is mapped to.
+    mapped_device_t& find_device(uword_t address)
+    {
+      // most pages hold a single device
+      unsigned int i = Device_pages[(address - Base_address) >>
+                                    DEVICE_PAGE_BITS] - 1;
+      if (i < Devices.size() && address >= Device_map[i].first &&
+          address <= Device_map[i].second)
+      {
+        return *Devices[i];
+      }
+      return find_shared_device(address);
+    }
+
+    /// Find the device an address is mapped to by searching all devices.
+    mapped_device_t& find_shared_device(uword_t address);
 
   public:
     /// Construct a new memory map.
@@ -342,11 +451,18 @@ namespace patmos
     /// @param base_address The start address of the mapped address range.
     /// @param high_address The highest address of the mapped address range.
     memory_map_t(memory_t &memory, uword_t base_address, uword_t high_address)
-    : Memory(memory), Base_address(base_address), High_address(high_address)
+    : Memory(memory), Is_ticked_changed(false),
+      Device_pages(((high_address - base_address) >> DEVICE_PAGE_BITS) + 1, 0),
+      Base_address(base_address), High_address(high_address)
     {}
 
+    /// Map a device into the address range, and tick it if needed.
     void add_device(mapped_device_t &device);
 
+    /// Rebuild the list of ticked devices before the next tick, see
+    /// mapped_device_t::update_ticked.
+    void update_ticked() { Is_ticked_changed = true; }
+
     /// A simulated access to a read port.
     /// @param address The memory address to read from.
     /// @param value A pointer to a destination to store the value read from
@@ -384,6 +500,10 @@ namespace patmos
     /// Notify the memory that a cycle has passed.
     virtual void tick(simulator_t &s);
 
+    virtual uint64_t get_idle_cycles(simulator_t &s);
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles);
+
     /// Print the internal state of the memory to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) const;
@@ -394,6 +514,17 @@ namespace patmos
                              const stats_options_t& options);
 
     virtual void reset_stats();
+
+    virtual void add_counters(stats_counters_t &counters)
+    {
+      Memory.add_counters(counters);
+    }
+
+    /// Write the state of the mapped memory and of all devices to a
+    /// checkpoint.
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 }
 
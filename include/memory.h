@@ -47,12 +47,17 @@
 
 #include <map>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 namespace patmos
 {
   class simulator_t;
   struct stats_options_t;
   class mmu_t;
+  class checkpoint_writer_t;
+  class checkpoint_reader_t;
+  class stats_counters_t;
 
   /// Basic interface to access main memory during simulation.
   class memory_t
@@ -141,6 +146,25 @@ namespace patmos
     /// Notify the memory that a cycle has passed.
     virtual void tick(simulator_t &s) = 0;
 
+    /// Get the number of upcoming cycles that can be skipped while the
+    /// pipeline is stalled, i.e., cycles in which a stalled access would
+    /// simply be repeated without completing. The count includes the cycle
+    /// whose tick completes a pending request.
+    /// @return The number of cycles that can be skipped, zero if unknown.
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      return 0;
+    }
+
+    /// Skip a number of idle cycles, updating the state and statistics as if
+    /// the stalled access was repeated and tick was called in each cycle.
+    /// The time of the simulator still refers to the last simulated cycle.
+    /// @param cycles The number of cycles to skip, at most the number
+    /// returned by get_idle_cycles.
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles)
+    {
+    }
+
     /// Print the internal state of the memory to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) const = 0;
@@ -157,28 +181,56 @@ namespace patmos
 
     /// Reset statistics.
     virtual void reset_stats() = 0;
+
+    /// Add the counters sampled during the simulation to a set of counters.
+    /// By default, the memory has no such counters.
+    /// @param counters The set of counters.
+    virtual void add_counters(stats_counters_t &counters) {}
+
+    /// Write the state of the memory to a checkpoint, not including any
+    /// statistics. By default, the memory has no state.
+    /// @param cw The checkpoint to write to.
+    virtual void save_state(checkpoint_writer_t &cw) const {}
+
+    /// Restore the state of the memory from a checkpoint.
+    /// @param cr The checkpoint to read from.
+    virtual void restore_state(checkpoint_reader_t &cr) {}
   };
 
+  /// Size of the pages in which the content of an ideal memory is initialized
+  /// on demand.
+  static const unsigned int MEMORY_PAGE_BYTES = 4096;
+
   /// An ideal memory.
+  /// The content is reserved up front, but the operating system only
+  /// allocates the pages that are actually accessed.
   class ideal_memory_t : public memory_t
   {
   protected:
     /// The size of the memory in bytes.
     unsigned int Memory_size;
 
-    /// Offset up to which the memory has been initialized.
-    unsigned int Initialized_offset;
-
     /// The content of the memory.
     byte_t *Content;
 
     /// Optional vector of flags indicating whether a byte has been initialized.
     byte_t *Init_vector;
 
+    /// Flags indicating whether a page of the memory has been initialized,
+    /// shared by all memories sharing the content.
+    std::vector<bool> *Initialized_pages;
+
     bool Randomize;
 
     mem_check_e Mem_check;
 
+    /// Flag indicating whether the content is owned by another memory.
+    bool Is_shared;
+
+    /// Flag indicating whether several cores access the content, such that
+    /// their accesses have to be ordered, see simulator_t::order_shared_access.
+    bool Is_shared_by_cores;
+
     /// Ensure that the content is initialize up to the given address.
     /// @param address The address that should be accessed.
     /// @param size The access size.
@@ -187,27 +239,28 @@ namespace patmos
     void check_initialize_content(simulator_t &s, uword_t address, uword_t size,
                                   bool is_read, bool ignore_errors = false);
 
+    /// Initialize a page of the memory content on its first access.
+    /// @param page The index of the page.
+    void initialize_page(uword_t page);
+
   public:
     /// Construct a new memory instance.
     /// @param memory_size The size of the memory in bytes.
     ideal_memory_t(unsigned int memory_size, bool randomize,
-                   mem_check_e memchk)
-    : Memory_size(memory_size), Initialized_offset(0),
-      Randomize(randomize), Mem_check(memchk)
-    {
-      Content = new byte_t[memory_size];
+                   mem_check_e memchk);
 
-      if (memchk != MCK_NONE) {
-        Init_vector = new byte_t[memory_size];
-      } else {
-        Init_vector = NULL;
-      }
-    }
+    ~ideal_memory_t();
 
-    ~ideal_memory_t() {
-      if (Content) delete[] Content;
-      if (Init_vector) delete[] Init_vector;
-    }
+    /// Mark the memory as accessed by several cores, e.g., a scratchpad
+    /// shared by the cores.
+    void share_with_cores() { Is_shared_by_cores = true; }
+
+    /// Access the content of another memory instead of the own content, e.g.,
+    /// to simulate several ports to a shared memory. Both memories are marked
+    /// as accessed by several cores, the other memory has to outlive this
+    /// one.
+    /// @param primary The memory owning the content.
+    void share_content(ideal_memory_t &primary);
 
     /// A simulated access to a read port.
     /// @param address The memory address to read from.
@@ -253,6 +306,15 @@ namespace patmos
       // do nothing here
     }
 
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      // repeated reads of uninitialized data are reported in every cycle
+      if (Mem_check != MCK_NONE)
+        return 0;
+
+      return std::numeric_limits<uint64_t>::max();
+    }
+
     /// Print the internal state of the memory to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) const
@@ -270,6 +332,9 @@ namespace patmos
 
     virtual void reset_stats() {}
 
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   /// Information about an outstanding memory request.
@@ -291,16 +356,118 @@ namespace patmos
     unsigned int Num_ticks_remaining;
   };
 
+  /// A FIFO queue of outstanding memory requests.
+  /// The requests are kept in a ring buffer and are indexed by their address,
+  /// size, and kind, so that retried accesses find their request in constant
+  /// time. The index is a hash table with one bucket per slot of the ring
+  /// buffer, chaining the requests of a bucket in queue order through their
+  /// slots, so that queueing and removing a request does not allocate.
+  class request_queue_t
+  {
+  private:
+    /// Marks the end of a bucket chain or an empty bucket.
+    static const uint64_t NO_REQUEST = ~(uint64_t)0;
+
+    /// Sequence numbers of the oldest and the newest request of a bucket.
+    typedef std::pair<uint64_t, uint64_t> bucket_t;
+
+    /// Storage of the ring buffer, the size is a power of two.
+    std::vector<request_info_t> Buffer;
+
+    /// Sequence number of the next request in the same bucket, per slot of
+    /// the ring buffer.
+    std::vector<uint64_t> Next;
+
+    /// Buckets of the index, as many as there are slots in the ring buffer.
+    std::vector<bucket_t> Buckets;
+
+    /// Sequence number of the oldest request in the queue.
+    uint64_t Head;
+
+    /// Sequence number of the next request to be added to the queue.
+    uint64_t Tail;
+
+    /// Number of posted requests in the queue.
+    unsigned int Num_posted;
+
+    /// Get the bucket of a request in the index.
+    bucket_t &get_bucket(uword_t address, uword_t size, bool is_load)
+    {
+      uint64_t key = ((uint64_t)address << 32) ^ ((uint64_t)size << 1) ^
+                     is_load;
+      return Buckets[((key * 0x9e3779b97f4a7c15ULL) >> 32) &
+                     (Buckets.size() - 1)];
+    }
+
+    /// Get the request with the given sequence number.
+    request_info_t &get(uint64_t seq)
+    {
+      return Buffer[seq & (Buffer.size() - 1)];
+    }
+
+    const request_info_t &get(uint64_t seq) const
+    {
+      return Buffer[seq & (Buffer.size() - 1)];
+    }
+
+    /// Add the request with the given sequence number to its bucket.
+    void index(uint64_t seq);
+
+    /// Resize the ring buffer and rebuild the index of the queued requests.
+    void resize(unsigned int buffer_size);
+
+  public:
+    /// Construct a new request queue.
+    /// @param capacity The expected maximum number of queued requests, the
+    /// queue grows if it is exceeded.
+    request_queue_t(unsigned int capacity);
+
+    /// Check whether the queue is empty.
+    bool empty() const { return Head == Tail; }
+
+    /// Get the number of queued requests.
+    unsigned int size() const { return Tail - Head; }
+
+    /// Get the number of queued posted requests.
+    unsigned int num_posted() const { return Num_posted; }
+
+    /// Get the oldest request in the queue.
+    request_info_t &front() { return get(Head); }
+
+    const request_info_t &front() const { return get(Head); }
+
+    /// Get the i-th oldest request in the queue.
+    const request_info_t &operator[](unsigned int i) const
+    {
+      return get(Head + i);
+    }
+
+    /// Find a queued request.
+    /// @return The request, or NULL if there is no matching request.
+    request_info_t *find(uword_t address, uword_t size, bool is_load);
+
+    /// Append a request to the queue.
+    /// @return The queued request.
+    request_info_t &push_back(const request_info_t &req);
+
+    /// Remove the oldest request from the queue.
+    void pop_front();
+
+    /// Write the queued requests to a checkpoint.
+    void save_state(checkpoint_writer_t &cw) const;
+
+    /// Replace the queued requests by those of a checkpoint.
+    void restore_state(checkpoint_reader_t &cr);
+  };
+
   /// A memory with fixed access times to transfer fixed-sized blocks.
   /// Memory accesses are performed in blocks (NUM_BLOCK_BYTES) with a fixed
   /// access delay (Num_ticks_per_block).
   class fixed_delay_memory_t : public ideal_memory_t
   {
   protected:
-    /// Set of pending requests processed by the memory.
-    typedef std::vector<request_info_t> requests_t;
-
-    typedef std::map<uword_t, uint64_t> request_size_map_t;
+    /// Histogram of request sizes, in buckets of 4 bytes.
+    typedef std::vector<uint64_t> request_size_histogram_t;
 
     /// Memory access time per block in cycles.
     unsigned int Num_ticks_per_burst;
@@ -315,7 +482,7 @@ namespace patmos
     unsigned int Num_read_delay_ticks;
 
     /// Outstanding requests to the memory.
-    requests_t Requests;
+    request_queue_t Requests;
 
   private:
     // -------------  Statistics -------------
@@ -357,7 +524,7 @@ namespace patmos
     uint64_t Num_posted_write_cycles;
 
     /// Track number of requests per request size.
-    request_size_map_t Num_requests_per_size;
+    request_size_histogram_t Num_requests_per_size;
 
   protected:
     virtual uword_t get_aligned_size(uword_t address, uword_t size,
@@ -401,7 +568,8 @@ namespace patmos
         Num_ticks_per_burst(num_ticks_per_burst),
         Num_bytes_per_burst(num_bytes_per_burst),
         Num_posted_writes(num_posted_writes),
-        Num_read_delay_ticks(num_read_delay_ticks), Last_address(0),
+        Num_read_delay_ticks(num_read_delay_ticks),
+        Requests(num_posted_writes + 1), Last_address(0),
         Last_is_load(false), Num_max_queue_size(0),
         Num_reads(0), Num_writes(0), Num_bytes_read(0), Num_bytes_written(0),
         Num_bytes_read_transferred(0), Num_bytes_write_transferred(0),
@@ -434,6 +602,10 @@ namespace patmos
     /// Notify the memory that a cycle has passed.
     virtual void tick(simulator_t &s);
 
+    virtual uint64_t get_idle_cycles(simulator_t &s);
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles);
+
     /// Print the internal state of the memory to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os) const;
@@ -445,6 +617,11 @@ namespace patmos
 
     virtual void reset_stats();
 
+    virtual void add_counters(stats_counters_t &counters);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   class variable_burst_memory_t : public fixed_delay_memory_t
@@ -492,6 +669,9 @@ namespace patmos
 
     virtual void tick_request(request_info_t &req);
 
+    /// Get the TDM round counter value at which a request ends its transfer.
+    uword_t get_round_end(const request_info_t &req) const;
+
   public:
     tdm_memory_t(unsigned int memory_size, unsigned int num_bytes_per_burst,
                  unsigned int num_posted_writes,
@@ -503,6 +683,14 @@ namespace patmos
                  bool randomize, mem_check_e memchk);
 
     virtual void tick(simulator_t &s);
+
+    virtual uint64_t get_idle_cycles(simulator_t &s);
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
 #ifdef RAMULATOR
@@ -558,7 +746,7 @@ namespace patmos
     // Burst size (in bytes).
     unsigned int Num_burst_bytes;
 
-    // Aligned start address of an outstanding request, or 0.
+    // Aligned start address of an outstanding request.
     uword_t Pending_start;
 
     // Number of bursts for outstanding request, or 0.
@@ -650,12 +838,27 @@ namespace patmos
     /// Notify the memory that a cycle has passed.
     virtual void tick(simulator_t &s);
 
+    /// The requests in flight are kept by ramulator, which has to be ticked
+    /// in every cycle.
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      return 0;
+    }
+
     /// Print statistics to an output stream.
     /// @param s The main simulator instance.
     /// @param os The output stream to print to.
     /// @param options Options on statistic format/verbosity/...
     virtual void print_stats(const simulator_t &s, std::ostream &os,
                              const stats_options_t& options);
+
+    virtual void add_counters(stats_counters_t &counters);
+
+    /// Checkpoints are not supported for ramulator memories, the requests
+    /// in flight are kept by ramulator.
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 #endif // RAMULATOR
 }
@@ -95,6 +95,8 @@ namespace patmos
     /// Notify the cache that a cycle passed.
     virtual void tick(simulator_t &s);
 
+    virtual uint64_t get_idle_cycles(simulator_t &s);
+
     /// Print debug information to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os);
@@ -107,7 +109,11 @@ namespace patmos
 
     virtual void reset_stats() {}
 
-    virtual void flush_cache() {}
+    virtual void flush_cache(simulator_t &s) {}
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   /// Cache statistics for a particular method and return offset. Map offsets
@@ -374,6 +380,10 @@ namespace patmos
     /// transfer of a method to the cache, advance this transfer by one cycle.
     virtual void tick(simulator_t &s);
 
+    virtual uint64_t get_idle_cycles(simulator_t &s);
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles);
+
     /// Print debug information to an output stream.
     /// @param os The output stream to print to.
     virtual void print(const simulator_t &s, std::ostream &os);
@@ -386,7 +396,13 @@ namespace patmos
 
     virtual void reset_stats();
 
-    virtual void flush_cache();
+    virtual void add_counters(stats_counters_t &counters);
+
+    virtual void flush_cache(simulator_t &s);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
 
     /// free dynamically allocated cache memory.
     virtual ~lru_method_cache_t();
@@ -441,8 +457,11 @@ namespace patmos
     /// @return True when the instruction word is available from the read port.
     virtual bool fetch(simulator_t &s, uword_t base, uword_t address, word_t iw[2]);
 
-    virtual void flush_cache();
+    virtual void flush_cache(simulator_t &s);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
 
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 }
 
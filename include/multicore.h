@@ -0,0 +1,184 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Simulation of several Patmos cores sharing the global memory.
+//
+
+#ifndef PATMOS_MULTICORE_H
+#define PATMOS_MULTICORE_H
+
+#include "command-line.h"
+#include "exception.h"
+
+#include <condition_variable>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace patmos
+{
+  class simulator_t;
+
+  /// Run the simulators of several cores side by side. The cores are
+  /// synchronized after every cycle or after every quantum of cycles, such
+  /// that no core runs ahead of the others by more than a quantum. The cores
+  /// are distributed round-robin over a number of host threads; with a single
+  /// thread the cores are simulated in the order of their IDs.
+  /// With several threads, a core accessing the shared memories or the UART
+  /// in a slice first waits until all cores with lower IDs have finished the
+  /// slice. The cores thus see the same shared state as with a single thread
+  /// and the simulation stays deterministic; only the parts of the slices
+  /// before the first shared access run in parallel.
+  class multicore_t
+  {
+  private:
+    /// The simulators of the cores, indexed by the core ID.
+    std::vector<simulator_t*> Cores;
+
+    /// The stream for the debug output of a core, NULL to use the stream
+    /// passed to run.
+    std::vector<std::ostream*> Debug_outs;
+
+    /// The exception that stopped a core, NULL while the core is running.
+    std::vector<simulation_exception_t*> Exceptions;
+
+    /// The synchronization mode.
+    sync_e Sync;
+
+    /// The number of cycles between synchronizations in quantum mode.
+    uint64_t Quantum;
+
+    /// The number of host threads simulating the cores.
+    unsigned int Num_threads;
+
+    /// The ID of the core that raised an error.
+    unsigned int Failed_core;
+
+    /// The maximum number of cycles to simulate.
+    uint64_t Max_cycles;
+
+    /// The number of cycles simulated so far.
+    uint64_t Num_cycles;
+
+    /// The number of cycles to simulate until the next synchronization.
+    uint64_t Num_slice_cycles;
+
+    /// Flag indicating that the simulation has stopped.
+    bool Is_done;
+
+    /// Protects the synchronization state below.
+    std::mutex Mutex;
+
+    /// Signals that all threads reached the synchronization point.
+    std::condition_variable Synchronized;
+
+    /// The number of threads waiting at the synchronization point.
+    unsigned int Num_waiting;
+
+    /// Counts the synchronization points passed so far.
+    uint64_t Generation;
+
+    /// Flags indicating which cores finished the current slice.
+    std::vector<bool> Is_finished;
+
+    /// The number of cores with the lowest IDs that all finished the current
+    /// slice, the next core may access shared state.
+    unsigned int Num_finished;
+
+    /// Signals that Num_finished increased.
+    std::condition_variable Finished;
+
+    /// Prepare the ordering of the accesses to shared state for a new slice.
+    void start_slice();
+
+    /// Mark a core as having finished the current slice.
+    /// @param core The ID of the core.
+    void finish_slice(unsigned int core);
+
+    /// Compute the length of the next slice and check whether the simulation
+    /// has stopped.
+    void update_slice();
+
+    /// Wait until all threads finished the current slice.
+    /// @return True when the simulation continues with another slice.
+    bool synchronize();
+
+    /// Simulate the cores assigned to a host thread.
+    /// @param thread The index of the host thread.
+    void simulate(unsigned int thread, word_t entry, uint64_t debug_cycle,
+                  debug_format_e debug_fmt, std::ostream &debug_out,
+                  bool debug_nopc, bool collect_instr_stats);
+
+  public:
+    /// Construct a new multi-core simulation.
+    /// @param sync The synchronization mode.
+    /// @param quantum The number of cycles between synchronizations in
+    /// quantum mode.
+    /// @param num_threads The number of host threads, at most one per core is
+    /// used.
+    multicore_t(sync_e sync, uint64_t quantum, unsigned int num_threads);
+
+    ~multicore_t();
+
+    /// Add the simulator of the next core.
+    /// @param s The simulator, the core ID is the order of the calls.
+    /// @param debug_out The stream for the debug output of the core, NULL to
+    /// use the stream passed to run. Cores simulated by different threads
+    /// need streams of their own.
+    void add_core(simulator_t &s, std::ostream *debug_out = NULL);
+
+    /// Run the simulation until core 0 halts. Other cores that halt earlier
+    /// remain halted, other cores that are still running are stopped when
+    /// core 0 halts.
+    /// The HALT exception of core 0 is passed on, as well as the first error
+    /// of any core, see get_failed_core.
+    /// @see simulator_t::run for a description of the parameters.
+    void run(word_t entry = 0,
+             uint64_t debug_cycle = std::numeric_limits<uint64_t>::max(),
+             debug_format_e debug_fmt = DF_DEFAULT,
+             std::ostream &debug_out = std::cerr, bool debug_nopc = false,
+             uint64_t max_cycles = std::numeric_limits<uint64_t>::max(),
+             bool collect_instr_stats = false);
+
+    /// Return the ID of the core that raised the exception passed on by run.
+    unsigned int get_failed_core() const { return Failed_core; }
+
+    /// Wait until all cores with lower IDs finished the current slice, such
+    /// that the core may access shared state in the rest of the slice.
+    /// @param core The ID of the core.
+    void wait_for_turn(unsigned int core);
+  };
+}
+
+#endif // PATMOS_MULTICORE_H
@@ -136,6 +136,16 @@ namespace patmos
         simulation_exception_t::unmapped(address);
       return true;
     }
+
+    virtual void save_state(checkpoint_writer_t &cw) const
+    {
+      SPM.save_state(cw);
+    }
+
+    virtual void restore_state(checkpoint_reader_t &cr)
+    {
+      SPM.restore_state(cr);
+    }
   };
 }
 
@@ -46,6 +46,7 @@
 namespace patmos
 {
   struct stats_options_t;
+  class stats_counters_t;
 
   /// Profiling information for functions.
   class profiling_t
@@ -108,6 +109,10 @@ namespace patmos
       std::ostream &print(std::ostream &os, symbol_map_t &sym,
                           const stats_options_t& options) const;
 
+      /// add_stats - Add the profile of each function to a set of counters,
+      /// named by the function's symbol or address.
+      void add_stats(stats_counters_t &counters, symbol_map_t &sym) const;
+
       void reset_stats(uint64_t cycle);
   };
 
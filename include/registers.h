@@ -196,6 +196,12 @@ namespace patmos
     {
       Active = false;
     }
+
+    /// Check whether the by-pass is active.
+    bool is_active() const
+    {
+      return Active;
+    }
   };
 
   /// Symbols representing the general purpose registers.
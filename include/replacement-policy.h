@@ -0,0 +1,317 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Replacement policies of set-associative caches.
+//
+
+#ifndef PATMOS_REPLACEMENT_POLICY_H
+#define PATMOS_REPLACEMENT_POLICY_H
+
+#include "basic-types.h"
+
+#include <vector>
+
+namespace patmos
+{
+  class checkpoint_writer_t;
+  class checkpoint_reader_t;
+
+  // A replacement policy keeps the replacement state of all sets of a cache
+  // and provides:
+  //  - name(): the name of the policy for statistics,
+  //  - access(set, way): notify a hit on a way,
+  //  - insert(set, way): notify that a block was loaded into a way,
+  //  - victim(set): select the way to evict once all ways of the set are
+  //    valid, must not change the state as the cache may ask repeatedly
+  //    while waiting for the memory,
+  //  - order(set, ways): sort valid ways for printing, most recent first,
+  //  - invalidate(): reset the state when the cache is flushed,
+  //  - save_state/restore_state: checkpointing.
+  // The policies are template parameters of the caches, i.e., they are not
+  // dispatched dynamically.
+
+  /// Least-recently used replacement, the time of the last access of each
+  /// way is recorded.
+  class lru_replacement_t
+  {
+  private:
+    /// The number of ways per set.
+    unsigned int Associativity;
+
+    /// The time of the last access of all ways.
+    std::vector<uint64_t> Stamps;
+
+    /// Time counter for the stamps.
+    uint64_t Clock;
+
+  public:
+    lru_replacement_t(unsigned int num_sets, unsigned int associativity,
+                      uword_t seed);
+
+    static const char *name() { return "lru"; }
+
+    void access(unsigned int set, unsigned int way)
+    {
+      Stamps[set * Associativity + way] = ++Clock;
+    }
+
+    void insert(unsigned int set, unsigned int way)
+    {
+      access(set, way);
+    }
+
+    unsigned int victim(unsigned int set) const;
+
+    void order(unsigned int set, std::vector<unsigned int> &ways) const;
+
+    void invalidate();
+
+    void save_state(checkpoint_writer_t &cw) const;
+
+    void restore_state(checkpoint_reader_t &cr);
+  };
+
+  /// First-in first-out replacement, a round-robin pointer per set selects
+  /// the next way to evict.
+  class fifo_replacement_t
+  {
+  private:
+    /// The number of ways per set.
+    unsigned int Associativity;
+
+    /// The next way to evict per set.
+    std::vector<unsigned int> Next;
+
+  public:
+    fifo_replacement_t(unsigned int num_sets, unsigned int associativity,
+                       uword_t seed);
+
+    static const char *name() { return "fifo"; }
+
+    void access(unsigned int set, unsigned int way)
+    {
+    }
+
+    void insert(unsigned int set, unsigned int way)
+    {
+      Next[set] = way + 1 == Associativity ? 0 : way + 1;
+    }
+
+    unsigned int victim(unsigned int set) const
+    {
+      return Next[set];
+    }
+
+    void order(unsigned int set, std::vector<unsigned int> &ways) const;
+
+    void invalidate();
+
+    void save_state(checkpoint_writer_t &cw) const;
+
+    void restore_state(checkpoint_reader_t &cr);
+  };
+
+  /// Tree-based pseudo-LRU replacement. The nodes of a binary tree over the
+  /// ways of a set point away from the most recently accessed half.
+  class tree_plru_replacement_t
+  {
+  private:
+    /// The number of ways per set.
+    unsigned int Associativity;
+
+    /// Number of leaves of the tree, i.e., the associativity rounded up to a
+    /// power of two.
+    unsigned int Num_leaves;
+
+    /// The nodes of the trees of all sets, a set node points to the right
+    /// subtree.
+    std::vector<byte_t> Nodes;
+
+  public:
+    tree_plru_replacement_t(unsigned int num_sets, unsigned int associativity,
+                            uword_t seed);
+
+    static const char *name() { return "plru"; }
+
+    void access(unsigned int set, unsigned int way);
+
+    void insert(unsigned int set, unsigned int way)
+    {
+      access(set, way);
+    }
+
+    unsigned int victim(unsigned int set) const;
+
+    void order(unsigned int set, std::vector<unsigned int> &ways) const {}
+
+    void invalidate();
+
+    void save_state(checkpoint_writer_t &cw) const;
+
+    void restore_state(checkpoint_reader_t &cr);
+  };
+
+  /// Bit-based pseudo-LRU replacement, also known as MRU bits. Accessing a
+  /// way sets its bit, once all bits are set the others are cleared. The
+  /// first way with a cleared bit is evicted.
+  class bit_plru_replacement_t
+  {
+  private:
+    /// The number of ways per set.
+    unsigned int Associativity;
+
+    /// Number of words of MRU bits per set.
+    unsigned int Num_words;
+
+    /// The MRU bits of all sets.
+    std::vector<uint64_t> Bits;
+
+  public:
+    bit_plru_replacement_t(unsigned int num_sets, unsigned int associativity,
+                           uword_t seed);
+
+    static const char *name() { return "bplru"; }
+
+    void access(unsigned int set, unsigned int way);
+
+    void insert(unsigned int set, unsigned int way)
+    {
+      access(set, way);
+    }
+
+    unsigned int victim(unsigned int set) const;
+
+    void order(unsigned int set, std::vector<unsigned int> &ways) const {}
+
+    void invalidate();
+
+    void save_state(checkpoint_writer_t &cw) const;
+
+    void restore_state(checkpoint_reader_t &cr);
+  };
+
+  /// Pseudo-random replacement using a seeded xorshift generator, which
+  /// advances on each insertion.
+  class random_replacement_t
+  {
+  private:
+    /// The number of ways per set.
+    unsigned int Associativity;
+
+    /// State of the random number generator.
+    uint32_t State;
+
+  public:
+    random_replacement_t(unsigned int num_sets, unsigned int associativity,
+                         uword_t seed);
+
+    static const char *name() { return "random"; }
+
+    void access(unsigned int set, unsigned int way)
+    {
+    }
+
+    void insert(unsigned int set, unsigned int way)
+    {
+      State ^= State << 13;
+      State ^= State >> 17;
+      State ^= State << 5;
+    }
+
+    unsigned int victim(unsigned int set) const
+    {
+      return ((uint64_t)State * Associativity) >> 32;
+    }
+
+    void order(unsigned int set, std::vector<unsigned int> &ways) const {}
+
+    void invalidate();
+
+    void save_state(checkpoint_writer_t &cw) const;
+
+    void restore_state(checkpoint_reader_t &cr);
+  };
+
+  /// Re-reference interval prediction (RRIP) with 2-bit prediction values.
+  /// Hits predict a near re-reference, the first way with a distant
+  /// prediction is evicted, aging all ways as needed. Static RRIP (SRRIP)
+  /// inserts blocks with a long prediction, bimodal RRIP (BRRIP) mostly with
+  /// a distant one.
+  template<bool BIMODAL>
+  class rrip_replacement_t
+  {
+  private:
+    /// The prediction value of a distant re-reference.
+    static const byte_t DISTANT = 3;
+
+    /// One out of this many insertions of BRRIP predicts a long interval.
+    static const uint32_t BIMODAL_THROTTLE = 32;
+
+    /// The number of ways per set.
+    unsigned int Associativity;
+
+    /// The re-reference prediction values of all ways.
+    std::vector<byte_t> Values;
+
+    /// State of the random number generator of BRRIP.
+    uint32_t State;
+
+  public:
+    rrip_replacement_t(unsigned int num_sets, unsigned int associativity,
+                       uword_t seed);
+
+    static const char *name() { return BIMODAL ? "brrip" : "srrip"; }
+
+    void access(unsigned int set, unsigned int way)
+    {
+      Values[set * Associativity + way] = 0;
+    }
+
+    void insert(unsigned int set, unsigned int way);
+
+    unsigned int victim(unsigned int set) const;
+
+    void order(unsigned int set, std::vector<unsigned int> &ways) const {}
+
+    void invalidate();
+
+    void save_state(checkpoint_writer_t &cw) const;
+
+    void restore_state(checkpoint_reader_t &cr);
+  };
+
+  typedef rrip_replacement_t<false> srrip_replacement_t;
+  typedef rrip_replacement_t<true> brrip_replacement_t;
+}
+
+#endif // PATMOS_REPLACEMENT_POLICY_H
@@ -37,10 +37,12 @@
 #ifndef PATMOS_RTC_H
 #define PATMOS_RTC_H
 
+#include <algorithm>
 #include <istream>
 #include <ostream>
 #include <cstdio>
 
+#include "checkpoint.h"
 #include "memory-map.h"
 #include "endian-conversion.h"
 #include "excunit.h"
@@ -63,7 +65,8 @@ namespace patmos
     /// Latched high word of usec counter
     uword_t High_usec;
 
-    /// Remember the last usec value to trigger only when it changed
+    /// Remember the last usec value to trigger only when it changed, only
+    /// tracked while the usec interrupt is set.
     uint64_t Last_usec;
 
     /// Latched low word of interrupt register value
@@ -103,8 +106,12 @@ namespace patmos
     }
 
     uint64_t getUSec() {
+      return getUSec(Simulator.Cycle);
+    }
+
+    uint64_t getUSec(uint64_t cycle) {
       // TODO if Frequency == 0, use wall clock for usec
-      return (uint64_t)((double)Simulator.Cycle / Frequency);
+      return (uint64_t)((double)cycle / Frequency);
     }
 
     virtual bool read(simulator_t &s, uword_t address, byte_t *value, uword_t size) {
@@ -141,6 +148,7 @@ namespace patmos
         // set the clock interrupt timer
         uword_t high_clock = get_word(value, size);
         Interrupt_clock = ((uint64_t)high_clock)<<32 | Low_interrupt_clock;
+        update_ticked();
 
         if (Enable_debug) {
           std::cerr << "*** RTC: Set next cycle interrupt to " << Interrupt_clock
@@ -156,6 +164,11 @@ namespace patmos
         uword_t high_usec = get_word(value, size);
         Interrupt_usec = ((uint64_t)high_usec)<<32 | Low_interrupt_usec;
 
+        // the usec value of the last tick, which happened in the last cycle
+        uint64_t cycle = getCycle();
+        Last_usec = cycle ? getUSec(cycle - 1) : 0;
+        update_ticked();
+
         if (Enable_debug) {
           std::cerr << "*** RTC: Set next usec interrupt to " << Interrupt_usec
                     << ", current usec: " << getUSec() << ", cycle: " << getCycle() << "\n";
@@ -171,15 +184,83 @@ namespace patmos
       return true;
     }
 
+    /// Tick the RTC only while an interrupt is still to be raised, the
+    /// armed state changes only in write, tick and restore_state.
+    virtual bool is_ticked() const {
+      const uint64_t max = std::numeric_limits<uint64_t>::max();
+      return (Interrupt_clock != max && Interrupt_clock >= Simulator.Cycle) ||
+             (Interrupt_usec != max && Interrupt_usec > Last_usec);
+    }
+
     virtual void tick(simulator_t &s) {
       if (Interrupt_clock == getCycle()) {
         Simulator.Exception_handler.fire_exception(ET_INTR_CLOCK);
+        update_ticked();
       }
-      uint64_t usec = getUSec();
-      if (Interrupt_usec == usec && usec != Last_usec) {
-        Simulator.Exception_handler.fire_exception(ET_INTR_USEC);
+      if (Interrupt_usec != std::numeric_limits<uint64_t>::max()) {
+        uint64_t usec = getUSec();
+        if (Interrupt_usec == usec && usec != Last_usec) {
+          Simulator.Exception_handler.fire_exception(ET_INTR_USEC);
+          update_ticked();
+        }
+        Last_usec = usec;
+      }
+    }
+
+    virtual uint64_t get_idle_cycles(simulator_t &s) {
+      uint64_t cycle = getCycle();
+      uint64_t cycles = std::numeric_limits<uint64_t>::max();
+
+      // the cycle raising the clock interrupt must not be skipped
+      if (Interrupt_clock > cycle) {
+        cycles = Interrupt_clock - cycle - 1;
       }
-      Last_usec = usec;
+
+      // neither must the cycle in which the usec counter reaches the
+      // interrupt value
+      if (Interrupt_usec > getUSec(cycle)) {
+        double first = (double)Interrupt_usec * Frequency;
+        if (!(Frequency > 0)) {
+          return 0;
+        }
+        else if (first < (double)(cycles - 1) + (double)cycle) {
+          uint64_t next = std::max((uint64_t)first, cycle + 1);
+          while (next > cycle + 1 && getUSec(next - 1) >= Interrupt_usec) {
+            next--;
+          }
+          while (getUSec(next) < Interrupt_usec) {
+            next++;
+          }
+          cycles = std::min(cycles, next - cycle - 1);
+        }
+      }
+
+      return cycles;
+    }
+
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles) {
+      Last_usec = getUSec(getCycle() + cycles);
+    }
+
+    virtual void save_state(checkpoint_writer_t &cw) const {
+      cw.write(High_clock);
+      cw.write(High_usec);
+      cw.write(Last_usec);
+      cw.write(Low_interrupt_clock);
+      cw.write(Low_interrupt_usec);
+      cw.write(Interrupt_clock);
+      cw.write(Interrupt_usec);
+    }
+
+    virtual void restore_state(checkpoint_reader_t &cr) {
+      cr.read(High_clock);
+      cr.read(High_usec);
+      cr.read(Last_usec);
+      cr.read(Low_interrupt_clock);
+      cr.read(Low_interrupt_usec);
+      cr.read(Interrupt_clock);
+      cr.read(Interrupt_usec);
+      update_ticked();
     }
   };
 }
@@ -0,0 +1,172 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+
+//
+// Measuring the host time spent in the components of the simulator itself.
+//
+
+#ifndef PATMOS_SELF_PROFILE_H
+#define PATMOS_SELF_PROFILE_H
+
+#include "basic-types.h"
+
+#include <chrono>
+#include <ostream>
+
+namespace patmos
+{
+  /// Components of the simulator whose host time is measured separately.
+  enum self_profile_component_e
+  {
+    /// Instruction fetch stage, excluding the instruction cache.
+    SP_DECODE,
+    /// Fetching from and ticking the instruction cache.
+    SP_ICACHE,
+    /// Memory/write-back stage, including the data and stack cache accesses.
+    SP_MW,
+    /// Execute stage.
+    SP_EX,
+    /// Decode/register-read stage.
+    SP_DR,
+    /// Hazard checks, advancing the pipeline, and updating the PC.
+    SP_PIPELINE,
+    /// Ticking the local memory and the devices.
+    SP_LOCAL_MEMORY,
+    /// Ticking the main memory, e.g., Ramulator.
+    SP_MEMORY,
+    /// Ticking the data cache.
+    SP_DCACHE,
+    /// Ticking the stack cache.
+    SP_SCACHE,
+    /// Printing the debug output.
+    SP_PRINT,
+    /// Instruction statistics and sampling of the counters.
+    SP_STATS,
+    /// Finding and skipping idle cycles.
+    SP_SKIP,
+
+    /// Number of components -- used to instantiate arrays etc.
+    SP_NUM_COMPONENTS
+  };
+
+  /// Host-side profile of the simulator, measuring the time spent in each of
+  /// its components. In order to keep the overhead low, only every n-th
+  /// iteration of the simulation loop is measured, the time of the other
+  /// iterations is extrapolated from these samples.
+  class self_profile_t
+  {
+  private:
+    /// The clock used to measure the host time.
+    typedef std::chrono::steady_clock host_clock_t;
+
+    /// Number of iterations of the simulation loop per measured iteration.
+    unsigned int Interval;
+
+    /// Number of iterations until the next measured iteration.
+    unsigned int Countdown;
+
+    /// Number of iterations of the simulation loop.
+    uint64_t Num_iterations;
+
+    /// Number of measured iterations.
+    uint64_t Num_sampled;
+
+    /// Time of the last measurement within the current iteration.
+    host_clock_t::time_point Last;
+
+    /// Nanoseconds measured per component.
+    uint64_t Ns[SP_NUM_COMPONENTS];
+
+    /// Start of the simulation.
+    host_clock_t::time_point Start_time;
+
+    /// Host time of the simulation in nanoseconds.
+    uint64_t Wall_ns;
+
+    /// Cycle and number of retired operations at the start of the simulation.
+    uint64_t Start_cycle;
+    uint64_t Start_retired;
+
+    /// Number of simulated cycles and retired operations.
+    uint64_t Num_cycles;
+    uint64_t Num_retired;
+
+  public:
+    /// Construct a profile.
+    /// @param interval Number of iterations of the simulation loop per
+    /// measured iteration.
+    self_profile_t(unsigned int interval);
+
+    /// Start an iteration of the simulation loop.
+    /// @return True if the iteration is measured, the simulator then has to
+    /// call mark after each of its components.
+    bool begin_iteration()
+    {
+      Num_iterations++;
+      if (--Countdown)
+        return false;
+
+      Countdown = Interval;
+      Num_sampled++;
+      Last = host_clock_t::now();
+      return true;
+    }
+
+    /// Account the time since the last measurement to a component.
+    /// @param c The component that executed since the last measurement.
+    void mark(self_profile_component_e c)
+    {
+      host_clock_t::time_point now = host_clock_t::now();
+      Ns[c] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                     now - Last).count();
+      Last = now;
+    }
+
+    /// Start measuring the total host time of the simulation.
+    /// @param cycle The current cycle of the simulator.
+    /// @param retired The current number of retired operations.
+    void start(uint64_t cycle, uint64_t retired);
+
+    /// Stop measuring the total host time of the simulation.
+    /// @param cycle The current cycle of the simulator.
+    /// @param retired The current number of retired operations.
+    void stop(uint64_t cycle, uint64_t retired);
+
+    /// Print the host time per simulated cycle of each component and the
+    /// simulation speed.
+    /// @param os The output stream to print to.
+    void print(std::ostream &os) const;
+  };
+}
+
+#endif // PATMOS_SELF_PROFILE_H
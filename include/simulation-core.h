@@ -43,10 +43,13 @@
 #include "instruction.h"
 #include "exception.h"
 #include "profiling.h"
+#include "self-profile.h"
+#include "trace.h"
+#include "watch.h"
 
-#include <set>
 #include <limits>
 #include <iostream>
+#include <vector>
 
 namespace patmos
 {
@@ -59,6 +62,14 @@ namespace patmos
   class binary_format_t;
   class rtc_t;
   class excunit_t;
+  class checkpoint_writer_t;
+  class checkpoint_reader_t;
+  class stats_counters_t;
+  class stats_sampler_t;
+  class debug_sink_t;
+  class multicore_t;
+  class block_cache_t;
+  class translated_bundle_t;
 
   /// Define the maximum number of slots in a bundle.
   static const unsigned int NUM_SLOTS = 2;
@@ -150,6 +161,13 @@ namespace patmos
     /// A vector containing instruction statistics.
     typedef std::vector<instruction_stat_t> instruction_stats_t;
 
+    /// Get the identifier of an instruction in the pipeline for a checkpoint.
+    int get_checkpoint_id(const instruction_t *I) const;
+
+    /// Get the instruction of an identifier read from a checkpoint.
+    const instruction_t *get_checkpoint_instruction(checkpoint_reader_t &cr,
+                                                    int id) const;
+
   public:
     // The processor's execution frequency.
     unsigned int Freq;
@@ -220,8 +238,19 @@ namespace patmos
     /// Halt pseudo instruction.
     instruction_t *Instr_HALT;
 
-    /// Active instructions in the pipeline stage.
-    instruction_data_t Pipeline[NUM_STAGES][NUM_SLOTS];
+    /// Storage of the instructions in the pipeline, only accessed through
+    /// Pipeline.
+    instruction_data_t Pipeline_bundles[NUM_STAGES][NUM_SLOTS];
+
+    /// Active instructions in the pipeline stage, pointing into
+    /// Pipeline_bundles. Advancing the pipeline rotates the pointers instead of
+    /// copying the instructions.
+    instruction_data_t *Pipeline[NUM_STAGES];
+
+    /// The translated bundles of the active instructions in the pipeline
+    /// stages, NULL for bundles that were not fetched from a basic block.
+    /// Rotated along with Pipeline.
+    const translated_bundle_t *Pipeline_translated[NUM_STAGES];
 
     /// Keep track of delays for interrupt triggering
     unsigned int Delay_counter;
@@ -235,21 +264,73 @@ namespace patmos
     /// Flush caches when PC reaches this address.
     uword_t Flush_Cache_PC;
 
+    /// Stop the simulation when PC reaches this address.
+    uword_t Stop_PC;
+
+    /// Flag indicating that the memories complete all accesses immediately,
+    /// set during a functional warm-up.
+    bool Is_functional;
+
+    /// The multi-core simulation ordering the accesses of this core to state
+    /// shared with other cores, NULL unless the cores are simulated by
+    /// several host threads.
+    multicore_t *Multicore;
+
+    /// The ID of the core in the multi-core simulation.
+    unsigned int Core_id;
+
+    /// Flag indicating that the core may access shared state until the end of
+    /// the current slice of the multi-core simulation.
+    bool Is_shared_access_granted;
+
     /// Cycle of the last reset_stats() call.
     uint64_t Stats_Start_Cycle;
 
-    /// Debug accesses to those addresses.
-    std::set<uword_t> Debug_mem_address;
+    /// Sampler writing the statistics in intervals of cycles, or NULL.
+    stats_sampler_t *Stats_sampler;
 
-    /// Watchpoints for trace analysis.
-    std::set<uword_t> Watchpoints;
+    /// Cycle at the end of the current sampling interval.
+    uint64_t Stats_sample_cycle;
+
+    /// Profile of the host time spent in the simulator's components, or NULL.
+    self_profile_t *Self_profile;
+
+    /// Flag indicating whether the current iteration of the simulation loop
+    /// is measured by the self profile.
+    bool Is_self_profiled;
+
+    /// Flag indicating whether the memory and the caches are those of the
+    /// default configuration, i.e., the simulation loop is instantiated for
+    /// default_core_t.
+    bool Is_default_core;
+
+    /// The execution engine.
+    engine_e Engine;
+
+    /// The basic blocks translated by the bb engine, NULL unless used.
+    block_cache_t *Blocks;
+
+    /// Watched addresses, executed addresses filter the trace for trace
+    /// analysis, reads and writes are printed.
+    watch_set_t Watchpoints;
 
     /// Instruction counter for trace analysis
     uint64_t Traced_instructions;
 
+    /// Writer of the binary trace, created on the first traced bundle.
+    trace_writer_t *Trace_writer;
+
+    /// The debug sink formatting the trace records in the background, if any.
+    debug_sink_t *Debug_sink;
+
     /// Runtime statistics on all instructions, per pipeline
     instruction_stats_t Instruction_stats[NUM_SLOTS];
 
+    /// Instances of the instructions collecting the detailed statistics of
+    /// this simulator, indexed by the instruction ID. The instructions of the
+    /// decoder are shared by all simulators.
+    std::vector<instruction_t*> Stats_instructions;
+
     /// Count number of pipeline bubbles retired.
     uint64_t Num_bubbles_retired[NUM_SLOTS];
 
@@ -259,6 +340,9 @@ namespace patmos
     /// Number of NOPs executed
     uint64_t Num_NOPs;
 
+    /// Number of operations retired, i.e., leaving the pipeline enabled.
+    uint64_t Num_retired;
+
     /// Profiling information for function profiling
     profiling_t Profiling;
 
@@ -272,8 +356,10 @@ namespace patmos
     /// @param os An output stream.
     /// @param debug_fmt The selected output format.
     /// @param nopc skip printing cycles and PC
+    /// @param sink The debug sink wrapped by the output stream, if any, which
+    /// formats the register values in its writer thread.
     void print_registers(std::ostream &os, debug_format_e debug_fmt,
-                         bool nopc = false) const;
+                         bool nopc = false, debug_sink_t *sink = NULL) const;
 
     /// Perform a step of the simulation for a given pipeline.
     /// @param pst The pipeline stage.
@@ -285,6 +371,29 @@ namespace patmos
                          bool debug = false,
                          std::ostream &debug_out = std::cerr);
 
+    /// Check whether the instructions of a bundle may not be enabled
+    /// simultaneously in both slots.
+    /// @param bundle The instructions of the bundle.
+    /// @return The name of the conflicting operations, NULL if the
+    /// instructions do not conflict.
+    const char *get_dual_issue_conflict(const instruction_data_t *bundle) const;
+
+    /// Check that a pipeline stage may simulate its bundle: both slots must
+    /// not be enabled in the DR stage if they conflict, and no invalid
+    /// instruction may reach the EX stage.
+    /// @param pst The pipeline stage.
+    /// @param tb The translation of the bundle, whose conflict was computed
+    /// beforehand, or NULL.
+    void check_stage(Pipeline_t pst, const translated_bundle_t *tb) const;
+
+    /// Check that no instruction in the EX stage uses the result of the load
+    /// in the MW stage.
+    void check_load_hazard() const;
+
+    /// Drop all translated basic blocks, the bundles in the pipeline are then
+    /// executed as if they were not translated.
+    void flush_blocks();
+
     /// Flush the pipeline up to *not* including the given pipeline stage.
     /// @param pst The pipeline stage up to which instructions should be
     /// flushed.
@@ -309,9 +418,52 @@ namespace patmos
     /// Track retiring instructions for stats.
     void track_retiring_instructions();
 
+    /// Account the host time since the last measurement to a component of
+    /// the simulator, if the current iteration is measured.
+    /// @param c The component that executed since the last measurement.
+    void profile(self_profile_component_e c)
+    {
+      if (Is_self_profiled)
+        Self_profile->mark(c);
+    }
+
+    /// Get the number of upcoming cycles in which the pipeline only repeats
+    /// the current cycle while waiting for the memory.
+    /// @param COMPONENTS The types of the memory and the caches.
+    /// @return The number of cycles that can be skipped, zero if unknown.
+    template<typename COMPONENTS>
+    uint64_t get_idle_cycles();
+
+    /// Skip a number of idle cycles, updating the caches, memories, and
+    /// statistics as if the cycles were simulated.
+    /// @param COMPONENTS The types of the memory and the caches.
+    /// @param cycles The number of cycles to skip.
+    template<typename COMPONENTS>
+    void skip_idle_cycles(uint64_t cycles);
+
+    /// Move the instructions to the next pipeline stages at the end of a
+    /// cycle, inserting bubbles after the stalling stage.
+    void advance_pipeline();
+
     /// Simulate the instruction fetch stage.
+    /// @param COMPONENTS The types of the memory and the caches.
+    template<typename COMPONENTS>
     void instruction_fetch();
 
+    /// Advance the time of the memories and the caches by one cycle.
+    /// @param COMPONENTS The types of the memory and the caches.
+    template<typename COMPONENTS>
+    void tick_components();
+
+    /// The main simulation loop, instantiated for the types of the memory and
+    /// the caches.
+    /// @param COMPONENTS The types of the memory and the caches.
+    /// @see step for a description of the parameters.
+    template<typename COMPONENTS>
+    void step_core(uint64_t debug_cycle, debug_format_e debug_fmt,
+                   std::ostream &debug_out, bool debug_nopc,
+                   uint64_t max_cycles, bool collect_instr_stats);
+
   public:
     /// Construct a new instance of a Patmos-core simulator
     /// The simulator only retains the references of the arguments passed in the
@@ -336,11 +488,58 @@ namespace patmos
     /// Flush all data caches when reaching the given program counter.
     void flush_caches_at(uword_t address) { Flush_Cache_PC = address; }
 
-    /// Read a file containing watchpoints for the trace analysis.
+    /// Stop the simulation at the end of the cycle in which the program
+    /// counter reaches the given address.
+    void stop_at(uword_t address) { Stop_PC = address; }
+
+    /// Read a file containing watchpoints for the trace analysis and for
+    /// printing memory accesses, see watch_set_t::read.
     void read_watchpoint_file(std::string wpfilename);
 
     /// Print accesses to a
-    void debug_mem_address(uword_t address) { Debug_mem_address.insert(address); }
+    void debug_mem_address(uword_t address)
+    {
+      Watchpoints.add(address, address, WK_READ | WK_WRITE);
+    }
+
+    /// Add the counters of the simulator and of its caches and memories to a
+    /// set of counters, prefixed with the given prefix and the component.
+    /// @param counters The set of counters.
+    /// @param prefix The prefix of all counters, e.g., to name the core.
+    void add_counters(stats_counters_t &counters,
+                      const std::string &prefix = "") const;
+
+    /// Add all statistics of the simulator to a set of counters, i.e., its
+    /// counters and, depending on the options, the statistics per instruction
+    /// and the profile of the functions.
+    /// @param counters The set of counters.
+    /// @param options The options selecting the statistics.
+    /// @param prefix The prefix of all counters, e.g., to name the core.
+    void add_stats(stats_counters_t &counters,
+                   const stats_options_t &options,
+                   const std::string &prefix = "") const;
+
+    /// Write samples of statistics at the end of each interval of the
+    /// sampler, starting with the current cycle, and at the end of the
+    /// simulation.
+    /// @param sampler The sampler, which has to outlive the simulation.
+    void sample_stats(stats_sampler_t &sampler);
+
+    /// Measure the host time spent in the components of the simulator during
+    /// subsequent calls to run and step.
+    /// @param profile The profile, which has to outlive the simulation.
+    void self_profile(self_profile_t &profile) { Self_profile = &profile; }
+
+    /// Select the execution engine of subsequent calls to run, step and
+    /// warm_up.
+    /// @param engine The execution engine.
+    void set_engine(engine_e engine) { Engine = engine; }
+
+    /// Pass the trace records to a debug sink instead of formatting them in
+    /// the simulation loop.
+    /// @param sink The debug sink wrapped by the debug output stream, which
+    /// has to outlive the simulation.
+    void trace_to(debug_sink_t &sink) { Debug_sink = &sink; }
 
     /// Run the simulator.
     /// @param entry Initialize the method cache, PC, etc. to start execution
@@ -359,6 +558,33 @@ namespace patmos
              uint64_t max_cycles = std::numeric_limits<uint64_t>::max(),
              bool collect_instr_stats = false);
 
+    /// Simulate at most the given number of cycles. Unlike run, the
+    /// profiling information is not finalized when the simulation stops, so
+    /// that the simulation can be continued by another call.
+    /// @see run for a description of the parameters.
+    void step(word_t entry, uint64_t debug_cycle, debug_format_e debug_fmt,
+              std::ostream &debug_out, bool debug_nopc, uint64_t max_cycles,
+              bool collect_instr_stats);
+
+    /// Execute the program functionally, i.e., without simulating the timing
+    /// of the memories, to warm up the caches before a detailed simulation
+    /// using run or step. The instructions still pass through the pipeline
+    /// stages, which define delay slots and forwarding, but the memories do
+    /// not stall. The statistics are not meaningful afterwards and should be
+    /// reset.
+    /// @param entry Initialize the method cache, PC, etc. to start execution
+    /// from this entry address.
+    /// @param address Stop the warm-up when the program counter reaches this
+    /// address.
+    /// @param max_instructions Stop the warm-up after this number of
+    /// retired instructions, not counting those whose predicate is false.
+    /// @param max_cycles The maximum number of cycles to run the warm-up.
+    void warm_up(word_t entry, uword_t address, uint64_t max_instructions,
+                 uint64_t max_cycles = std::numeric_limits<uint64_t>::max());
+
+    /// Finalize the profiling information after the last call to step.
+    void finalize();
+
     /// Print the instructions and their operands in a pipeline stage
     /// @param os An output stream.
     /// @param debug_fmt The stage to print.
@@ -377,7 +603,7 @@ namespace patmos
     void print_stats(std::ostream &os) const;
 
     /// Print runtime statistics of the current simulation run to an output
-    /// stream.
+    /// stream, in the format given by the options.
     /// @param os An output stream.
     void print_stats(std::ostream &os, const stats_options_t& options) const;
 
@@ -386,6 +612,30 @@ namespace patmos
 
     /// Flush all caches.
     void flush_caches();
+
+    /// Wait until the core may access state shared with other cores in the
+    /// current slice of a multi-core simulation, see
+    /// multicore_t::wait_for_turn.
+    void order_shared_access()
+    {
+      if (Multicore && !Is_shared_access_granted)
+        wait_for_shared_access();
+    }
+
+    /// Wait for the turn of the core to access shared state, see
+    /// order_shared_access.
+    void wait_for_shared_access();
+
+    /// Write the state of the simulator, its memories, caches, and devices to
+    /// a checkpoint. Statistics are not part of the checkpoint.
+    /// @param cw The checkpoint to write to.
+    void save_state(checkpoint_writer_t &cw) const;
+
+    /// Restore the state of the simulator from a checkpoint written by a
+    /// simulator with the same memories and caches. The program has to be
+    /// loaded before, the statistics start at the restored cycle.
+    /// @param cr The checkpoint to read from.
+    void restore_state(checkpoint_reader_t &cr);
   };
 
 
@@ -204,6 +204,12 @@ namespace patmos
 
     virtual void tick(simulator_t &s) {}
 
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      // spills and fills are timed by the memory
+      return std::numeric_limits<uint64_t>::max();
+    }
+
 
     /// Print the internal state of the stack cache to an output stream.
     /// @param os The output stream to print to.
@@ -214,6 +220,10 @@ namespace patmos
 
     virtual void reset_stats() {}
 
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
+
     virtual uword_t size() const;
 
   };
@@ -255,6 +265,9 @@ namespace patmos
 
     virtual void read_peek(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch);
 
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   /// A stack cache organized in blocks.
@@ -374,6 +387,7 @@ namespace patmos
 
     virtual bool write(simulator_t &s, uword_t address, byte_t *value, uword_t size);
 
+    virtual void skip_cycles(simulator_t &s, uint64_t cycles);
 
     virtual void print(const simulator_t &s, std::ostream &os) const;
 
@@ -381,6 +395,12 @@ namespace patmos
                              const stats_options_t& options);
 
     virtual void reset_stats();
+
+    virtual void add_counters(stats_counters_t &counters);
+
+    virtual void save_state(checkpoint_writer_t &cw) const;
+
+    virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   /// A stack cache generating only aligned memory transfers, given a
@@ -455,6 +475,12 @@ namespace patmos
                                const stats_options_t& options);
 
       void reset_stats();
+
+      virtual void add_counters(stats_counters_t &counters);
+
+      virtual void save_state(checkpoint_writer_t &cw) const;
+
+      virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   class block_lazy_stack_cache_t : public block_stack_cache_t
@@ -524,6 +550,12 @@ namespace patmos
                                const stats_options_t& options);
 
       void reset_stats();
+
+      virtual void add_counters(stats_counters_t &counters);
+
+      virtual void save_state(checkpoint_writer_t &cw) const;
+
+      virtual void restore_state(checkpoint_reader_t &cr);
   };
 
   /// Operator to print the state of a stack cache to a stream
@@ -0,0 +1,194 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Named counters of the simulator's components and sampling of their
+// values in fixed intervals of cycles.
+//
+
+#ifndef PATMOS_STATS_COUNTERS_H
+#define PATMOS_STATS_COUNTERS_H
+
+#include "command-line.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace patmos
+{
+  /// A set of named statistics counters of the simulator's components.
+  /// The set refers to the counters of the components, their current values
+  /// can thus be read at any time without asking the components. The names
+  /// form a hierarchy, separated by dots, e.g., dcache.read_hits.
+  class stats_counters_t
+  {
+  private:
+    /// A counter of a component, either 32 or 64 bit wide, or a value
+    /// copied when it was added.
+    struct counter_t
+    {
+      /// The name of the counter.
+      std::string Name;
+
+      /// The counter, if it is 32 bit wide.
+      const unsigned int *Value32;
+
+      /// The counter, if it is 64 bit wide.
+      const uint64_t *Value64;
+
+      /// The value, if neither a 32 nor a 64 bit counter is referred to.
+      uint64_t Value;
+
+      /// Flag indicating whether the counter holds a level, e.g., a maximum,
+      /// rather than counting events.
+      bool Is_level;
+    };
+
+    /// The counters, in the order they were added.
+    std::vector<counter_t> Counters;
+
+    /// Prefix prepended to the names of added counters.
+    std::string Prefix;
+
+  public:
+    /// Set the prefix of the names of counters added subsequently.
+    /// @param prefix The prefix, e.g., the role of a component.
+    void set_prefix(const std::string &prefix) { Prefix = prefix; }
+
+    /// @return The prefix of the names of counters added subsequently.
+    const std::string &get_prefix() const { return Prefix; }
+
+    /// Add a 32 bit counter.
+    /// @param name The name of the counter, without the current prefix.
+    /// @param counter The counter, which has to outlive the set.
+    /// @param is_level True if the counter holds a level, e.g., a maximum.
+    void add(const std::string &name, const unsigned int &counter,
+             bool is_level = false);
+
+    /// Add a 64 bit counter.
+    /// @param name The name of the counter, without the current prefix.
+    /// @param counter The counter, which has to outlive the set.
+    /// @param is_level True if the counter holds a level, e.g., a maximum.
+    void add(const std::string &name, const uint64_t &counter,
+             bool is_level = false);
+
+    /// Add a copy of a value, e.g., a sum of counters of a table.
+    /// @param name The name of the value, without the current prefix.
+    /// @param value The value.
+    void add_value(const std::string &name, uint64_t value);
+
+    /// @return The number of counters.
+    unsigned int size() const { return Counters.size(); }
+
+    /// Find a counter by its name.
+    /// @param name The full name of the counter.
+    /// @param index The index of the counter, if found.
+    /// @return True if the counter was found.
+    bool find(const std::string &name, unsigned int &index) const;
+
+    /// @param i The index of a counter.
+    /// @return The full name of the counter.
+    const std::string &name(unsigned int i) const { return Counters[i].Name; }
+
+    /// @param i The index of a counter.
+    /// @return True if the counter holds a level rather than counting events.
+    bool is_level(unsigned int i) const { return Counters[i].Is_level; }
+
+    /// @param i The index of a counter.
+    /// @return The current value of the counter.
+    uint64_t value(unsigned int i) const
+    {
+      const counter_t &c(Counters[i]);
+      return c.Value32 ? *c.Value32 : (c.Value64 ? *c.Value64 : c.Value);
+    }
+
+    /// Write the current values of all counters to a stream.
+    /// In CSV, each counter is a line of its name and value, in JSON, the
+    /// counters are nested in objects along the hierarchy of their names.
+    /// @param os The stream to write to.
+    /// @param format The format of the output.
+    void write(std::ostream &os, stats_format_e format) const;
+  };
+
+  /// Write the increase of a set of counters in intervals of a fixed number
+  /// of cycles to a stream, one line or, as text, one table per interval.
+  class stats_sampler_t
+  {
+  private:
+    /// The stream to write to.
+    std::ostream &Os;
+
+    /// The format of the lines.
+    stats_format_e Format;
+
+    /// The number of cycles per interval.
+    uint64_t Interval;
+
+    /// The counters to sample.
+    stats_counters_t Counters;
+
+    /// The values of the counters at the start of the current interval.
+    std::vector<uint64_t> Last_values;
+
+    /// The cycle at the start of the current interval.
+    uint64_t Last_cycle;
+
+    /// Flag indicating whether the header of CSV output was written.
+    bool Is_header_written;
+
+  public:
+    /// Create a sampler.
+    /// @param os The stream to write to.
+    /// @param format The format of the lines.
+    /// @param interval The number of cycles per interval.
+    stats_sampler_t(std::ostream &os, stats_format_e format, uint64_t interval);
+
+    /// @return The counters to sample, components add their counters here.
+    stats_counters_t &get_counters() { return Counters; }
+
+    /// @return The number of cycles per interval.
+    uint64_t get_interval() const { return Interval; }
+
+    /// Start the first interval.
+    /// @param cycle The current cycle.
+    void start(uint64_t cycle);
+
+    /// Write the increase of the counters since the last sample and start
+    /// the next interval. Counters reset in the meantime are counted from
+    /// zero, levels are written as they are.
+    /// @param cycle The current cycle, ending the interval.
+    void sample(uint64_t cycle);
+  };
+}
+
+#endif // PATMOS_STATS_COUNTERS_H
@@ -39,6 +39,8 @@
 
 #include <ios>
 #include <iostream>
+#include <mutex>
+#include <streambuf>
 
 namespace patmos
 {
@@ -95,6 +97,75 @@ namespace patmos
     }
   }
 
+  /// A stream buffer serializing the accesses of several threads to another
+  /// stream buffer. It does not buffer any data itself, such that it can be
+  /// shared by the threads, while each thread uses a stream of its own on top
+  /// of it.
+  class synchronized_streambuf_t : public std::streambuf
+  {
+  private:
+    /// The stream buffer accessed, may be NULL to discard all output.
+    std::streambuf *Buffer;
+
+    /// Serializes the accesses to the stream buffer.
+    std::mutex Mutex;
+
+  public:
+    /// Construct a stream buffer serializing the accesses to another one.
+    /// @param buffer The stream buffer to access.
+    explicit synchronized_streambuf_t(std::streambuf *buffer) : Buffer(buffer)
+    {
+    }
+
+  protected:
+    virtual int_type overflow(int_type c)
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      if (traits_type::eq_int_type(c, traits_type::eof()))
+        return traits_type::not_eof(c);
+      else if (!Buffer)
+        return traits_type::eof();
+
+      return Buffer->sputc(traits_type::to_char_type(c));
+    }
+
+    virtual std::streamsize xsputn(const char_type *s, std::streamsize n)
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      return Buffer ? Buffer->sputn(s, n) : 0;
+    }
+
+    virtual int_type underflow()
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      return Buffer ? Buffer->sgetc() : traits_type::eof();
+    }
+
+    virtual int_type uflow()
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      return Buffer ? Buffer->sbumpc() : traits_type::eof();
+    }
+
+    virtual std::streamsize xsgetn(char_type *s, std::streamsize n)
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      return Buffer ? Buffer->sgetn(s, n) : 0;
+    }
+
+    virtual std::streamsize showmanyc()
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      return Buffer ? Buffer->in_avail() : -1;
+    }
+
+    virtual int sync()
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      return Buffer ? Buffer->pubsync() : 0;
+    }
+  };
+
   /// Free a stream, e.g., previously opened using get_stream, unless it refers
   /// to an IO stream.
   /// \see get_stream
@@ -0,0 +1,203 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Compact binary format of the instruction trace (see DF_TRACE).
+//
+
+#ifndef PATMOS_TRACE_H
+#define PATMOS_TRACE_H
+
+#include "basic-types.h"
+
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace patmos
+{
+  /// Size of the buffer in which trace records are collected before they are
+  /// compressed and written to the output stream.
+  static const unsigned int TRACE_BUFFER_BYTES = 1 << 20;
+
+  /// Print a record of the instruction trace in the textual format.
+  /// CAVEAT: this format is used by platin's 'analyze-trace' module, do not
+  /// change without adapting platin.
+  /// @param os The output stream to print to.
+  /// @param address The address of the retired bundle.
+  /// @param cycle The cycle in which the bundle retired.
+  /// @param count The number of traced bundles so far.
+  inline void print_trace_record(std::ostream &os, uword_t address,
+                                 uint64_t cycle, uint64_t count)
+  {
+    os << std::hex << std::setw(8) << std::setfill('0') << address << ' '
+       << std::dec << cycle << ' ' << count << '\n' << std::setfill(' ');
+  }
+
+  /// Write the trace of retired bundles in a compact binary format.
+  /// The trace starts with a header, followed by a stream of records, each
+  /// holding the address of the bundle, the cycle and the number of traced
+  /// bundles as the difference to the previous record, packed as variable
+  /// length integers. The stream of records is compressed with zstd if the
+  /// simulator is built with support for it.
+  class trace_writer_t
+  {
+  private:
+    /// The output stream.
+    std::ostream &Stream;
+
+    /// Buffer of encoded records not yet written.
+    std::vector<uint8_t> Buffer;
+
+    /// Number of bytes used in the buffer.
+    unsigned int Buffer_size;
+
+    /// Buffer for the compressed records.
+    std::vector<uint8_t> Compressed;
+
+    /// Compression context, if the trace is compressed.
+    void *Compressor;
+
+    /// Whether the current compressed frame has not been terminated yet.
+    bool Unterminated;
+
+    /// The values of the previous record.
+    uword_t Last_address;
+    uint64_t Last_cycle;
+    uint64_t Last_count;
+
+    /// Append an unsigned integer to the buffer, using 7 bits per byte.
+    void put(uint64_t value)
+    {
+      while (value >= 0x80)
+      {
+        Buffer[Buffer_size++] = (uint8_t)value | 0x80;
+        value >>= 7;
+      }
+      Buffer[Buffer_size++] = (uint8_t)value;
+    }
+
+    /// Write the buffered records to the output stream.
+    /// @param end Whether the compressed stream should be terminated, such
+    /// that it can be read up to this point.
+    void write_buffer(bool end);
+
+  public:
+    /// Construct a trace writer and write the header of the trace.
+    /// @param stream The output stream.
+    trace_writer_t(std::ostream &stream);
+
+    /// Flush the trace, ignoring errors, and release the compression context.
+    ~trace_writer_t();
+
+    /// Add a record to the trace.
+    /// @param address The address of the retired bundle.
+    /// @param cycle The cycle in which the bundle retired.
+    /// @param count The number of traced bundles so far.
+    void write(uword_t address, uint64_t cycle, uint64_t count)
+    {
+      // make sure that a record of maximal size fits into the buffer
+      if (Buffer_size + 3 * 10 > Buffer.size())
+        write_buffer(false);
+
+      // zig-zag encode the address difference, jumps go both ways
+      int32_t delta = (int32_t)(address - Last_address);
+      put(((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+      put(cycle - Last_cycle);
+      put(count - Last_count);
+
+      Last_address = address;
+      Last_cycle = cycle;
+      Last_count = count;
+    }
+
+    /// Write all records to the output stream.
+    void flush();
+  };
+
+  /// Read a trace written by trace_writer_t.
+  class trace_reader_t
+  {
+  private:
+    /// The input stream.
+    std::istream &Stream;
+
+    /// Buffer of decoded records not yet returned.
+    std::vector<uint8_t> Buffer;
+
+    /// Number of valid bytes in the buffer.
+    unsigned int Buffer_size;
+
+    /// Position of the next record in the buffer.
+    unsigned int Buffer_pos;
+
+    /// Buffer for compressed data read from the stream.
+    std::vector<uint8_t> Compressed;
+
+    /// Range of compressed data not yet decompressed.
+    unsigned int Compressed_pos;
+    unsigned int Compressed_size;
+
+    /// Decompression context, if the trace is compressed.
+    void *Decompressor;
+
+    /// The values of the previous record.
+    uword_t Last_address;
+    uint64_t Last_cycle;
+    uint64_t Last_count;
+
+    /// Refill the buffer, keeping the bytes not yet read.
+    /// @return False if the end of the trace has been reached.
+    bool fill_buffer();
+
+    /// Read an unsigned integer from the buffer.
+    uint64_t get();
+
+  public:
+    /// Construct a trace reader and check the header of the trace.
+    /// @param stream The input stream.
+    trace_reader_t(std::istream &stream);
+
+    /// Release the decompression context.
+    ~trace_reader_t();
+
+    /// Read the next record of the trace.
+    /// @param address The address of the retired bundle.
+    /// @param cycle The cycle in which the bundle retired.
+    /// @param count The number of traced bundles so far.
+    /// @return False if the end of the trace has been reached.
+    bool read(uword_t &address, uint64_t &cycle, uint64_t &count);
+  };
+}
+
+#endif // PATMOS_TRACE_H
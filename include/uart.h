@@ -44,6 +44,7 @@
 
 #include "memory-map.h"
 #include "exception.h"
+#include "simulation-core.h"
 
 namespace patmos
 {
@@ -68,6 +69,10 @@ namespace patmos
     /// Stream to store data that is written to the UART.
     std::ostream &Out_stream;
 
+    /// Flag indicating whether a read from the data register is waiting for
+    /// input.
+    bool Is_waiting;
+
     /// bit position of the parity-error bit (PAE).
     static const uword_t PAE = 2;
 
@@ -128,6 +133,7 @@ namespace patmos
     {
       In_stream.read(reinterpret_cast<char*>(value), sizeof(byte_t));
       std::streamsize num = In_stream.gcount();
+      Is_waiting = (num == 0);
       if (num == 0) return false;
 
       assert(num == sizeof(byte_t));
@@ -166,7 +172,7 @@ namespace patmos
         Status_address(base_address+0x00),
         Data_address(base_address+0x04),
         In_stream(in_stream), IsTTY(istty),
-        Out_stream(out_stream)
+        Out_stream(out_stream), Is_waiting(false)
     {}
 
     /// A simulated access to a read port.
@@ -177,6 +183,9 @@ namespace patmos
     /// @return True when the data is available from the read port.
     virtual bool read(simulator_t &s, uword_t address, byte_t *value, uword_t size)
     {
+      // the input and output streams may be shared with other cores
+      s.order_shared_access();
+
       if (address == Status_address && size == 4)
         return read_status(value+3);
       else if (address == Data_address && size == 4)
@@ -193,6 +202,8 @@ namespace patmos
     /// the memory.
     /// @param size The number of bytes to read.
     virtual void peek(simulator_t &s, uword_t address, byte_t *value, uword_t size) {
+      s.order_shared_access();
+
       if (address == Status_address && size == 4)
         read_status(value+3);
       else if (address == Data_address && size == 4)
@@ -209,6 +220,8 @@ namespace patmos
     /// otherwise.
     virtual bool write(simulator_t &s, uword_t address, byte_t *value, uword_t size)
     {
+      s.order_shared_access();
+
       if (address == Status_address && size == 4)
         return write_control(value+3);
       else if (address == Data_address && size == 4)
@@ -217,6 +230,12 @@ namespace patmos
         simulation_exception_t::unmapped(address);
       return true;
     }
+
+    virtual uint64_t get_idle_cycles(simulator_t &s)
+    {
+      // never skip over cycles while waiting for input
+      return Is_waiting ? 0 : std::numeric_limits<uint64_t>::max();
+    }
   };
 }
 
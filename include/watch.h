@@ -0,0 +1,156 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Sets of watched addresses used by the debug output.
+//
+
+#ifndef PATMOS_WATCH_H
+#define PATMOS_WATCH_H
+
+#include "basic-types.h"
+
+#include <istream>
+#include <vector>
+
+namespace patmos
+{
+  /// Kinds of accesses to watch, combined into a bit mask.
+  enum watch_kind_e
+  {
+    WK_READ = 1,
+    WK_WRITE = 2,
+    WK_EXEC = 4
+  };
+
+  /// Ranges up to this size are watched using the bitmaps and the hash table.
+  static const unsigned int WATCH_RANGE_BYTES = 256;
+
+  /// Maximal number of bytes covered by the bitmap of a kind of accesses.
+  static const unsigned int WATCH_BITMAP_BYTES = 1 << 20;
+
+  /// Minimal number of watched addresses to use a bitmap.
+  static const unsigned int WATCH_BITMAP_ADDRESSES = 32;
+
+  /// A set of watched addresses and address ranges, each watched for some
+  /// kinds of accesses. Per kind, a bitmap covers the region holding most of
+  /// the watched addresses, the other addresses are kept in an open
+  /// addressing hash table. Large ranges are checked one by one.
+  class watch_set_t
+  {
+  private:
+    /// A range of watched addresses.
+    struct range_t
+    {
+      uword_t First;
+      uword_t Last;
+      unsigned int Kinds;
+    };
+
+    /// A bitmap of watched addresses.
+    struct bitmap_t
+    {
+      uword_t Base;
+      uword_t Size;
+      std::vector<uint64_t> Bits;
+    };
+
+    /// All watched ranges, as added.
+    std::vector<range_t> Ranges;
+
+    /// The kinds of accesses watched by any of the ranges.
+    unsigned int Kinds;
+
+    /// Whether the lookup structures are up to date.
+    bool Is_built;
+
+    /// Bitmaps for reads, writes and executed addresses.
+    bitmap_t Bitmaps[3];
+
+    /// Hash table of watched addresses not covered by the bitmaps, entries
+    /// without kinds are free.
+    std::vector<uword_t> Hash_addresses;
+    std::vector<uint8_t> Hash_kinds;
+
+    /// Shift selecting the upper bits of a hashed address as slot.
+    unsigned int Hash_shift;
+
+    /// Ranges too large for the bitmaps and the hash table.
+    std::vector<range_t> Large_ranges;
+
+    /// Build the lookup structures from the watched ranges.
+    void build();
+
+    /// Get the slot of an address in the hash table.
+    unsigned int hash(uword_t address) const
+    {
+      return (uint32_t)(address * 0x9e3779b1u) >> Hash_shift;
+    }
+
+    /// Add an address to the hash table.
+    void hash_add(uword_t address, unsigned int kinds);
+
+    /// Check whether an address is watched for a kind of access.
+    bool lookup(uword_t address, watch_kind_e kind);
+
+  public:
+    watch_set_t() : Kinds(0), Is_built(true), Hash_shift(31)
+    {
+    }
+
+    /// Watch a range of addresses.
+    /// @param first The first address of the range.
+    /// @param last The last address of the range.
+    /// @param kinds The kinds of accesses to watch, see watch_kind_e.
+    void add(uword_t first, uword_t last, unsigned int kinds);
+
+    /// Read watched addresses from a stream, one per line in the form
+    /// 'address[-last|+size] [rwx]', where the kinds of accesses default to
+    /// 'x'. Addresses are decimal, or hexadecimal if prefixed with 0x.
+    /// @param in The stream to read from.
+    void read(std::istream &in);
+
+    /// Check whether a kind of access is watched at all.
+    bool watches(watch_kind_e kind) const
+    {
+      return Kinds & kind;
+    }
+
+    /// Check whether an address is watched for a kind of access.
+    bool contains(uword_t address, watch_kind_e kind)
+    {
+      return (Kinds & kind) && lookup(address, kind);
+    }
+  };
+}
+
+#endif // PATMOS_WATCH_H
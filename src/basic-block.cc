@@ -0,0 +1,171 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+
+//
+// Basic blocks of translated bundles, executed by the bb engine.
+//
+
+#include "basic-block.h"
+#include "instruction.h"
+
+namespace patmos
+{
+  block_cache_t::block_cache_t() : Current(NULL), Index(0)
+  {
+  }
+
+  block_cache_t::~block_cache_t()
+  {
+    flush();
+  }
+
+  basic_block_t *block_cache_t::enter(uword_t address)
+  {
+    // follow the links of the current block first
+    bool is_fall_through = Current && Index == Current->Bundles.size() &&
+                           address == Current->End;
+    if (Current)
+    {
+      basic_block_t *link = is_fall_through ? Current->Next : Current->Branch;
+      if (link && link->Address == address)
+        return link;
+    }
+
+    basic_block_t *&block = Blocks[address];
+    if (!block)
+      block = new basic_block_t(address);
+
+    if (is_fall_through)
+      Current->Next = block;
+    else if (Current)
+      Current->Branch = block;
+
+    return block;
+  }
+
+  void block_cache_t::translate(simulator_t &s, basic_block_t &block,
+                                const word_t *iw)
+  {
+    block.Bundles.push_back(translated_bundle_t());
+    translated_bundle_t &tb(block.Bundles.back());
+
+    tb.Address = block.End;
+    tb.IW[0] = iw[0];
+    tb.IW[1] = iw[1];
+
+    word_t words[NUM_SLOTS] = { iw[0], iw[1] };
+    tb.Size = s.Decoder.decode(words, tb.Ops, false);
+    assert(tb.Size != 0);
+
+    tb.Is_flow_control = false;
+    for(unsigned int i = 0; i < NUM_SLOTS; i++)
+    {
+      instruction_data_t &ops(tb.Ops[i]);
+      ops.Address = tb.Address + i*sizeof(word_t);
+
+      tb.Functions[SIF][i] = NULL;
+      if (ops.I)
+      {
+        const stage_functions_t &f(decoder_t::get_stage_functions(*ops.I));
+        tb.Functions[SDR][i] = f.DR;
+        tb.Functions[SEX][i] = f.EX;
+        tb.Functions[SMW][i] = f.MW;
+        tb.Is_flow_control |= ops.I->is_flow_control();
+        tb.Src1[i] = ops.I->get_src1_reg(ops);
+        tb.Src2[i] = ops.I->get_src2_reg(ops);
+      }
+      else
+      {
+        tb.Functions[SDR][i] = tb.Functions[SEX][i] = tb.Functions[SMW][i] =
+                                                                         NULL;
+        tb.Src1[i] = tb.Src2[i] = r0;
+      }
+    }
+
+    const instruction_t *i0 = tb.Ops[0].I;
+    tb.Intr_delay_slots = i0->get_intr_delay_slots(tb.Ops[0]);
+    tb.Is_NOP = s.Decoder.is_NOP(&tb.Ops[0]) && !tb.Ops[1].I;
+    tb.Conflict = s.get_dual_issue_conflict(tb.Ops);
+    tb.Load_dst = i0->is_load() ? i0->get_dst_reg(tb.Ops[0]) : r0;
+
+    block.End = tb.Address + tb.Size*sizeof(word_t);
+  }
+
+  const translated_bundle_t *block_cache_t::fetch(simulator_t &s,
+                                                  uword_t address,
+                                                  const word_t *iw)
+  {
+    if (!Current || Index >= Current->Bundles.size() ||
+        Current->Bundles[Index].Address != address)
+    {
+      if (Current && Index == Current->Bundles.size() &&
+          !Current->is_complete() && address == Current->End)
+      {
+        // grow the current block
+        translate(s, *Current, iw);
+      }
+      else
+      {
+        Current = enter(address);
+        Index = 0;
+
+        if (Current->Bundles.empty())
+          translate(s, *Current, iw);
+      }
+    }
+
+    const translated_bundle_t &tb(Current->Bundles[Index]);
+
+    // the code was modified, start over with the new code.
+    if (tb.IW[0] != iw[0] || tb.IW[1] != iw[1])
+    {
+      flush();
+      return NULL;
+    }
+
+    Index++;
+    return &tb;
+  }
+
+  void block_cache_t::flush()
+  {
+    for(blocks_t::iterator i(Blocks.begin()), ie(Blocks.end()); i != ie; i++)
+    {
+      delete i->second;
+    }
+
+    Blocks.clear();
+    Current = NULL;
+    Index = 0;
+  }
+}
@@ -0,0 +1,97 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Implementation of the tag store of set-associative caches.
+//
+
+#include "cache-tags.h"
+
+#include "checkpoint.h"
+
+#include <cassert>
+
+using namespace patmos;
+
+set_assoc_tags_t::set_assoc_tags_t(unsigned int num_sets,
+                                   unsigned int associativity) :
+    Num_sets(num_sets), Associativity(associativity),
+    Set_stride(((associativity + LANES - 1) / LANES) * LANES),
+    Valid_stride((associativity + VALID_BITS - 1) / VALID_BITS),
+    Tags(num_sets * Set_stride, 0), Valid(num_sets * Valid_stride, 0)
+{
+  assert(associativity > 0);
+}
+
+unsigned int set_assoc_tags_t::find_invalid(unsigned int set) const
+{
+  const uint64_t *valid = &Valid[set * Valid_stride];
+  for(unsigned int w = 0; w < Associativity; w += VALID_BITS)
+  {
+    uint64_t invalid = ~valid[w / VALID_BITS];
+    if (Associativity - w < VALID_BITS)
+      invalid &= ((uint64_t)1 << (Associativity - w)) - 1;
+
+    if (invalid)
+      return w + __builtin_ctzll(invalid);
+  }
+
+  return Associativity;
+}
+
+void set_assoc_tags_t::get_valid_ways(unsigned int set,
+                                      std::vector<unsigned int> &ways) const
+{
+  ways.clear();
+  for(unsigned int i = 0; i < Associativity; i++)
+  {
+    if (is_valid(set, i))
+      ways.push_back(i);
+  }
+}
+
+void set_assoc_tags_t::invalidate()
+{
+  std::fill(Valid.begin(), Valid.end(), 0);
+}
+
+void set_assoc_tags_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(Tags.data(), Tags.size() * sizeof(uword_t));
+  cw.write(Valid.data(), Valid.size() * sizeof(uint64_t));
+}
+
+void set_assoc_tags_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(Tags.data(), Tags.size() * sizeof(uword_t));
+  cr.read(Valid.data(), Valid.size() * sizeof(uint64_t));
+}
@@ -0,0 +1,233 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Reading and writing checkpoints of the simulation state.
+//
+
+#include "checkpoint.h"
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ios>
+#include <vector>
+
+namespace patmos
+{
+  /// Magic number at the start of a checkpoint file.
+  static const char CHECKPOINT_MAGIC[8] = {'P','A','S','I','M','C','K','P'};
+
+  /// Version of the checkpoint format.
+  static const uint32_t CHECKPOINT_VERSION = 2;
+
+  /// Get the number of pages needed to store a memory content.
+  static uint64_t get_num_pages(uint64_t size)
+  {
+    return (size + CHECKPOINT_PAGE_BYTES - 1) / CHECKPOINT_PAGE_BYTES;
+  }
+
+  checkpoint_writer_t::checkpoint_writer_t(const std::string &filename) :
+      Filename(filename), Stream(filename.c_str(), std::ios::binary),
+      Offset(0)
+  {
+    if (!Stream.good())
+    {
+      throw std::ios_base::failure("Failed to open file: " + filename);
+    }
+
+    write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    write_config(CHECKPOINT_VERSION);
+    write_config(CHECKPOINT_PAGE_BYTES);
+  }
+
+  void checkpoint_writer_t::write(const void *data, uint64_t size)
+  {
+    Stream.write(reinterpret_cast<const char*>(data), size);
+    Offset += size;
+  }
+
+  void checkpoint_writer_t::write_pages(const byte_t *data, uint64_t size,
+                                        const std::vector<bool> &pages)
+  {
+    static const byte_t zeros[CHECKPOINT_PAGE_BYTES] = {0};
+
+    write_config(size);
+
+    // mark the pages that are in use
+    uint64_t num_pages = get_num_pages(size);
+    assert(pages.size() == num_pages);
+    std::vector<byte_t> bitmap((num_pages + 7) / 8, 0);
+    for(uint64_t p = 0; p < num_pages; p++)
+    {
+      if (pages[p])
+      {
+        bitmap[p / 8] |= 1 << (p % 8);
+      }
+    }
+    write(bitmap.data(), bitmap.size());
+
+    // write the marked pages, padding the last page
+    for(uint64_t p = 0; p < num_pages; p++)
+    {
+      if (bitmap[p / 8] & (1 << (p % 8)))
+      {
+        uint64_t start = p * CHECKPOINT_PAGE_BYTES;
+        uint64_t bytes = std::min<uint64_t>(size - start,
+                                            CHECKPOINT_PAGE_BYTES);
+        write(data + start, bytes);
+        write(zeros, CHECKPOINT_PAGE_BYTES - bytes);
+      }
+    }
+  }
+
+  void checkpoint_writer_t::finish()
+  {
+    Stream.flush();
+    if (!Stream.good())
+    {
+      throw std::ios_base::failure("Failed to write checkpoint: " + Filename);
+    }
+  }
+
+  checkpoint_reader_t::checkpoint_reader_t(const std::string &filename) :
+      Filename(filename), Stream(filename.c_str(), std::ios::binary),
+      Size(0), Offset(0)
+  {
+    if (!Stream.good())
+    {
+      throw std::ios_base::failure("Failed to open file: " + filename);
+    }
+
+    Stream.seekg(0, std::ios::end);
+    Size = Stream.tellg();
+    Stream.seekg(0, std::ios::beg);
+    if (!Stream.good())
+    {
+      throw std::ios_base::failure("Failed to read file: " + filename);
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    if (Size < sizeof(magic))
+    {
+      error("not a checkpoint file");
+    }
+    read(magic, sizeof(magic));
+    if (std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0)
+    {
+      error("not a checkpoint file");
+    }
+    check_config(CHECKPOINT_VERSION, "version");
+    check_config(CHECKPOINT_PAGE_BYTES, "page size");
+  }
+
+  void checkpoint_reader_t::error(const std::string &msg) const
+  {
+    throw std::ios_base::failure(
+              (boost::format("Invalid checkpoint %1%: %2%") % Filename % msg).str());
+  }
+
+  void checkpoint_reader_t::skip(uint64_t size)
+  {
+    if (size > Size - Offset)
+    {
+      error("unexpected end of file");
+    }
+
+    Stream.seekg(size, std::ios::cur);
+    Offset += size;
+  }
+
+  void checkpoint_reader_t::read(void *data, uint64_t size)
+  {
+    if (size > Size - Offset)
+    {
+      error("unexpected end of file");
+    }
+
+    Stream.read(reinterpret_cast<char*>(data), size);
+    Offset += size;
+    if (!Stream.good())
+    {
+      throw std::ios_base::failure("Failed to read file: " + Filename);
+    }
+  }
+
+  void checkpoint_reader_t::check_config(uint64_t value, const char *what)
+  {
+    uint64_t expected = read<uint64_t>();
+    if (value != expected)
+    {
+      error((boost::format("%1% does not match (%2% instead of %3%)")
+             % what % value % expected).str());
+    }
+  }
+
+  void checkpoint_reader_t::read_pages(byte_t *data, uint64_t size,
+                                       std::vector<bool> &pages)
+  {
+    check_config(size, "memory size");
+
+    uint64_t num_pages = get_num_pages(size);
+    assert(pages.size() == num_pages);
+    std::vector<byte_t> bitmap((num_pages + 7) / 8);
+    read(bitmap.data(), bitmap.size());
+
+    // read the stored pages, clear the other pages in use.
+    for(uint64_t p = 0; p < num_pages; p++)
+    {
+      uint64_t start = p * CHECKPOINT_PAGE_BYTES;
+      uint64_t bytes = std::min<uint64_t>(size - start, CHECKPOINT_PAGE_BYTES);
+      if (bitmap[p / 8] & (1 << (p % 8)))
+      {
+        read(data + start, bytes);
+        skip(CHECKPOINT_PAGE_BYTES - bytes);
+        pages[p] = true;
+      }
+      else if (pages[p])
+      {
+        std::memset(data + start, 0, bytes);
+        pages[p] = false;
+      }
+    }
+  }
+
+  void checkpoint_reader_t::finish()
+  {
+    if (Offset != Size)
+    {
+      error("unexpected data at the end of the file");
+    }
+  }
+}
@@ -57,6 +57,8 @@ namespace patmos
       df = DF_SHORT;
     else if(kind == "trace")
       df = DF_TRACE;
+    else if(kind == "btrace")
+      df = DF_BTRACE;
     else if(kind == "instr")
       df = DF_INSTRUCTIONS;
     else if (kind == "blocks")
@@ -86,6 +88,8 @@ namespace patmos
         os << "short"; break;
       case DF_TRACE:
         os << "trace"; break;
+      case DF_BTRACE:
+        os << "btrace"; break;
       case DF_INSTRUCTIONS:
         os << "instr"; break;
       case DF_BLOCKS:
@@ -205,33 +209,42 @@ namespace patmos
     {
       dck.policy = SAC_DM;
     }
-    else if(kind == "lru")
-    {
-      dck.policy = SAC_LRU;
-      dck.associativity = 0;
-      return in;
-    }
-    else if(kind == "fifo")
-    {
-      dck.policy = SAC_FIFO;
-      dck.associativity = 0;
-      return in;
-    }
-    else if(kind.substr(0,3) == "lru")
-    {
-      dck.policy = SAC_LRU;
-      assoc = kind.substr(3,8);
-    }
-    else if(kind.substr(0,4) == "fifo")
-    {
-      dck.policy = SAC_FIFO;
-      assoc = kind.substr(4,8);
-    }
     else
     {
-      throw boost::program_options::validation_error(
-        boost::program_options::validation_error::invalid_option_value,
-        "Unknown set-associative cache kind: " + tmp);
+      // replacement policies, optionally followed by the associativity
+      static const struct { const char *name; set_assoc_policy_e policy; }
+        policies[] = { {"lru", SAC_LRU}, {"fifo", SAC_FIFO},
+                       {"plru", SAC_PLRU}, {"bplru", SAC_BPLRU},
+                       {"rand", SAC_RANDOM}, {"srrip", SAC_SRRIP},
+                       {"brrip", SAC_BRRIP} };
+
+      bool found = false;
+      for(const auto &p : policies)
+      {
+        std::string name(p.name);
+        if (kind.compare(0, name.size(), name) == 0 &&
+            (kind.size() == name.size() || std::isdigit(kind[name.size()])))
+        {
+          dck.policy = p.policy;
+          assoc = kind.substr(name.size(), 8);
+          found = true;
+          break;
+        }
+      }
+
+      if (!found)
+      {
+        throw boost::program_options::validation_error(
+          boost::program_options::validation_error::invalid_option_value,
+          "Unknown set-associative cache kind: " + tmp);
+      }
+
+      // fully-associative
+      if (assoc.empty())
+      {
+        dck.associativity = 0;
+        return in;
+      }
     }
     std::istringstream is(assoc);
     is >> dck.associativity;
@@ -267,6 +280,26 @@ namespace patmos
         os << "fifo";
         if (dck.associativity) os << dck.associativity;
         break;
+      case SAC_PLRU:
+        os << "plru";
+        if (dck.associativity) os << dck.associativity;
+        break;
+      case SAC_BPLRU:
+        os << "bplru";
+        if (dck.associativity) os << dck.associativity;
+        break;
+      case SAC_RANDOM:
+        os << "rand";
+        if (dck.associativity) os << dck.associativity;
+        break;
+      case SAC_SRRIP:
+        os << "srrip";
+        if (dck.associativity) os << dck.associativity;
+        break;
+      case SAC_BRRIP:
+        os << "brrip";
+        if (dck.associativity) os << dck.associativity;
+        break;
     }
 
     return os;
@@ -428,6 +461,198 @@ namespace patmos
     return os;
   }
 
+  std::istream &operator >>(std::istream &in, engine_e &en)
+  {
+    std::string tmp, kind;
+    in >> tmp;
+
+    kind.resize(tmp.size());
+    std::transform(tmp.begin(), tmp.end(), kind.begin(), ::tolower);
+
+    if(kind == "cycle")
+      en = EN_CYCLE;
+    else if(kind == "bb")
+      en = EN_BB;
+    else throw boost::program_options::validation_error(
+                 boost::program_options::validation_error::invalid_option_value,
+                 "Unknown execution engine: " + tmp);
+
+    return in;
+  }
+
+  std::ostream &operator <<(std::ostream &os, engine_e en)
+  {
+    switch(en)
+    {
+      case EN_CYCLE:
+        os << "cycle"; break;
+      case EN_BB:
+        os << "bb"; break;
+    }
+
+    return os;
+  }
+
+  std::istream &operator >>(std::istream &in, sync_e &sy)
+  {
+    std::string tmp, kind;
+    in >> tmp;
+
+    kind.resize(tmp.size());
+    std::transform(tmp.begin(), tmp.end(), kind.begin(), ::tolower);
+
+    if(kind == "cycle")
+      sy = SY_CYCLE;
+    else if(kind == "quantum")
+      sy = SY_QUANTUM;
+    else throw boost::program_options::validation_error(
+                 boost::program_options::validation_error::invalid_option_value,
+                 "Unknown synchronization mode: " + tmp);
+
+    return in;
+  }
+
+  std::ostream &operator <<(std::ostream &os, sync_e sy)
+  {
+    switch(sy)
+    {
+      case SY_CYCLE:
+        os << "cycle"; break;
+      case SY_QUANTUM:
+        os << "quantum"; break;
+    }
+
+    return os;
+  }
+
+  std::istream &operator >>(std::istream &in, stats_format_e &sf)
+  {
+    std::string tmp, kind;
+    in >> tmp;
+
+    kind.resize(tmp.size());
+    std::transform(tmp.begin(), tmp.end(), kind.begin(), ::tolower);
+
+    if(kind == "text")
+      sf = SF_TEXT;
+    else if(kind == "csv")
+      sf = SF_CSV;
+    else if(kind == "json")
+      sf = SF_JSON;
+    else throw boost::program_options::validation_error(
+                 boost::program_options::validation_error::invalid_option_value,
+                 "Unknown statistics format: " + tmp);
+
+    return in;
+  }
+
+  std::ostream &operator <<(std::ostream &os, stats_format_e sf)
+  {
+    switch(sf)
+    {
+      case SF_TEXT:
+        os << "text"; break;
+      case SF_CSV:
+        os << "csv"; break;
+      case SF_JSON:
+        os << "json"; break;
+    }
+
+    return os;
+  }
+
+  std::istream &operator >>(std::istream &in, prefetch_type &pf)
+  {
+    std::string tmp, kind;
+    std::string degree;
+    in >> tmp;
+
+    kind.resize(tmp.size());
+    std::transform(tmp.begin(), tmp.end(), kind.begin(), ::tolower);
+
+    if(kind == "no")
+    {
+      pf.kind = PF_NO;
+      pf.degree = 0;
+      return in;
+    }
+    else if(kind.substr(0,4) == "next")
+    {
+      pf.kind = PF_NEXT;
+      degree = kind.substr(4);
+    }
+    else if(kind.substr(0,6) == "stride")
+    {
+      pf.kind = PF_STRIDE;
+      degree = kind.substr(6);
+    }
+    else
+    {
+      throw boost::program_options::validation_error(
+        boost::program_options::validation_error::invalid_option_value,
+        "Unknown prefetcher kind: " + tmp);
+    }
+
+    pf.degree = 1;
+    if (!degree.empty())
+    {
+      std::istringstream is(degree);
+      if (!(is >> pf.degree) || !is.eof() || pf.degree == 0 || pf.degree > 16)
+        throw boost::program_options::validation_error(
+          boost::program_options::validation_error::invalid_option_value,
+          "Invalid prefetch degree (1 to 16): " + tmp);
+    }
+
+    return in;
+  }
+
+  std::ostream &operator <<(std::ostream &os, prefetch_type pf)
+  {
+    switch(pf.kind)
+    {
+      case PF_NO:
+        os << "no"; break;
+      case PF_NEXT:
+        os << "next" << pf.degree; break;
+      case PF_STRIDE:
+        os << "stride" << pf.degree; break;
+    }
+
+    return os;
+  }
+
+  std::istream &operator >>(std::istream &in, write_policy_e &wp)
+  {
+    std::string tmp, kind;
+    in >> tmp;
+
+    kind.resize(tmp.size());
+    std::transform(tmp.begin(), tmp.end(), kind.begin(), ::tolower);
+
+    if(kind == "wt")
+      wp = WP_THROUGH;
+    else if(kind == "wb")
+      wp = WP_BACK;
+    else throw boost::program_options::validation_error(
+                 boost::program_options::validation_error::invalid_option_value,
+                 "Unknown write policy: " + tmp);
+
+    return in;
+  }
+
+  std::ostream &operator <<(std::ostream &os, write_policy_e wp)
+  {
+    switch(wp)
+    {
+      case WP_THROUGH:
+        os << "wt"; break;
+      case WP_BACK:
+        os << "wb"; break;
+    }
+
+    return os;
+  }
+
   std::istream &operator >>(std::istream &in, byte_size_t &bs)
   {
     unsigned int v;
@@ -510,4 +735,35 @@ namespace patmos
 
     return os;
   }
+
+  std::istream &operator >>(std::istream &in, sim_point_t &p)
+  {
+    std::string tmp;
+    in >> tmp;
+
+    if (!tmp.empty() && tmp[0] >= '0' && tmp[0] <= '9') {
+      uint64_t v;
+      std::stringstream s(tmp);
+      s >> v;
+      if (s.fail() || !s.eof())
+        throw boost::program_options::validation_error(
+                 boost::program_options::validation_error::invalid_option_value,
+                 "Invalid cycle: " + tmp);
+      p = v;
+    } else {
+      p.set_symbol(tmp);
+    }
+
+    return in;
+  }
+
+  std::ostream &operator <<(std::ostream &os, const sim_point_t &p)
+  {
+    if (p.is_symbol())
+      os << p.symbol();
+    else
+      os << p.cycle();
+
+    return os;
+  }
 }
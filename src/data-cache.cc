@@ -35,16 +35,18 @@
 //
 #include "data-cache.h"
 
+#include "checkpoint.h"
 #include "memory.h"
 #include "exception.h"
 #include "simulation-core.h"
+#include "stats-counters.h"
 
 #include <boost/format.hpp>
 
 using namespace patmos;
 
-template<bool LRU_REPLACEMENT>
-unsigned int set_assoc_data_cache_t<LRU_REPLACEMENT>::
+template<typename REPLACEMENT>
+unsigned int set_assoc_data_cache_t<REPLACEMENT>::
              get_block_address(uword_t address, uword_t size)
 {
   // align to block addresses
@@ -56,104 +58,328 @@ unsigned int set_assoc_data_cache_t<LRU_REPLACEMENT>::
   return block_address;
 }
 
-template<bool LRU_REPLACEMENT>
-set_assoc_data_cache_t<LRU_REPLACEMENT>::
+template<typename REPLACEMENT>
+set_assoc_data_cache_t<REPLACEMENT>::
 set_assoc_data_cache_t(memory_t &memory, unsigned int associativity,
                        unsigned int num_blocks,
-                       unsigned int num_block_bytes) :
+                       unsigned int num_block_bytes,
+                       write_policy_e write_policy,
+                       bool write_allocate, uword_t seed,
+                       unsigned int num_victims, prefetch_type prefetch) :
     ideal_data_cache_t(memory), Num_blocks(num_blocks),
     Num_block_bytes(num_block_bytes),
     Associativity(associativity),
-    Num_indexes(num_blocks / Associativity), Is_busy(false),
+    Num_indexes(num_blocks / Associativity),
+    Write_policy(write_policy), Is_write_allocate(write_allocate),
+    Is_busy(false), Is_write_allocated(false),
+    Tags(Num_indexes, Associativity), Is_dirty(num_blocks, false),
+    Replacement(Num_indexes, Associativity, seed),
+    Is_prefetched(num_blocks, false),
+    Victims(num_victims, victim_line_t{false, false, 0}),
+    Victim_data(num_victims * num_block_bytes, 0), Victim_next(0),
+    Prefetch(prefetch), Is_prefetching(false), Is_prefetch_fetch(false),
+    Is_prefetch_late(false),
+    Prefetch_address(0), Prefetch_data(num_block_bytes, 0),
+    Last_trigger_address(0), Last_stride(0),
     Num_stall_cycles(0),
     Num_read_hits(0), Num_read_misses(0), Num_read_hit_bytes(0),
     Num_read_miss_bytes(0), Num_write_hits(0), Num_write_misses(0),
-    Num_write_hit_bytes(0), Num_write_miss_bytes(0)
+    Num_write_hit_bytes(0), Num_write_miss_bytes(0),
+    Num_allocations(0), Num_write_backs(0), Num_write_throughs(0),
+    Num_evictions(0), Num_victim_hits(0), Num_prefetches(0),
+    Num_useful_prefetches(0), Num_late_prefetches(0),
+    Num_dropped_prefetches(0)
 {
   assert(num_blocks % Associativity == 0);
-  Content = new cache_tags_t[Num_indexes];
+  Line_data = new byte_t[Num_blocks * Num_block_bytes]();
+}
 
-  // initialize tags
-  for(unsigned int i = 0; i < Num_indexes; i++)
+template<typename REPLACEMENT>
+set_assoc_data_cache_t<REPLACEMENT>::~set_assoc_data_cache_t()
+{
+  // free the cache content.
+  delete[] Line_data;
+}
+
+template<typename REPLACEMENT>
+bool set_assoc_data_cache_t<REPLACEMENT>::
+fill(simulator_t &s, unsigned int set, uword_t block_address, bool is_fetch,
+     unsigned int &way)
+{
+  // wait for a pending prefetch, it might even bring the block
+  if (Is_prefetching)
   {
-    Content[i] = new cache_tag_t[Associativity];
-    for(unsigned int j = 0; j < Associativity; j++)
+    if (Prefetch_address == block_address && !Is_prefetch_late)
     {
-      Content[i][j].Is_valid = false;
+      Is_prefetch_late = true;
+      Num_late_prefetches++;
     }
+    return false;
+  }
+
+  // prefer invalid ways, otherwise ask the replacement policy
+  way = Tags.find_invalid(set);
+  bool is_eviction = (way == Associativity);
+  if (is_eviction)
+    way = Replacement.victim(set);
+
+  unsigned int line = set * Associativity + way;
+  byte_t *data = get_line(set, way);
+
+  // serve the miss from the victim buffer, swapping the lines
+  unsigned int v = find_victim(block_address);
+  if (v < Victims.size())
+  {
+    byte_t *victim_data = &Victim_data[v * Num_block_bytes];
+    bool is_dirty = Victims[v].Is_dirty;
+    if (is_eviction)
+    {
+      std::swap_ranges(data, data + Num_block_bytes, victim_data);
+      Victims[v].Is_dirty = Is_dirty[line];
+      Victims[v].Block_address = Tags.tag(set, way);
+      Num_evictions++;
+    }
+    else
+    {
+      std::copy(victim_data, victim_data + Num_block_bytes, data);
+      Victims[v].Is_valid = false;
+    }
+
+    Tags.insert(set, way, block_address);
+    Replacement.insert(set, way);
+    Is_dirty[line] = is_dirty;
+    Is_prefetched[line] = false;
+    Num_victim_hits++;
+    return true;
+  }
+
+  // keep the evicted line in the victim buffer
+  if (is_eviction && !Victims.empty())
+  {
+    if (!evict_to_victims(s, set, way))
+      return false;
+
+    is_eviction = false;
+    Num_evictions++;
+  }
+
+  // write back the data of a dirty victim first
+  if (Is_dirty[line])
+  {
+    uword_t victim_address = Tags.tag(set, way);
+    if (!Memory.write(s, victim_address, data, Num_block_bytes))
+      return false;
+
+    // the memory might only have queued a posted write
+    Memory.write_peek(s, victim_address, data, Num_block_bytes);
+    Is_dirty[set * Associativity + way] = false;
+    Num_write_backs++;
   }
+
+  if (!Memory.read(s, block_address, data, Num_block_bytes, is_fetch))
+    return false;
+
+  // set tag information
+  Tags.insert(set, way, block_address);
+  Replacement.insert(set, way);
+  Is_prefetched[line] = false;
+  if (is_eviction)
+    Num_evictions++;
+
+  trigger_prefetch(block_address, is_fetch);
+
+  return true;
 }
 
-template<bool LRU_REPLACEMENT>
-set_assoc_data_cache_t<LRU_REPLACEMENT>::~set_assoc_data_cache_t()
+template<typename REPLACEMENT>
+unsigned int set_assoc_data_cache_t<REPLACEMENT>::
+find_victim(uword_t block_address) const
 {
-  // free tag information.
-  delete[] Content;
+  for(unsigned int i = 0; i < Victims.size(); i++)
+  {
+    if (Victims[i].Is_valid && Victims[i].Block_address == block_address)
+      return i;
+  }
+
+  return Victims.size();
 }
 
-template<bool LRU_REPLACEMENT>
-bool set_assoc_data_cache_t<LRU_REPLACEMENT>::
-read(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch)
+template<typename REPLACEMENT>
+bool set_assoc_data_cache_t<REPLACEMENT>::
+evict_to_victims(simulator_t &s, unsigned int set, unsigned int way)
 {
-  // temporary buffer
-  byte_t buf[Num_block_bytes];
+  // take a free line of the victim buffer, otherwise the oldest one
+  unsigned int v = 0;
+  while (v < Victims.size() && Victims[v].Is_valid)
+    v++;
+  if (v == Victims.size())
+    v = Victim_next;
+
+  victim_line_t &victim(Victims[v]);
+  byte_t *victim_data = &Victim_data[v * Num_block_bytes];
+
+  // write back the data of a dirty line of the buffer first
+  if (victim.Is_valid && victim.Is_dirty)
+  {
+    if (!Memory.write(s, victim.Block_address, victim_data, Num_block_bytes))
+      return false;
 
-  // get block address
-  unsigned int block_address = get_block_address(address, size);
+    // the memory might only have queued a posted write
+    Memory.write_peek(s, victim.Block_address, victim_data, Num_block_bytes);
+    victim.Is_dirty = false;
+    Num_write_backs++;
+  }
 
-  if (address - block_address + size > Num_block_bytes) {
-    // Either size too big or not properly aligned
-    simulation_exception_t::unaligned(address);
+  // move the line
+  unsigned int line = set * Associativity + way;
+  const byte_t *data = get_line(set, way);
+  std::copy(data, data + Num_block_bytes, victim_data);
+  victim.Is_valid = true;
+  victim.Is_dirty = Is_dirty[line];
+  victim.Block_address = Tags.tag(set, way);
+  Victim_next = (v + 1) % Victims.size();
+
+  Tags.remove(set, way);
+  Is_dirty[line] = false;
+  Is_prefetched[line] = false;
+
+  return true;
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
+trigger_prefetch(uword_t block_address, bool is_fetch)
+{
+  if (Prefetch.kind == PF_NO)
+    return;
+
+  uword_t stride = Num_block_bytes;
+  if (Prefetch.kind == PF_STRIDE)
+  {
+    // prefetch only once the distance between accesses repeats
+    stride = block_address - Last_trigger_address;
+    bool is_repeated = (stride == Last_stride && stride != 0);
+    Last_trigger_address = block_address;
+    Last_stride = stride;
+    if (!is_repeated)
+      return;
+  }
+
+  // newer candidates replace older ones that were not issued yet
+  for(unsigned int i = 1; i <= Prefetch.degree; i++)
+  {
+    Prefetch_queue.push_back(block_address + i * stride);
+  }
+  while (Prefetch_queue.size() > Prefetch.degree)
+  {
+    Prefetch_queue.pop_front();
   }
 
-  // get tag information
-  unsigned int entry_index = (block_address / Num_block_bytes)
-			     % Num_indexes;
-  cache_tags_t &tags(Content[entry_index]);
+  Is_prefetch_fetch = is_fetch;
+}
 
-  // tag_index corresponds to age of the cache block; we have
-  // (tag_index == Associativity) iff tag is not in the cache
-  unsigned int tag_index = Associativity;
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::install_prefetch(simulator_t &s)
+{
+  uword_t block_address = Prefetch_address;
+  unsigned int set = get_set(block_address);
 
-  // check if content is in the cache
-  for(unsigned int i = 0; i < Associativity; i++)
+  // the block might have been loaded by a miss meanwhile
+  if (Tags.find(set, block_address) < Associativity ||
+      find_victim(block_address) < Victims.size())
+    return;
+
+  unsigned int way = Tags.find_invalid(set);
+  if (way == Associativity)
   {
-    if (tags[i].Is_valid && tags[i].Block_address == block_address)
+    way = Replacement.victim(set);
+
+    // prefetches do not wait for write-backs
+    unsigned int v = Victim_next;
+    for(unsigned int i = 0; i < Victims.size(); i++)
+    {
+      if (!Victims[i].Is_valid)
+      {
+        v = i;
+        break;
+      }
+    }
+    bool is_dirty = Victims.empty() ? Is_dirty[set * Associativity + way] :
+                    (Victims[v].Is_valid && Victims[v].Is_dirty);
+    if (is_dirty)
     {
-      tag_index = i;
-      break;
+      Num_dropped_prefetches++;
+      return;
     }
+
+    if (!Victims.empty())
+    {
+      bool is_moved = evict_to_victims(s, set, way);
+      assert(is_moved);
+      (void)is_moved;
+    }
+    Num_evictions++;
+  }
+
+  std::copy(Prefetch_data.begin(), Prefetch_data.end(), get_line(set, way));
+  Tags.insert(set, way, block_address);
+  Replacement.insert(set, way);
+  // a late prefetch is accounted for already
+  Is_dirty[set * Associativity + way] = false;
+  Is_prefetched[set * Associativity + way] = !Is_prefetch_late;
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
+hit_prefetched(unsigned int set, unsigned int way, bool is_fetch)
+{
+  unsigned int line = set * Associativity + way;
+  if (Is_prefetched[line])
+  {
+    Is_prefetched[line] = false;
+    Num_useful_prefetches++;
+    trigger_prefetch(Tags.tag(set, way), is_fetch);
+  }
+}
+
+template<typename REPLACEMENT>
+bool set_assoc_data_cache_t<REPLACEMENT>::
+read(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch)
+{
+  // get block address
+  unsigned int block_address = get_block_address(address, size);
+
+  if (address - block_address + size > Num_block_bytes) {
+    // Either size too big or not properly aligned
+    simulation_exception_t::unaligned(address);
   }
 
-  bool cache_hit = (tag_index < Associativity);
+  // check if content is in the cache
+  unsigned int set = get_set(block_address);
+  unsigned int way = Tags.find(set, block_address);
+  bool cache_hit = (way < Associativity);
 
   // update cache state and read data
-  if (cache_hit || Memory.read(s, block_address, buf, Num_block_bytes, is_fetch))
+  if (cache_hit || fill(s, set, block_address, is_fetch, way))
   {
-    // update LRU ordering
-    unsigned int last_index_changed;
+    // update the replacement state
     if (cache_hit)
-      last_index_changed = tag_index;
-    else
-      last_index_changed = Associativity-1;
-
-    // no update on cache hit for FIFO
-    if (LRU_REPLACEMENT || ! cache_hit)
     {
-      for(unsigned int i = last_index_changed; i != 0; i--)
-      {
-	tags[i] = tags[i -1];
-      }
-
-      // set tag information
-      tags[0].Is_valid = 1;
-      tags[0].Block_address = block_address;
+      Replacement.access(set, way);
+      hit_prefetched(set, way, is_fetch);
     }
 
-    // actually read data from memory without stalling
-    // TODO we should keep the data in the cache and read it from
-    // there to detect consistency problems with multi-cores.
-    Memory.read_peek(s, address, value, size, is_fetch);
+    // only write-back lines may differ from the memory, other lines might
+    // miss stores bypassing the cache.
+    if (Write_policy == WP_BACK)
+    {
+      const byte_t *data = get_line(set, way) + (address - block_address);
+      std::copy(data, data + size, value);
+    }
+    else
+    {
+      Memory.read_peek(s, address, value, size, is_fetch);
+    }
 
     // update statistics
     if (cache_hit)
@@ -176,99 +402,266 @@ read(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch
   return false;
 }
 
-template<bool LRU_REPLACEMENT>
-bool set_assoc_data_cache_t<LRU_REPLACEMENT>::
+template<typename REPLACEMENT>
+bool set_assoc_data_cache_t<REPLACEMENT>::
      write(simulator_t &s, uword_t address, byte_t *value, uword_t size)
 {
   // get block address
   unsigned int block_address = get_block_address(address, size);
 
-  // read block data to simulate a block-based write
-  byte_t buf[Num_block_bytes];
-  Memory.read_peek(s, block_address, buf, Num_block_bytes, false);
+  // check if content is in the cache
+  unsigned int set = get_set(block_address);
+  unsigned int way = Tags.find(set, block_address);
+  bool cache_hit = (way < Associativity) && !Is_write_allocated;
 
-  if (Memory.write(s, block_address, buf, Num_block_bytes))
+  // allocate a line on a write miss
+  if (way == Associativity && Is_write_allocate)
   {
-    // get tag information
-    unsigned int entry_index = (block_address / Num_block_bytes)
-			       % Num_indexes;
-    cache_tags_t &tags(Content[entry_index]);
+    if (!fill(s, set, block_address, false, way))
+    {
+      Is_busy = true;
+      Num_stall_cycles++;
+      return false;
+    }
+
+    Num_allocations++;
+    Is_write_allocated = true;
+  }
+  else if (cache_hit)
+  {
+    hit_prefetched(set, way, false);
+  }
 
-    // check if content is in the cache
-    unsigned int tag_index = Associativity;
-    for(unsigned int i = 0; i < Associativity; i++)
+  if (Write_policy == WP_THROUGH || way == Associativity)
+  {
+    // read block data to simulate a block-based write
+    byte_t buf[Num_block_bytes];
+    Memory.read_peek(s, block_address, buf, Num_block_bytes, false);
+
+    if (!Memory.write(s, block_address, buf, Num_block_bytes))
     {
-      if (tags[i].Is_valid && tags[i].Block_address == block_address)
-      {
-	tag_index = i;
-	break;
-      }
+      Is_busy = true;
+      Num_stall_cycles++;
+      return false;
     }
 
-    // No write allocate; contents of cache is updated on write-hit,
-    // but as the simulator implementation does not store contents in
-    // the cache, we simply omit cache updates for the write-through D$
+    // actually write the data, to the memory and all copies in the cache
+    write_peek(s, address, value, size);
+    Num_write_throughs++;
+  }
+  else
+  {
+    // keep the data in the cache only
+    std::copy(value, value + size,
+              get_line(set, way) + (address - block_address));
+    Is_dirty[set * Associativity + way] = true;
+
+    // update the replacement state
+    Replacement.access(set, way);
+  }
 
-    bool cache_hit = (tag_index < Associativity);
+  // update statistics
+  if (cache_hit)
+  {
+    Num_write_hits++;
+    Num_write_hit_bytes += size;
+  }
+  else
+  {
+    Num_write_misses++;
+    Num_write_miss_bytes += size;
+  }
 
-    // update statistics
-    if (cache_hit)
+  Is_write_allocated = false;
+  Is_busy = false;
+  return true;
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
+read_peek(simulator_t &s, uword_t address, byte_t *value, uword_t size,
+          bool is_fetch)
+{
+  Memory.read_peek(s, address, value, size, is_fetch);
+
+  if (Write_policy != WP_BACK)
+    return;
+
+  // take the data of cached blocks from the cache
+  for(uword_t offset = 0; offset < size; )
+  {
+    uword_t block_address = ((address + offset) / Num_block_bytes) *
+                            Num_block_bytes;
+    uword_t block_offset = address + offset - block_address;
+    uword_t count = std::min(size - offset, Num_block_bytes - block_offset);
+
+    unsigned int set = get_set(block_address);
+    unsigned int way = Tags.find(set, block_address);
+    unsigned int v = find_victim(block_address);
+    if (way < Associativity)
     {
-      Num_write_hits++;
-      Num_write_hit_bytes += size;
+      const byte_t *data = get_line(set, way) + block_offset;
+      std::copy(data, data + count, value + offset);
     }
-    else
+    else if (v < Victims.size())
     {
-      Num_write_misses++;
-      Num_write_miss_bytes += size;
+      const byte_t *data = &Victim_data[v * Num_block_bytes] + block_offset;
+      std::copy(data, data + count, value + offset);
     }
-    // actually write the data
-    Memory.write_peek(s, address, value, size);
 
-    Is_busy = false;
-    return true;
+    offset += count;
   }
-  else {
-    Is_busy = true;
-    Num_stall_cycles++;
-    return false;
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
+write_peek(simulator_t &s, uword_t address, byte_t *value, uword_t size)
+{
+  Memory.write_peek(s, address, value, size);
+
+  // keep cached blocks consistent with the memory
+  for(uword_t offset = 0; offset < size; )
+  {
+    uword_t block_address = ((address + offset) / Num_block_bytes) *
+                            Num_block_bytes;
+    uword_t block_offset = address + offset - block_address;
+    uword_t count = std::min(size - offset, Num_block_bytes - block_offset);
+
+    unsigned int set = get_set(block_address);
+    unsigned int way = Tags.find(set, block_address);
+    unsigned int v = find_victim(block_address);
+    if (way < Associativity)
+    {
+      std::copy(value + offset, value + offset + count,
+                get_line(set, way) + block_offset);
+    }
+    else if (v < Victims.size())
+    {
+      std::copy(value + offset, value + offset + count,
+                &Victim_data[v * Num_block_bytes] + block_offset);
+    }
+
+    offset += count;
   }
 }
 
-template<bool LRU_REPLACEMENT>
-bool set_assoc_data_cache_t<LRU_REPLACEMENT>::is_ready()
+template<typename REPLACEMENT>
+bool set_assoc_data_cache_t<REPLACEMENT>::is_ready()
 {
   return !Is_busy;
 }
 
-template<bool LRU_REPLACEMENT>
-void set_assoc_data_cache_t<LRU_REPLACEMENT>::
-     print(const simulator_t &s, std::ostream &os) const
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::tick(simulator_t &s)
 {
-  for(unsigned int i = 0; i < Num_indexes; i++)
+  // issue the next prefetch while the memory is idle
+  while (!Is_busy && !Is_prefetching && !Prefetch_queue.empty() &&
+         Memory.is_ready())
   {
-    bool is_empty = true;
-    for(unsigned int j = 0; j < Associativity; j++)
+    uword_t block_address = Prefetch_queue.front();
+    Prefetch_queue.pop_front();
+
+    if (Tags.find(get_set(block_address), block_address) == Associativity &&
+        find_victim(block_address) == Victims.size())
     {
-      if (Content[i][j].Is_valid)
-      {
-	if (is_empty)
-	  os << boost::format("%1$03d:") % i;
+      Is_prefetching = true;
+      Is_prefetch_late = false;
+      Prefetch_address = block_address;
+      Num_prefetches++;
+    }
+  }
 
-	os << boost::format("  %1$08x") % Content[i][j].Block_address;
-	is_empty = false;
+  if (Is_prefetching)
+  {
+    try
+    {
+      if (Memory.read(s, Prefetch_address, &Prefetch_data[0], Num_block_bytes,
+                      Is_prefetch_fetch))
+      {
+        Is_prefetching = false;
+        install_prefetch(s);
       }
     }
+    catch (simulation_exception_t &)
+    {
+      // prefetches beyond the memory are silently dropped
+      Is_prefetching = false;
+      Num_dropped_prefetches++;
+    }
+  }
+}
+
+template<typename REPLACEMENT>
+uint64_t set_assoc_data_cache_t<REPLACEMENT>::get_idle_cycles(simulator_t &s)
+{
+  // a pending prefetch is polled in the cycle the memory completes it
+  if (Is_prefetching)
+  {
+    uint64_t cycles = Memory.get_idle_cycles(s);
+    return cycles ? cycles - 1 : 0;
+  }
+
+  // a prefetch can be issued or a stalled access waiting for a prefetch
+  // continues
+  if (Memory.is_ready() && (Is_busy || !Prefetch_queue.empty()))
+    return 0;
+
+  return std::numeric_limits<uint64_t>::max();
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::skip_cycles(simulator_t &s,
+                                                          uint64_t cycles)
+{
+  // the stalled access would count a stall cycle in each skipped cycle
+  if (Is_busy)
+    Num_stall_cycles += cycles;
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
+     print(const simulator_t &s, std::ostream &os) const
+{
+  std::vector<unsigned int> ways;
+  for(unsigned int i = 0; i < Num_indexes; i++)
+  {
+    // print the ways from the most recently used one
+    Tags.get_valid_ways(i, ways);
+    Replacement.order(i, ways);
+    if (ways.empty())
+      continue;
+
+    os << boost::format("%1$03d:") % i;
+    for(unsigned int j : ways)
+    {
+      os << boost::format("  %1$08x%2%") % Tags.tag(i, j)
+         % (Is_dirty[i * Associativity + j] ? "*" : "");
+    }
+    os << "\n";
+  }
+
+  // the victim buffer
+  bool is_empty = true;
+  for(const victim_line_t &v : Victims)
+  {
+    if (v.Is_valid)
+    {
+      if (is_empty)
+        os << "vic:";
 
-    if (!is_empty)
-      os << "\n";
+      os << boost::format("  %1$08x%2%") % v.Block_address
+         % (v.Is_dirty ? "*" : "");
+      is_empty = false;
+    }
   }
+  if (!is_empty)
+    os << "\n";
 
   os << "\n";
 }
 
-template<bool LRU_REPLACEMENT>
-void set_assoc_data_cache_t<LRU_REPLACEMENT>::
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
      print_stats(const simulator_t &s, std::ostream &os,
                  const stats_options_t& options)
 {
@@ -318,10 +711,78 @@ void set_assoc_data_cache_t<LRU_REPLACEMENT>::
     % total_writes % Num_write_hits % Num_write_misses % write_miss_rate
     % total_write_bytes % Num_write_hit_bytes % Num_write_miss_bytes
     % write_reuse;
+
+  unsigned int total_accesses = total_reads + total_writes;
+  float hit_rate = total_accesses == 0 ? 0 :
+                   (float)(Num_read_hits + Num_write_hits) /
+                   (float)total_accesses;
+
+  os << boost::format("\n"
+                      "   Replacement      : %1%\n"
+                      "   Evictions        : %2$10d\n"
+                      "   Hit Rate         : %3$10.2f%%\n")
+    % REPLACEMENT::name() % Num_evictions % (hit_rate * 100.0);
+
+  if (Write_policy != WP_THROUGH || Is_write_allocate)
+  {
+    // Traffic between the cache and the memory caused by the write policy.
+    unsigned int num_fetches = Num_read_misses + Num_allocations -
+                               Num_victim_hits;
+
+    os << boost::format("\n"
+                        "   Write Policy     : %1%, %2%\n"
+                        "   Allocations      : %3$10d\n"
+                        "   Write Backs      : %4$10d\n"
+                        "   Write Throughs   : %5$10d\n"
+                        "   Bytes Fetched    : %6$10d\n"
+                        "   Bytes Stored     : %7$10d\n")
+      % (Write_policy == WP_BACK ? "write-back" : "write-through")
+      % (Is_write_allocate ? "write-allocate" : "no-write-allocate")
+      % Num_allocations % Num_write_backs % Num_write_throughs
+      % (num_fetches * Num_block_bytes)
+      % ((Num_write_backs + Num_write_throughs) * Num_block_bytes);
+  }
+
+  if (!Victims.empty())
+  {
+    unsigned int num_misses = Num_read_misses + Num_allocations;
+    float victim_hit_rate = num_misses == 0 ? 0 :
+                            (float)Num_victim_hits / (float)num_misses;
+
+    os << boost::format("\n"
+                        "   Victim Lines     : %1$10d\n"
+                        "   Victim Hits      : %2$10d  %3$10.2f%%\n")
+      % Victims.size() % Num_victim_hits % (victim_hit_rate * 100.0);
+  }
+
+  if (Prefetch.kind != PF_NO)
+  {
+    // Accurate prefetches are used, possibly too late; covered misses are
+    // the accesses to prefetched lines among all misses and those accesses.
+    unsigned int num_accurate = Num_useful_prefetches + Num_late_prefetches;
+    float accuracy = Num_prefetches == 0 ? 0 :
+                     (float)num_accurate / (float)Num_prefetches;
+    unsigned int num_misses = Num_read_misses + Num_allocations +
+                              Num_useful_prefetches;
+    float coverage = num_misses == 0 ? 0 :
+                     (float)Num_useful_prefetches / (float)num_misses;
+
+    os << boost::format("\n"
+                        "   Prefetcher       : %1%\n"
+                        "   Prefetches       : %2$10d\n"
+                        "   Useful           : %3$10d\n"
+                        "   Late             : %4$10d\n"
+                        "   Dropped          : %5$10d\n"
+                        "   Accuracy         : %6$10.2f%%\n"
+                        "   Coverage         : %7$10.2f%%\n")
+      % Prefetch % Num_prefetches % Num_useful_prefetches
+      % Num_late_prefetches % Num_dropped_prefetches
+      % (accuracy * 100.0) % (coverage * 100.0);
+  }
 }
 
-template<bool LRU_REPLACEMENT>
-void set_assoc_data_cache_t<LRU_REPLACEMENT>::reset_stats()
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::reset_stats()
 {
   Num_stall_cycles = 0;
   Num_read_hits = 0;
@@ -332,22 +793,172 @@ void set_assoc_data_cache_t<LRU_REPLACEMENT>::reset_stats()
   Num_write_misses = 0;
   Num_write_hit_bytes = 0;
   Num_write_miss_bytes = 0;
+  Num_allocations = 0;
+  Num_write_backs = 0;
+  Num_write_throughs = 0;
+  Num_evictions = 0;
+  Num_victim_hits = 0;
+  Num_prefetches = 0;
+  Num_useful_prefetches = 0;
+  Num_late_prefetches = 0;
+  Num_dropped_prefetches = 0;
 }
 
-template<bool LRU_REPLACEMENT>
-void set_assoc_data_cache_t<LRU_REPLACEMENT>::flush_cache()
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::add_counters(stats_counters_t &counters)
 {
+  counters.add("read_hits", Num_read_hits);
+  counters.add("read_misses", Num_read_misses);
+  counters.add("read_hit_bytes", Num_read_hit_bytes);
+  counters.add("read_miss_bytes", Num_read_miss_bytes);
+  counters.add("write_hits", Num_write_hits);
+  counters.add("write_misses", Num_write_misses);
+  counters.add("write_hit_bytes", Num_write_hit_bytes);
+  counters.add("write_miss_bytes", Num_write_miss_bytes);
+  counters.add("evictions", Num_evictions);
+  counters.add("allocations", Num_allocations);
+  counters.add("write_backs", Num_write_backs);
+  counters.add("write_throughs", Num_write_throughs);
+  counters.add("victim_hits", Num_victim_hits);
+  counters.add("prefetches", Num_prefetches);
+  counters.add("useful_prefetches", Num_useful_prefetches);
+  counters.add("late_prefetches", Num_late_prefetches);
+  counters.add("dropped_prefetches", Num_dropped_prefetches);
+  counters.add("stall_cycles", Num_stall_cycles);
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::flush_cache(simulator_t &s)
+{
+  // write back dirty data, without simulating timing
   for(unsigned int i = 0; i < Num_indexes; i++)
   {
     for(unsigned int j = 0; j < Associativity; j++)
     {
-      Content[i][j].Is_valid = false;
+      if (Is_dirty[i * Associativity + j])
+      {
+        Memory.write_peek(s, Tags.tag(i, j), get_line(i, j), Num_block_bytes);
+        Is_dirty[i * Associativity + j] = false;
+      }
+    }
+  }
+
+  for(unsigned int i = 0; i < Victims.size(); i++)
+  {
+    if (Victims[i].Is_valid && Victims[i].Is_dirty)
+    {
+      Memory.write_peek(s, Victims[i].Block_address,
+                        &Victim_data[i * Num_block_bytes], Num_block_bytes);
     }
+    Victims[i].Is_valid = false;
+    Victims[i].Is_dirty = false;
+  }
+
+  Tags.invalidate();
+  Replacement.invalidate();
+  std::fill(Is_prefetched.begin(), Is_prefetched.end(), false);
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
+save_state(checkpoint_writer_t &cw) const
+{
+  cw.write_config(Num_blocks);
+  cw.write_config(Num_block_bytes);
+  cw.write_config(Associativity);
+  cw.write_config(Write_policy);
+  cw.write_config(Is_write_allocate);
+  cw.write_config(Victims.size());
+  cw.write_config(Prefetch.kind);
+  cw.write_config(Prefetch.degree);
+
+  cw.write(Is_busy);
+  cw.write(Is_write_allocated);
+  Tags.save_state(cw);
+  Replacement.save_state(cw);
+  for(unsigned int i = 0; i < Num_blocks; i++)
+  {
+    cw.write((bool)Is_dirty[i]);
+    cw.write((bool)Is_prefetched[i]);
+  }
+  cw.write(Line_data, Num_blocks * Num_block_bytes);
+
+  for(const victim_line_t &v : Victims)
+  {
+    cw.write(v);
+  }
+  cw.write(Victim_data.data(), Victim_data.size());
+  cw.write(Victim_next);
+
+  cw.write((uint64_t)Prefetch_queue.size());
+  for(uword_t address : Prefetch_queue)
+  {
+    cw.write(address);
+  }
+  cw.write(Is_prefetching);
+  cw.write(Is_prefetch_fetch);
+  cw.write(Is_prefetch_late);
+  cw.write(Prefetch_address);
+  cw.write(Last_trigger_address);
+  cw.write(Last_stride);
+}
+
+template<typename REPLACEMENT>
+void set_assoc_data_cache_t<REPLACEMENT>::
+restore_state(checkpoint_reader_t &cr)
+{
+  cr.check_config(Num_blocks, "data cache size");
+  cr.check_config(Num_block_bytes, "data cache block size");
+  cr.check_config(Associativity, "data cache associativity");
+  cr.check_config(Write_policy, "data cache write policy");
+  cr.check_config(Is_write_allocate, "data cache write allocation");
+  cr.check_config(Victims.size(), "data cache victim buffer size");
+  cr.check_config(Prefetch.kind, "data cache prefetcher");
+  cr.check_config(Prefetch.degree, "data cache prefetch degree");
+
+  cr.read(Is_busy);
+  cr.read(Is_write_allocated);
+  Tags.restore_state(cr);
+  Replacement.restore_state(cr);
+  for(unsigned int i = 0; i < Num_blocks; i++)
+  {
+    bool is_dirty, is_prefetched;
+    cr.read(is_dirty);
+    cr.read(is_prefetched);
+    Is_dirty[i] = is_dirty;
+    Is_prefetched[i] = is_prefetched;
+  }
+  cr.read(Line_data, Num_blocks * Num_block_bytes);
+
+  for(victim_line_t &v : Victims)
+  {
+    cr.read(v);
+  }
+  cr.read(Victim_data.data(), Victim_data.size());
+  cr.read(Victim_next);
+
+  uint64_t num_prefetches;
+  cr.read(num_prefetches);
+  Prefetch_queue.resize(num_prefetches);
+  for(uword_t &address : Prefetch_queue)
+  {
+    cr.read(address);
   }
+  cr.read(Is_prefetching);
+  cr.read(Is_prefetch_fetch);
+  cr.read(Is_prefetch_late);
+  cr.read(Prefetch_address);
+  cr.read(Last_trigger_address);
+  cr.read(Last_stride);
 }
 
 namespace patmos {
   // Explicit instantiation of template class for linking.
-  template class set_assoc_data_cache_t<false>;
-  template class set_assoc_data_cache_t<true>;
+  template class set_assoc_data_cache_t<lru_replacement_t>;
+  template class set_assoc_data_cache_t<fifo_replacement_t>;
+  template class set_assoc_data_cache_t<tree_plru_replacement_t>;
+  template class set_assoc_data_cache_t<bit_plru_replacement_t>;
+  template class set_assoc_data_cache_t<random_replacement_t>;
+  template class set_assoc_data_cache_t<srrip_replacement_t>;
+  template class set_assoc_data_cache_t<brrip_replacement_t>;
 }
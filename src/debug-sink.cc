@@ -0,0 +1,311 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Writing the debug output from a background thread.
+//
+
+#include "debug-sink.h"
+#include "registers.h"
+#include "symbol.h"
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace patmos
+{
+  void print_debug_header(std::ostream &os, uint64_t cycle, uword_t pc,
+                          uword_t base, unsigned int prr, bool nopc,
+                          const symbol_map_t &symbols)
+  {
+    if (!nopc) {
+      os << boost::format("\nCyc : %1%\n PRR: ") % cycle;
+    } else {
+      os << "PRR: ";
+    }
+
+    for(int p = NUM_PRR - 1; p >= 0; p--)
+    {
+      os << ((prr >> p) & 1);
+    }
+
+    if (!nopc) {
+      os << boost::format("  BASE: %1$08x   PC : %2$08x   ") % base % pc;
+
+      symbols.print(os, pc);
+    }
+  }
+
+  void print_debug_registers(std::ostream &os, char prefix,
+                             unsigned int first, const word_t *values,
+                             unsigned int count, bool is_short)
+  {
+    // avoid boost::format, the register dump is printed in every cycle
+    for(unsigned int i = 0; i < count; i++)
+    {
+      unsigned int r = first + i;
+
+      if (is_short)
+      {
+        os << ' ';
+      }
+
+      os << prefix << std::left << std::setw(2) << r << std::right << ": "
+         << std::hex << std::setw(8) << std::setfill('0') << (uword_t)values[i]
+         << std::dec << std::setfill(' ');
+
+      if (!is_short)
+      {
+        if ((r & 0x7) == 7)
+        {
+          os << "\n ";
+        }
+        else
+        {
+          os << "   ";
+        }
+      }
+    }
+  }
+
+  void print_debug_block(std::ostream &os, uword_t pc, uint64_t cycle,
+                         bool nopc, const symbol_map_t &symbols)
+  {
+    if (!nopc) {
+      os << boost::format("%1$08x %2$9d ") % pc % cycle;
+    }
+    symbols.print(os, pc);
+    os << "\n";
+  }
+
+  void print_debug_call(std::ostream &os, debug_call_e kind, uword_t pc,
+                        uint64_t cycle, unsigned int indent, bool nd,
+                        uword_t from, uword_t to, bool nopc,
+                        const symbol_map_t &symbols)
+  {
+    if (!nopc) {
+      os << boost::format("%1$08x %2$9d ") % pc % cycle;
+    }
+
+    for (unsigned i = 0; i < indent; i++) {
+      os << "  ";
+    }
+    os << (kind == DC_INTERRUPT ? "interrupt" :
+                                  (kind == DC_CALL ? "call" : "return"));
+    if (nd) os << " (nd)";
+    os << " from ";
+    symbols.print(os, from, true);
+    os << " to ";
+    symbols.print(os, to, true);
+  }
+
+  void print_debug_call_values(std::ostream &os, bool is_call,
+                               const word_t *values)
+  {
+    if (is_call) {
+      os << " args: " << boost::format("r3 = %1$08x, r4 = %2$08x, ")
+            % values[0] % values[1];
+      os << boost::format("r5 = %1$08x, r6 = %2$08x, r7 = %3$08x, r8 = %4$08x")
+            % values[2] % values[3] % values[4] % values[5];
+    } else {
+      os << " retval: " << boost::format("r1 = %1$08x, r2 = %2$08x")
+            % values[0] % values[1];
+    }
+  }
+
+  debug_sink_t::debug_sink_t(std::ostream &stream)
+    : Stream(stream), Events(DEBUG_SINK_EVENTS), Head(0), Tail(0),
+      Cached_tail(0), Is_done(false), Is_failed(false), Trace_writer(NULL),
+      Num_events(0), Num_stalls(0)
+  {
+    setp(Pending, Pending + DEBUG_EVENT_TEXT);
+    Writer = std::thread(&debug_sink_t::write_events, this);
+  }
+
+  debug_sink_t::~debug_sink_t()
+  {
+    push_text();
+
+    Is_done.store(true, std::memory_order_release);
+    Writer.join();
+  }
+
+  void debug_sink_t::wait_for_space()
+  {
+    Num_stalls++;
+
+    uint64_t head = Head.load(std::memory_order_relaxed);
+    do
+    {
+      std::this_thread::yield();
+      Cached_tail = Tail.load(std::memory_order_acquire);
+    } while (head - Cached_tail == Events.size());
+  }
+
+  void debug_sink_t::push_text()
+  {
+    if (pptr() == pbase())
+      return;
+
+    debug_event_t &e = next_event();
+    e.Kind = debug_event_t::TEXT;
+    e.Size = pptr() - pbase();
+    std::memcpy(e.Text, Pending, e.Size);
+    push();
+
+    setp(Pending, Pending + DEBUG_EVENT_TEXT);
+  }
+
+  debug_sink_t::int_type debug_sink_t::overflow(int_type c)
+  {
+    push_text();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+
+    return traits_type::not_eof(c);
+  }
+
+  int debug_sink_t::sync()
+  {
+    push_text();
+    return 0;
+  }
+
+  void debug_sink_t::write_event(const debug_event_t &e)
+  {
+    switch (e.Kind)
+    {
+      case debug_event_t::TEXT:
+        Stream.write(e.Text, e.Size);
+        break;
+      case debug_event_t::TRACE:
+        print_trace_record(Stream, e.Address, e.Cycle, e.Count);
+        break;
+      case debug_event_t::BTRACE:
+        if (!Trace_writer)
+          Trace_writer = new trace_writer_t(Stream);
+        Trace_writer->write(e.Address, e.Cycle, e.Count);
+        break;
+      case debug_event_t::HEADER:
+        print_debug_header(Stream, e.Cycle, e.Address, e.Count, e.Values[0],
+                           e.Flags & debug_event_t::NOPC, *e.Symbols);
+        break;
+      case debug_event_t::REGISTERS:
+        print_debug_registers(Stream, e.Prefix, e.Address, e.Values, e.Size,
+                              e.Flags & debug_event_t::SHORT);
+        break;
+      case debug_event_t::BLOCK:
+        print_debug_block(Stream, e.Address, e.Cycle,
+                          e.Flags & debug_event_t::NOPC, *e.Symbols);
+        break;
+      case debug_event_t::CALL:
+        print_debug_call(Stream, (debug_call_e)e.Size, e.Values[1], e.Cycle,
+                         e.Count, e.Flags & debug_event_t::ND, e.Address,
+                         e.Values[0], e.Flags & debug_event_t::NOPC,
+                         *e.Symbols);
+        break;
+      case debug_event_t::CALL_VALUES:
+        print_debug_call_values(Stream, e.Flags, e.Values);
+        break;
+    }
+  }
+
+  void debug_sink_t::write_events()
+  {
+    uint64_t tail = Tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+      uint64_t head = Head.load(std::memory_order_acquire);
+      if (tail == head)
+      {
+        // the simulation may have written some last events before it set
+        // the flag
+        if (Is_done.load(std::memory_order_acquire))
+        {
+          if (Head.load(std::memory_order_acquire) == tail)
+            break;
+          continue;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        continue;
+      }
+
+      // process the events in batches, such that the simulation can reuse
+      // the first events early
+      head = std::min(head, tail + DEBUG_SINK_EVENTS / 16);
+      for(; tail != head; tail++)
+      {
+        if (Is_failed)
+          continue;
+
+        try
+        {
+          write_event(Events[tail & (Events.size() - 1)]);
+        }
+        catch (const std::ios_base::failure &f)
+        {
+          std::cerr << f.what() << "\n";
+          Is_failed = true;
+        }
+      }
+      Tail.store(tail, std::memory_order_release);
+    }
+
+    try
+    {
+      if (Trace_writer && !Is_failed)
+        Trace_writer->flush();
+    }
+    catch (const std::ios_base::failure &f)
+    {
+      std::cerr << f.what() << "\n";
+    }
+    delete Trace_writer;
+    Stream.flush();
+  }
+
+  void debug_sink_t::print_stats(std::ostream &os) const
+  {
+    os << boost::format("\nDebug Output:\n   Events: %1%\n   Stalls: %2%\n")
+       % Num_events % Num_stalls;
+  }
+}
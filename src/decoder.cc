@@ -44,17 +44,99 @@
 #include "exception.h"
 
 #include <algorithm>
+#include <mutex>
 
 namespace patmos
 {
+  /// An entry of the decode cache, holding a decoded bundle along with the
+  /// raw instruction words it was decoded from.
+  class decode_cache_entry_t
+  {
+  public:
+    /// Flag indicating whether the entry holds a decoded bundle.
+    bool Is_valid;
+
+    /// Address of the decoded bundle.
+    uword_t Address;
+
+    /// Raw (big-endian) instruction words of the bundle.
+    word_t IW[NUM_SLOTS];
+
+    /// Number of words occupied by the bundle.
+    unsigned int Size;
+
+    /// The decoded instructions of the bundle.
+    instruction_data_t Result[NUM_SLOTS];
+
+    decode_cache_entry_t() : Is_valid(false), Address(0), Size(0)
+    {
+    }
+  };
+
+  /// Simulation functions of an instruction class, calling the pipeline
+  /// functions of the class directly, so that the compiler may inline them.
+  template<typename INSTR>
+  struct bound_stages_t
+  {
+    static void DR(simulator_t &s, instruction_data_t &ops)
+    {
+      static_cast<const INSTR*>(ops.I)->INSTR::DR(s, ops);
+    }
+
+    static void EX(simulator_t &s, instruction_data_t &ops)
+    {
+      static_cast<const INSTR*>(ops.I)->INSTR::EX(s, ops);
+    }
+
+    static void MW(simulator_t &s, instruction_data_t &ops)
+    {
+      static_cast<const INSTR*>(ops.I)->INSTR::MW(s, ops);
+    }
+
+    static stage_functions_t get()
+    {
+      stage_functions_t result = { &DR, &EX, &MW };
+      return result;
+    }
+  };
+
+  /// Create a new instance of an instruction class.
+  template<typename INSTR>
+  static instruction_t *create_instance()
+  {
+    return new INSTR();
+  }
+
+  /// Simulation functions of the invalid instruction.
+  static const stage_functions_t Invalid_stage_functions =
+                                            bound_stages_t<i_invalid_t>::get();
+
   decoder_t::instructions_t decoder_t::Instructions;
 
+  std::vector<stage_functions_t> decoder_t::Stage_functions;
+
+  std::vector<instruction_t *(*)()> decoder_t::Instruction_factories;
+
+  decoder_t::formats_t decoder_t::Decode_table[1 << DECODE_TABLE_BITS];
+
   int decoder_t::NOP_ID;
 
+  /// Guards the initialization of the instructions, simulators might be
+  /// constructed concurrently.
+  static std::once_flag Instructions_initialized;
+
   decoder_t::decoder_t(bool use_permissive_dual_issue) : Use_permissive_dual_issue(use_permissive_dual_issue)
   {
     // initialize the known instructions and binary formats.
-    initialize_instructions();
+    std::call_once(Instructions_initialized,
+                   &decoder_t::initialize_instructions);
+
+    Decode_cache = new decode_cache_entry_t[NUM_DECODE_CACHE_ENTRIES];
+  }
+
+  decoder_t::~decoder_t()
+  {
+    delete [] Decode_cache;
   }
 
   unsigned int decoder_t::decode(word_t iw, word_t imm, unsigned int slot,
@@ -63,11 +145,13 @@ namespace patmos
     bool matched = false;
     bool is_long = false;
 
-    // check all known instructions
-    for(instructions_t::const_iterator i(Instructions.begin()),
-        ie(Instructions.end()); i != ie; i++)
+    // check all instructions that may match the major opcode
+    const formats_t &formats(Decode_table[(iw >> DECODE_TABLE_SHIFT) &
+                                          ((1 << DECODE_TABLE_BITS) - 1)]);
+    for(formats_t::const_iterator i(formats.begin()), ie(formats.end());
+        i != ie; i++)
     {
-      const binary_format_t &fmt = *i->get<1>();
+      const binary_format_t &fmt = **i;
       if (fmt.matches(iw, slot, Use_permissive_dual_issue))
       {
         // ensure that only one instruction type matches.
@@ -146,6 +230,42 @@ namespace patmos
     abort();
   }
 
+  unsigned int decoder_t::decode_cached(uword_t address, word_t *iwp,
+                                        instruction_data_t *result)
+  {
+    decode_cache_entry_t &entry(Decode_cache[(address / sizeof(word_t)) %
+                                             NUM_DECODE_CACHE_ENTRIES]);
+
+    if (!entry.Is_valid || entry.Address != address ||
+        entry.IW[0] != iwp[0] || entry.IW[1] != iwp[1])
+    {
+      entry.Size = decode(iwp, entry.Result, false);
+      entry.Address = address;
+      for(unsigned int i = 0; i < NUM_SLOTS; i++)
+      {
+        entry.Result[i].Address = address + i*sizeof(word_t);
+      }
+      entry.IW[0] = iwp[0];
+      entry.IW[1] = iwp[1];
+      entry.Is_valid = true;
+    }
+
+    for(unsigned int i = 0; i < NUM_SLOTS; i++)
+    {
+      result[i].set_decoded(entry.Result[i]);
+    }
+
+    return entry.Size;
+  }
+
+  void decoder_t::flush_decode_cache()
+  {
+    for(unsigned int i = 0; i < NUM_DECODE_CACHE_ENTRIES; i++)
+    {
+      Decode_cache[i].Is_valid = false;
+    }
+  }
+
   int decoder_t::decode(loader_t &loader, section_info_t &section,
                         symbol_map_t &sym, decoder_callback_t &cb)
   {
@@ -212,6 +332,8 @@ namespace patmos
     itmp->Name = #name;                                                        \
     binary_format_t *ftmp = new format ## _format_t(*itmp, opcode);            \
     Instructions.push_back(boost::make_tuple(itmp, ftmp));                     \
+    Stage_functions.push_back(bound_stages_t<i_ ## name ## _t>::get());        \
+    Instruction_factories.push_back(&create_instance<i_ ## name ## _t>);       \
   }
 
 #define MK_NINSTR(classname, name, format, opcode)                             \
@@ -221,6 +343,8 @@ namespace patmos
     itmp->Name = #name;                                                        \
     binary_format_t *ftmp = new format ## _format_t(*itmp, opcode);            \
     Instructions.push_back(boost::make_tuple(itmp, ftmp));                     \
+    Stage_functions.push_back(bound_stages_t<i_ ## classname ## _t>::get());   \
+    Instruction_factories.push_back(&create_instance<i_ ## classname ## _t>);  \
   }
 
 #define MK_NINSTR_ALIAS(classname, name, format, opcode)
@@ -232,9 +356,27 @@ namespace patmos
     itmp->Name = #name;                                                        \
     binary_format_t *ftmp = new format ## _format_t(*itmp, opcode, flag);      \
     Instructions.push_back(boost::make_tuple(itmp, ftmp));                     \
+    Stage_functions.push_back(bound_stages_t<i_ ## classname ## _t>::get());   \
+    Instruction_factories.push_back(&create_instance<i_ ## classname ## _t>);  \
   }
 
 #include "instructions.inc"
+
+    // sort the binary formats into the decoding table, a format may appear in
+    // several entries if it does not constrain all major opcode bits.
+    const word_t mask = ((1 << DECODE_TABLE_BITS) - 1) << DECODE_TABLE_SHIFT;
+    for(unsigned int b = 0; b < (1 << DECODE_TABLE_BITS); b++)
+    {
+      for(instructions_t::const_iterator i(Instructions.begin()),
+          ie(Instructions.end()); i != ie; i++)
+      {
+        const binary_format_t *fmt = i->get<1>();
+        if (fmt->may_match(mask, b << DECODE_TABLE_SHIFT))
+        {
+          Decode_table[b].push_back(fmt);
+        }
+      }
+    }
   }
 
   instruction_t &decoder_t::get_instruction(int ID)
@@ -243,5 +385,22 @@ namespace patmos
     assert(result && result->ID == ID);
     return *result;
   }
+
+  const stage_functions_t &decoder_t::get_stage_functions(const instruction_t &I)
+  {
+    if (&I == &instruction_data_t::Invalid_Instr)
+      return Invalid_stage_functions;
+
+    assert(I.ID >= 0 && I.ID < (int)Stage_functions.size());
+    return Stage_functions[I.ID];
+  }
+
+  instruction_t *decoder_t::create_instruction(int ID)
+  {
+    instruction_t *result = Instruction_factories[ID]();
+    result->ID = ID;
+    result->Name = get_instruction(ID).Name;
+    return result;
+  }
 }
 
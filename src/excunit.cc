@@ -35,6 +35,7 @@
 //
 
 #include "excunit.h"
+#include "checkpoint.h"
 
 #include "simulation-core.h"
 #include "exception.h"
@@ -199,10 +200,10 @@ namespace patmos
     else if (is_word_access(address, size, 0x14)) {
       word_t Flags = get_word(value, size);
       if (Flags & 0x01) {
-        s.Data_cache.flush_cache();
+        s.Data_cache.flush_cache(s);
       }
       if (Flags & 0x02) {
-        s.Instr_cache.flush_cache();
+        s.Instr_cache.flush_cache(s);
       }
     }
     else if (address >= Base_address+0x80 && address < Base_address+0x100) {
@@ -220,6 +221,24 @@ namespace patmos
     return true;
   }
 
+  void excunit_t::save_state(checkpoint_writer_t &cw) const
+  {
+    cw.write(Status);
+    cw.write(Mask);
+    cw.write(Pending);
+    cw.write(Source);
+    cw.write(Exception_vector);
+  }
+
+  void excunit_t::restore_state(checkpoint_reader_t &cr)
+  {
+    cr.read(Status);
+    cr.read(Mask);
+    cr.read(Pending);
+    cr.read(Source);
+    cr.read(Exception_vector);
+  }
+
   void excunit_t::tick(simulator_t &s)
   {
   }
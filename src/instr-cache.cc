@@ -35,6 +35,7 @@
 //
 #include "instr-cache.h"
 
+#include "checkpoint.h"
 #include "memory.h"
 #include "exception.h"
 #include "simulation-core.h"
@@ -128,3 +129,19 @@ void no_instr_cache_t::reset_stats() {
   Num_hits = 0;
 }
 
+void no_instr_cache_t::save_state(checkpoint_writer_t &cw) const {
+  cw.write(Fetched);
+  for (unsigned int i = 0; i < NUM_SLOTS; i++) {
+    cw.write(Fetch_cache[i]);
+    cw.write(Is_miss[i]);
+  }
+}
+
+void no_instr_cache_t::restore_state(checkpoint_reader_t &cr) {
+  cr.read(Fetched);
+  for (unsigned int i = 0; i < NUM_SLOTS; i++) {
+    cr.read(Fetch_cache[i]);
+    cr.read(Is_miss[i]);
+  }
+}
+
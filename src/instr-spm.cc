@@ -38,6 +38,7 @@
 #include "memory.h"
 #include "exception.h"
 #include "simulation-core.h"
+#include "stats-counters.h"
 
 #include <cmath>
 #include <ostream>
@@ -113,11 +114,17 @@ void instr_spm_t::reset_stats()
   Cache->reset_stats();
 }
 
-void instr_spm_t::flush_cache()
+void instr_spm_t::add_counters(stats_counters_t &counters)
+{
+  counters.add("spm_loads", Num_loads);
+  Cache->add_counters(counters);
+}
+
+void instr_spm_t::flush_cache(simulator_t &s)
 {
   // Note: we do not want to flush the I-SPM here (if we would Implement
   // the SPM as a local buffer), otherwise flushing the I$ through the
   // control-bits would also flush the I-SPM.
 
-  Cache->flush_cache();
+  Cache->flush_cache(s);
 }
@@ -35,15 +35,23 @@
 //
 
 #include "memory-map.h"
+#include "checkpoint.h"
 #include "excunit.h"
 #include "simulation-core.h"
 #include "endian-conversion.h"
 
+#include <algorithm>
 #include <vector>
 #include <ostream>
 
 using namespace patmos;
 
+void mapped_device_t::update_ticked() {
+  if (Map) {
+    Map->update_ticked();
+  }
+}
+
 bool mapped_device_t::is_word_access(uword_t address, uword_t size, uword_t offset) {
   // TODO optionally check for half/byte access (?)
   return address == Base_address + offset && size == 4;
@@ -89,31 +97,53 @@ void cpuinfo_t::peek(simulator_t &s, uword_t address, byte_t *value, uword_t siz
   }
 }
 
+void perfcounters_t::attach(simulator_t &s) {
+  // the counters summed up by each register; instruction caches count
+  // either method or line hits, data cache misses include lines fetched on
+  // writes. The simulator has no write combine buffer.
+  static const char *names[NUM_REGISTERS][3] = {
+    {"icache.hits", "icache.read_hits", NULL},       // M-Cache hits
+    {"icache.misses", "icache.read_misses", NULL},   // M-Cache misses
+    {"dcache.read_hits", "dcache.write_hits", NULL}, // D-Cache hits
+    {"dcache.read_misses", "dcache.allocations", NULL}, // D-Cache misses
+    {"scache.blocks_spilled", NULL},  // S-Cache spill transactions
+    {"scache.blocks_filled", NULL},   // S-Cache fill transactions
+    {NULL},                           // Write combine buffer hits
+    {NULL},                           // Write combine buffer misses
+    {"memory.reads", NULL},           // External memory read transaction
+    {"memory.writes", NULL}           // External memory write transaction
+  };
+
+  s.add_counters(Counters);
+
+  for(unsigned int i = 0; i < NUM_REGISTERS; i++) {
+    for(unsigned int j = 0; names[i][j]; j++) {
+      unsigned int index;
+      if (Counters.find(names[i][j], index))
+        Registers[i].push_back(index);
+    }
+  }
+
+  Is_attached = true;
+}
+
 bool perfcounters_t::read(simulator_t &s, uword_t address, byte_t *value, uword_t size) {
-  // TODO: return actual performance statistics
-  if (is_word_access(address, size, 0x00)) {
-    set_word(value, size, 0); // M-Cache hits
-  } else if (is_word_access(address, size, 0x04)) {
-    set_word(value, size, 0); // M-Cache misses
-  } else if (is_word_access(address, size, 0x08)) {
-    set_word(value, size, 0); // D-Cache hits
-  } else if (is_word_access(address, size, 0x0c)) {
-    set_word(value, size, 0); // D-Cache misses
-  } else if (is_word_access(address, size, 0x10)) {
-    set_word(value, size, 0); // S-Cache spill transactions
-  } else if (is_word_access(address, size, 0x14)) {
-    set_word(value, size, 0); // S-Cache fill transactions
-  } else if (is_word_access(address, size, 0x18)) {
-    set_word(value, size, 0); // Write combine buffer hits
-  } else if (is_word_access(address, size, 0x1c)) {
-    set_word(value, size, 0); // Write combine buffer misses
-  } else if (is_word_access(address, size, 0x20)) {
-    set_word(value, size, 0); // External memory read transaction
-  } else if (is_word_access(address, size, 0x24)) {
-    set_word(value, size, 0); // External memory write transaction
-  } else {
+  uword_t offset = address - Base_address;
+
+  if (offset >= Mapped_bytes || !is_word_access(address, size, offset & ~3)) {
     simulation_exception_t::unmapped(address);
   }
+
+  if (!Is_attached)
+    attach(s);
+
+  // sum up the current values, wrapping around as the hardware counters
+  const std::vector<unsigned int> &reg(Registers[offset / 4]);
+  uword_t sum = 0;
+  for(unsigned int i = 0; i < reg.size(); i++) {
+    sum += Counters.value(reg[i]);
+  }
+  set_word(value, size, sum);
   return true;
 }
 
@@ -164,6 +194,14 @@ uword_t mmu_t::xlate(uword_t address, mmu_op_t op) {
   return Segments[index].Base + (address & 0x1fffffff);
 }
 
+void mmu_t::save_state(checkpoint_writer_t &cw) const {
+  cw.write(Segments);
+}
+
+void mmu_t::restore_state(checkpoint_reader_t &cr) {
+  cr.read(Segments);
+}
+
 bool led_t::read(simulator_t &s, uword_t address, byte_t *value, uword_t size) {
   if (is_word_access(address, size, 0x00)) {
     set_word(value, size, Curr_state);
@@ -199,6 +237,14 @@ bool led_t::write(simulator_t &s, uword_t address, byte_t *value, uword_t size)
   }
 }
 
+void led_t::save_state(checkpoint_writer_t &cw) const {
+  cw.write(Curr_state);
+}
+
+void led_t::restore_state(checkpoint_reader_t &cr) {
+  cr.read(Curr_state);
+}
+
 // EthMac simulation works only under Linux
 #ifdef __linux__
 #include <fcntl.h>
@@ -290,14 +336,17 @@ bool ethmac_t::write(simulator_t &s, uword_t address, byte_t *value, uword_t siz
   } else if (is_word_access(address, size, 0xf004)) {
     if (data & 0x4) { rx_ready = false; }
     if (data & 0x1) { tx_ready = false; }
+    update_ticked();
   } else if (is_word_access(address, size, 0xf400)) {
     tx_length = data >> 16;
     tx = (data & 0x8000) != 0;
+    update_ticked();
   } else if (is_word_access(address, size, 0xf404)) {
     tx_addr = data;
   } else if (is_word_access(address, size, 0xf600)) {
     rx_length = data >> 16;
     rx = (data & 0x8000) != 0;
+    update_ticked();
   } else if (is_word_access(address, size, 0xf604)) {
     rx_addr = data;
   } else if (is_word_access(address, size, 0xf040)) {
@@ -322,6 +371,7 @@ void ethmac_t::tick(simulator_t &s) {
     }
     tx = false;
     tx_ready = true;
+    update_ticked();
   }
 
   if (rx && !rx_ready) {
@@ -333,6 +383,7 @@ void ethmac_t::tick(simulator_t &s) {
       if (len > 0) {
         rx = false;
         rx_ready = true;
+        update_ticked();
       } else if (len < 0) {
         std::cerr << "error: Cannot read from tap device" << std::endl;
       }
@@ -341,8 +392,14 @@ void ethmac_t::tick(simulator_t &s) {
 #endif /* __linux__ */
 }
 
+uint64_t ethmac_t::get_idle_cycles(simulator_t &s) {
+  // the tap device might receive packets at any time while a receive is
+  // pending
+  return is_ticked() ? 0 : std::numeric_limits<uint64_t>::max();
+}
+
 /// Map several devices into the address space of another memory device
-mapped_device_t& memory_map_t::find_device(uword_t address)
+mapped_device_t& memory_map_t::find_shared_device(uword_t address)
 {
   for (AddressList::iterator it = Device_map.begin(), ie = Device_map.end();
        it != ie; ++it)
@@ -359,11 +416,28 @@ void memory_map_t::add_device(mapped_device_t &device)
   Devices.push_back(&device);
   Device_map.push_back(std::make_pair(device.get_base_address(),
 				      device.get_base_address() + device.get_num_mapped_bytes() - 1));
+
+  device.Map = this;
+  update_ticked();
+
+  // register the device in the pages of the mapped range it overlaps
+  uword_t first = std::max(Device_map.back().first, Base_address);
+  uword_t last = std::min(Device_map.back().second, High_address);
+  if (first > last) {
+    return;
+  }
+
+  for (uword_t page = (first - Base_address) >> DEVICE_PAGE_BITS,
+       last_page = (last - Base_address) >> DEVICE_PAGE_BITS;
+       page <= last_page; page++)
+  {
+    Device_pages[page] = Device_pages[page] ? SHARED_PAGE : Devices.size();
+  }
 }
 
 bool memory_map_t::read(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch)
 {
-  if (address >= Base_address && address <= High_address) {
+  if (is_mapped(address)) {
     return find_device(address).read(s, address, value, size);
   } else {
     return Memory.read(s, address, value, size, is_fetch);
@@ -372,7 +446,7 @@ bool memory_map_t::read(simulator_t &s, uword_t address, byte_t *value, uword_t
 
 bool memory_map_t::write(simulator_t &s, uword_t address, byte_t *value, uword_t size)
 {
-  if (address >= Base_address && address <= High_address) {
+  if (is_mapped(address)) {
     return find_device(address).write(s, address, value, size);
   } else {
     return Memory.write(s, address, value, size);
@@ -381,7 +455,7 @@ bool memory_map_t::write(simulator_t &s, uword_t address, byte_t *value, uword_t
 
 void memory_map_t::read_peek(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch)
 {
-  if (address >= Base_address && address <= High_address) {
+  if (is_mapped(address)) {
     find_device(address).peek(s, address, value, size);
   } else {
     Memory.read_peek(s, address, value, size, is_fetch);
@@ -391,7 +465,7 @@ void memory_map_t::read_peek(simulator_t &s, uword_t address, byte_t *value, uwo
 void memory_map_t::write_peek(simulator_t &s, uword_t address, byte_t *value, uword_t size)
 {
   // TODO should we pass that to the mapped devices?
-  assert(address < Base_address || address > High_address);
+  assert(!is_mapped(address));
   Memory.write_peek(s, address, value, size);
 }
 
@@ -403,7 +477,22 @@ bool memory_map_t::is_ready()
 
 void memory_map_t::tick(simulator_t &s)
 {
-  for (DeviceList::iterator it = Devices.begin(), ie = Devices.end();
+  // devices may arm or disarm events in any access, rebuild the list only
+  // once before ticking
+  if (Is_ticked_changed) {
+    Ticked_devices.clear();
+    for (DeviceList::iterator it = Devices.begin(), ie = Devices.end();
+         it != ie; ++it)
+    {
+      if ((*it)->is_ticked()) {
+        Ticked_devices.push_back(*it);
+      }
+    }
+    Is_ticked_changed = false;
+  }
+
+  for (DeviceList::iterator it = Ticked_devices.begin(),
+       ie = Ticked_devices.end();
        it != ie; ++it)
   {
     (*it)->tick(s);
@@ -411,6 +500,27 @@ void memory_map_t::tick(simulator_t &s)
   Memory.tick(s);
 }
 
+uint64_t memory_map_t::get_idle_cycles(simulator_t &s)
+{
+  uint64_t cycles = Memory.get_idle_cycles(s);
+  for (DeviceList::iterator it = Devices.begin(), ie = Devices.end();
+       it != ie && cycles; ++it)
+  {
+    cycles = std::min(cycles, (*it)->get_idle_cycles(s));
+  }
+  return cycles;
+}
+
+void memory_map_t::skip_cycles(simulator_t &s, uint64_t cycles)
+{
+  for (DeviceList::iterator it = Devices.begin(), ie = Devices.end();
+       it != ie; ++it)
+  {
+    (*it)->skip_cycles(s, cycles);
+  }
+  Memory.skip_cycles(s, cycles);
+}
+
 void memory_map_t::print(const simulator_t &s, std::ostream &os) const
 {
   for (DeviceList::const_iterator it = Devices.begin(), ie = Devices.end();
@@ -441,3 +551,25 @@ void memory_map_t::reset_stats()
   }
   Memory.reset_stats();
 }
+
+void memory_map_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write_config(Devices.size());
+  for (DeviceList::const_iterator it = Devices.begin(), ie = Devices.end();
+       it != ie; ++it)
+  {
+    (*it)->save_state(cw);
+  }
+  Memory.save_state(cw);
+}
+
+void memory_map_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.check_config(Devices.size(), "number of devices");
+  for (DeviceList::iterator it = Devices.begin(), ie = Devices.end();
+       it != ie; ++it)
+  {
+    (*it)->restore_state(cr);
+  }
+  Memory.restore_state(cr);
+}
@@ -35,9 +35,11 @@
 //
 #include "memory.h"
 
+#include "checkpoint.h"
 #include "excunit.h"
 #include "exception.h"
 #include "simulation-core.h"
+#include "stats-counters.h"
 #include "util.h"
 
 #ifdef RAMULATOR
@@ -58,14 +60,89 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <new>
+#include <random>
+
+#include <sys/mman.h>
 
 // #define TRACE_RAMULATOR 1
 
 using namespace patmos;
 
+/// Reserve zero-initialized memory, which is only allocated by the operating
+/// system when a page is accessed.
+/// @param size The number of bytes to reserve.
+/// @return The reserved memory.
+static byte_t *map_content(unsigned int size)
+{
+  void *content = mmap(NULL, std::max(size, 1u), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (content == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  return (byte_t*)content;
+}
+
+/// Release memory reserved by map_content.
+/// @param content The reserved memory.
+/// @param size The number of bytes reserved.
+static void unmap_content(byte_t *content, unsigned int size)
+{
+  munmap(content, std::max(size, 1u));
+}
+
+ideal_memory_t::ideal_memory_t(unsigned int memory_size, bool randomize,
+                               mem_check_e memchk)
+: Memory_size(memory_size),
+  Initialized_pages(new std::vector<bool>(
+                      (memory_size + MEMORY_PAGE_BYTES - 1) / MEMORY_PAGE_BYTES)),
+  Randomize(randomize), Mem_check(memchk), Is_shared(false),
+  Is_shared_by_cores(false)
+{
+  Content = map_content(memory_size);
+
+  if (memchk != MCK_NONE) {
+    Init_vector = map_content(memory_size);
+  } else {
+    Init_vector = NULL;
+  }
+}
+
+ideal_memory_t::~ideal_memory_t()
+{
+  if (Is_shared) return;
+  unmap_content(Content, Memory_size);
+  if (Init_vector) unmap_content(Init_vector, Memory_size);
+  delete Initialized_pages;
+}
+
+void ideal_memory_t::initialize_page(uword_t page)
+{
+  // the content and the init vector are cleared by the operating system.
+  if (Randomize) {
+    uword_t start = page * MEMORY_PAGE_BYTES;
+    uword_t end = std::min(start + MEMORY_PAGE_BYTES, Memory_size);
+
+    // seed from the page, so that the content neither depends on the order in
+    // which pages are touched nor on other simulations running concurrently.
+    std::mt19937 rng(page);
+    for(uword_t i = start; i < end; i++)
+    {
+      Content[i] = rng() % 256;
+    }
+  }
+
+  (*Initialized_pages)[page] = true;
+}
+
 void ideal_memory_t::check_initialize_content(simulator_t &s, uword_t address, uword_t size,
                                               bool is_read, bool ignore_errors)
 {
+  // wait for the other cores before touching the shared content
+  if (Is_shared_by_cores) {
+    s.order_shared_access();
+  }
+
   // check if the access exceeds the memory size
   if((address > Memory_size) || (size > Memory_size - address))
   {
@@ -73,24 +150,23 @@ void ideal_memory_t::check_initialize_content(simulator_t &s, uword_t address, u
     simulation_exception_t::unmapped(address);
   }
 
-  // initialize memory content
-  uword_t init_size = std::min(address + std::max(1024u, size), Memory_size);
-  for(; Initialized_offset < init_size; Initialized_offset++)
+  // initialize the pages of the memory content touched by the access
+  if (size != 0)
   {
-    Content[Initialized_offset] = Randomize ? rand() % 256 : 0;
-    if (Init_vector) {
-      Init_vector[Initialized_offset] = 0;
+    uword_t last_page = (address + size - 1) / MEMORY_PAGE_BYTES;
+    for(uword_t p = address / MEMORY_PAGE_BYTES; p <= last_page; p++)
+    {
+      if (!(*Initialized_pages)[p]) {
+        initialize_page(p);
+      }
     }
   }
 
   if (Init_vector && is_read) {
     // Read, check for uninitialized access
     if (!ignore_errors) {
-      uword_t top_addr = std::max(address,
-                                  std::min(Initialized_offset, address + size));
-      uword_t cnt = Initialized_offset < address + size ?
-                                         address + size - top_addr : 0;
-      for (uword_t i = address; i < top_addr; i++) {
+      uword_t cnt = 0;
+      for (uword_t i = address; i < address + size; i++) {
         if (!Init_vector[i]) {
           cnt++;
         }
@@ -121,6 +197,58 @@ void ideal_memory_t::check_initialize_content(simulator_t &s, uword_t address, u
   }
 }
 
+void ideal_memory_t::share_content(ideal_memory_t &primary)
+{
+  assert(Memory_size == primary.Memory_size &&
+         (Init_vector == NULL) == (primary.Init_vector == NULL));
+
+  if (!Is_shared) {
+    unmap_content(Content, Memory_size);
+    if (Init_vector) unmap_content(Init_vector, Memory_size);
+    delete Initialized_pages;
+  }
+
+  // the pages are still initialized on their first access by any core
+  Content = primary.Content;
+  Init_vector = primary.Init_vector;
+  Initialized_pages = primary.Initialized_pages;
+  Is_shared = true;
+
+  Is_shared_by_cores = primary.Is_shared_by_cores = true;
+}
+
+void ideal_memory_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write_config(Memory_size);
+  cw.write_config(Init_vector != NULL);
+
+  // only the initialized pages of the memory are stored
+  static_assert(MEMORY_PAGE_BYTES == CHECKPOINT_PAGE_BYTES,
+                "memory pages have to match the pages of checkpoints");
+  cw.write_pages(Content, Memory_size, *Initialized_pages);
+  if (Init_vector) {
+    cw.write_pages(Init_vector, Memory_size, *Initialized_pages);
+  }
+}
+
+void ideal_memory_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.check_config(Memory_size, "memory size");
+  cr.check_config(Init_vector != NULL, "memory checks");
+
+  // pages that are not stored are initialized again on their next access
+  std::vector<bool> pages(*Initialized_pages);
+  cr.read_pages(Content, Memory_size, pages);
+  if (Init_vector) {
+    std::vector<bool> init_pages(*Initialized_pages);
+    cr.read_pages(Init_vector, Memory_size, init_pages);
+    if (init_pages != pages) {
+      cr.error("memory checks do not match the memory content");
+    }
+  }
+  *Initialized_pages = pages;
+}
+
 bool ideal_memory_t::read(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch)
 {
   if (Mmu) {
@@ -191,6 +319,127 @@ void ideal_memory_t::write_peek(simulator_t &s, uword_t address, byte_t *value,
 }
 
 
+const uint64_t request_queue_t::NO_REQUEST;
+
+request_queue_t::request_queue_t(unsigned int capacity)
+: Head(0), Tail(0), Num_posted(0)
+{
+  unsigned int buffer_size = 1;
+  while (buffer_size < capacity)
+    buffer_size <<= 1;
+
+  resize(buffer_size);
+}
+
+void request_queue_t::index(uint64_t seq)
+{
+  const request_info_t &req(get(seq));
+  bucket_t &bucket(get_bucket(req.Address, req.Size, req.Is_load));
+
+  Next[seq & (Next.size() - 1)] = NO_REQUEST;
+  if (bucket.first == NO_REQUEST)
+    bucket.first = seq;
+  else
+    Next[bucket.second & (Next.size() - 1)] = seq;
+  bucket.second = seq;
+}
+
+void request_queue_t::resize(unsigned int buffer_size)
+{
+  // keep the sequence numbers of the requests
+  std::vector<request_info_t> buffer(buffer_size);
+  for(uint64_t seq = Head; seq != Tail; seq++)
+  {
+    buffer[seq & (buffer_size - 1)] = get(seq);
+  }
+  Buffer.swap(buffer);
+
+  Next.assign(buffer_size, NO_REQUEST);
+  Buckets.assign(buffer_size, bucket_t(NO_REQUEST, NO_REQUEST));
+  for(uint64_t seq = Head; seq != Tail; seq++)
+  {
+    index(seq);
+  }
+}
+
+request_info_t *request_queue_t::find(uword_t address, uword_t size,
+                                      bool is_load)
+{
+  // the oldest matching request comes first in its bucket
+  for(uint64_t seq = get_bucket(address, size, is_load).first;
+      seq != NO_REQUEST; seq = Next[seq & (Next.size() - 1)])
+  {
+    request_info_t &req(get(seq));
+    if (req.Address == address && req.Size == size && req.Is_load == is_load)
+      return &req;
+  }
+  return NULL;
+}
+
+request_info_t &request_queue_t::push_back(const request_info_t &req)
+{
+  if (size() == Buffer.size())
+    resize(Buffer.size() * 2);
+
+  if (req.Is_posted)
+    Num_posted++;
+
+  request_info_t &tail = get(Tail);
+  tail = req;
+  index(Tail++);
+  return tail;
+}
+
+void request_queue_t::pop_front()
+{
+  assert(!empty());
+
+  // the oldest request in the queue is the oldest request of its bucket
+  request_info_t &head = get(Head);
+  bucket_t &bucket(get_bucket(head.Address, head.Size, head.Is_load));
+  assert(bucket.first == Head);
+  bucket.first = Next[Head & (Next.size() - 1)];
+  if (bucket.first == NO_REQUEST)
+    bucket.second = NO_REQUEST;
+
+  if (head.Is_posted)
+    Num_posted--;
+  Head++;
+}
+
+void request_queue_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(size());
+  for(uint64_t seq = Head; seq != Tail; seq++)
+  {
+    const request_info_t &req(get(seq));
+    cw.write(req.Address);
+    cw.write(req.Size);
+    cw.write(req.Is_load);
+    cw.write(req.Is_posted);
+    cw.write(req.Num_ticks_remaining);
+  }
+}
+
+void request_queue_t::restore_state(checkpoint_reader_t &cr)
+{
+  Head = Tail = 0;
+  Num_posted = 0;
+  Buckets.assign(Buckets.size(), bucket_t(NO_REQUEST, NO_REQUEST));
+
+  unsigned int num_requests = cr.read<unsigned int>();
+  for(unsigned int i = 0; i < num_requests; i++)
+  {
+    request_info_t req;
+    cr.read(req.Address);
+    cr.read(req.Size);
+    cr.read(req.Is_load);
+    cr.read(req.Is_posted);
+    cr.read(req.Num_ticks_remaining);
+    push_back(req);
+  }
+}
+
 uword_t fixed_delay_memory_t::get_aligned_size(uword_t address, uword_t size,
                                                uword_t &aligned_address)
 {
@@ -233,13 +482,9 @@ const request_info_t &fixed_delay_memory_t::find_or_create_request(simulator_t &
   check_initialize_content(s, address, size, is_load);
 
   // see if the request already exists
-  for(requests_t::const_iterator i(Requests.begin()), ie(Requests.end());
-      i != ie; i++)
-  {
-    // found matching request?
-    if (i->Address == address && i->Size == size && i->Is_load == is_load)
-      return *i;
-  }
+  const request_info_t *req = Requests.find(address, size, is_load);
+  if (req)
+    return *req;
 
   // no matching request found, create a new one
   uword_t aligned_address;
@@ -248,7 +493,7 @@ const request_info_t &fixed_delay_memory_t::find_or_create_request(simulator_t &
                                               is_load, is_posted);
 
   request_info_t tmp = {address, size, is_load, is_posted, num_ticks};
-  Requests.push_back(tmp);
+  const request_info_t &created = Requests.push_back(tmp);
 
   // Update statistics
   Num_max_queue_size = std::max(Num_max_queue_size, (unsigned)Requests.size());
@@ -269,21 +514,24 @@ const request_info_t &fixed_delay_memory_t::find_or_create_request(simulator_t &
   Last_is_load = is_load;
 
   // calculate bucket for request size histogram
-  uword_t hist_size = (((size - 1) / 4) + 1) * 4;
-  request_size_map_t::iterator it = Num_requests_per_size.find(hist_size);
-  if (it == Num_requests_per_size.end()) {
-    Num_requests_per_size.insert(std::make_pair(hist_size, (uint64_t)1));
-  } else {
-    it->second++;
+  uword_t hist_bucket = (size - 1) / 4;
+  if (hist_bucket >= Num_requests_per_size.size()) {
+    Num_requests_per_size.resize(hist_bucket + 1);
   }
-
+  Num_requests_per_size[hist_bucket]++;
 
   // return the newly created request
-  return Requests.back();
+  return created;
 }
 
 bool fixed_delay_memory_t::read(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch)
 {
+  // complete the access immediately during a functional warm-up
+  if (s.Is_functional)
+  {
+    return ideal_memory_t::read(s, address, value, size, is_fetch);
+  }
+
   // get the request info
   const request_info_t &req(find_or_create_request(s, address, size, true, is_fetch));
 
@@ -298,7 +546,7 @@ bool fixed_delay_memory_t::read(simulator_t &s, uword_t address, byte_t *value,
 #endif
 
     // clean-up the request
-    Requests.erase(Requests.begin());
+    Requests.pop_front();
 
     // read the data
     return ideal_memory_t::read(s, address, value, size, is_fetch);
@@ -312,6 +560,12 @@ bool fixed_delay_memory_t::read(simulator_t &s, uword_t address, byte_t *value,
 
 bool fixed_delay_memory_t::write(simulator_t &s, uword_t address, byte_t *value, uword_t size)
 {
+  // complete the access immediately during a functional warm-up
+  if (s.Is_functional)
+  {
+    return ideal_memory_t::write(s, address, value, size);
+  }
+
   // To avoid delaying reads until the write has been stored to the queue,
   // we just add it to the queue and delay later until the queue is small
   // enough.
@@ -332,7 +586,7 @@ bool fixed_delay_memory_t::write(simulator_t &s, uword_t address, byte_t *value,
 #endif
 
     // clean-up the request
-    Requests.erase(Requests.begin());
+    Requests.pop_front();
 
     // write the data
     return ideal_memory_t::write(s, address, value, size);
@@ -358,19 +612,10 @@ void fixed_delay_memory_t::tick(simulator_t &s)
   // check if there are only posted writes in the queue, then there is
   // no one waiting on any result and we are actually not stalling in this
   // cycle
-  if (!Requests.empty() && Requests.size() <= Num_posted_writes) {
-    bool posted = true;
-    for (requests_t::iterator it = Requests.begin(), ie = Requests.end();
-          it != ie; it++)
-    {
-      if (!it->Is_posted) {
-        posted = false;
-        break;
-      }
-    }
-    if (posted) {
-      Num_posted_write_cycles++;
-    }
+  if (!Requests.empty() && Requests.size() <= Num_posted_writes &&
+      Requests.num_posted() == Requests.size())
+  {
+    Num_posted_write_cycles++;
   }
 
   // update the request queue
@@ -380,11 +625,37 @@ void fixed_delay_memory_t::tick(simulator_t &s)
     tick_request(req);
 
     if (req.Num_ticks_remaining == 0 && req.Is_posted) {
-      Requests.erase(Requests.begin());
+      Requests.pop_front();
     }
   }
 }
 
+uint64_t fixed_delay_memory_t::get_idle_cycles(simulator_t &s)
+{
+  // repeated reads of uninitialized data are reported in every cycle
+  if (Mem_check != MCK_NONE)
+    return 0;
+
+  if (Requests.empty())
+    return std::numeric_limits<uint64_t>::max();
+
+  // posted writes complete without anyone waiting for them, do not skip
+  // over them.
+  if (Requests.num_posted())
+    return 0;
+
+  return Requests.front().Num_ticks_remaining;
+}
+
+void fixed_delay_memory_t::skip_cycles(simulator_t &s, uint64_t cycles)
+{
+  if (!Requests.empty())
+  {
+    assert(cycles <= Requests.front().Num_ticks_remaining);
+    Requests.front().Num_ticks_remaining -= cycles;
+  }
+}
+
 /// Print the internal state of the memory to an output stream.
 /// @param os The output stream to print to.
 void fixed_delay_memory_t::print(const simulator_t &s, std::ostream &os) const
@@ -395,12 +666,12 @@ void fixed_delay_memory_t::print(const simulator_t &s, std::ostream &os) const
   }
   else
   {
-    for(requests_t::const_iterator i(Requests.begin()), ie(Requests.end());
-        i != ie; i++)
+    for(unsigned int i = 0; i < Requests.size(); i++)
     {
+      const request_info_t &req = Requests[i];
       os << boost::format(" %1%: %2% (0x%3$08x %4%)\n")
-        % (i->Is_load ? "LOAD " : "STORE") % i->Num_ticks_remaining
-        % i->Address % i->Size;
+        % (req.Is_load ? "LOAD " : "STORE") % req.Num_ticks_remaining
+        % req.Address % req.Size;
     }
   }
 }
@@ -453,10 +724,11 @@ void fixed_delay_memory_t::print_stats(const simulator_t &s, std::ostream &os,
     return;
 
   os << "Request size    #requests\n";
-  for (request_size_map_t::iterator it = Num_requests_per_size.begin(),
-        ie = Num_requests_per_size.end(); it != ie; it++)
+  for (unsigned int i = 0; i < Num_requests_per_size.size(); i++)
   {
-    os << boost::format("  %1$10d : %2$12d\n") % it->first % it->second;
+    if (Num_requests_per_size[i])
+      os << boost::format("  %1$10d : %2$12d\n")
+          % ((i + 1) * 4) % Num_requests_per_size[i];
   }
 }
 
@@ -475,6 +747,32 @@ void fixed_delay_memory_t::reset_stats()
   Num_requests_per_size.clear();
 }
 
+void fixed_delay_memory_t::add_counters(stats_counters_t &counters)
+{
+  counters.add("max_queue_size", Num_max_queue_size, true);
+  counters.add("consecutive_requests", Num_consecutive_requests);
+  counters.add("reads", Num_reads);
+  counters.add("writes", Num_writes);
+  counters.add("bytes_read", Num_bytes_read);
+  counters.add("bytes_written", Num_bytes_written);
+  counters.add("bytes_read_transferred", Num_bytes_read_transferred);
+  counters.add("bytes_write_transferred", Num_bytes_write_transferred);
+  counters.add("busy_cycles", Num_busy_cycles);
+  counters.add("posted_write_cycles", Num_posted_write_cycles);
+}
+
+void fixed_delay_memory_t::save_state(checkpoint_writer_t &cw) const
+{
+  ideal_memory_t::save_state(cw);
+  Requests.save_state(cw);
+}
+
+void fixed_delay_memory_t::restore_state(checkpoint_reader_t &cr)
+{
+  ideal_memory_t::restore_state(cr);
+  Requests.restore_state(cr);
+}
+
 
 unsigned int variable_burst_memory_t::get_transfer_ticks(uword_t aligned_address,
                                                          uword_t aligned_size,
@@ -562,7 +860,7 @@ unsigned int tdm_memory_t::get_transfer_ticks(uword_t aligned_address,
   return num_blocks;
 }
 
-void tdm_memory_t::tick_request(request_info_t &req)
+uword_t tdm_memory_t::get_round_end(const request_info_t &req) const
 {
   unsigned int round_end = Round_start + Num_ticks_per_burst;
   if (!req.Is_posted) {
@@ -571,6 +869,12 @@ void tdm_memory_t::tick_request(request_info_t &req)
   if (round_end >= Round_length) {
     round_end -= Round_length;
   }
+  return round_end;
+}
+
+void tdm_memory_t::tick_request(request_info_t &req)
+{
+  unsigned int round_end = get_round_end(req);
 
   // We are counting down TDM rounds
   if (round_end == Round_counter && Is_Transferring) {
@@ -596,6 +900,82 @@ void tdm_memory_t::tick(simulator_t &s)
   fixed_delay_memory_t::tick(s);
 }
 
+uint64_t tdm_memory_t::get_idle_cycles(simulator_t &s)
+{
+  uint64_t cycles = fixed_delay_memory_t::get_idle_cycles(s);
+  if (Requests.empty() || cycles == 0)
+    return cycles;
+
+  // Follow the TDM rounds until the pending request completes.
+  uword_t round_end = get_round_end(Requests.front());
+  uword_t counter = Round_counter;
+  bool transferring = Is_Transferring;
+  unsigned int remaining = Requests.front().Num_ticks_remaining;
+
+  cycles = 0;
+  for(;;)
+  {
+    uword_t next = transferring ? round_end : Round_start;
+    uword_t distance = (next + Round_length - counter) % Round_length;
+    cycles += distance ? distance : Round_length;
+    counter = next;
+
+    if (counter == Round_start) {
+      transferring = true;
+    }
+    if (transferring && counter == round_end) {
+      if (--remaining == 0)
+        return cycles;
+      transferring = false;
+    }
+  }
+}
+
+void tdm_memory_t::skip_cycles(simulator_t &s, uint64_t cycles)
+{
+  // Between the start and the end of a TDM slot only the round counter
+  // advances, simulate the ticks at those events.
+  while (cycles)
+  {
+    uword_t distance = (Round_start + Round_length - Round_counter - 1) %
+                       Round_length;
+    if (!Requests.empty()) {
+      uword_t round_end = get_round_end(Requests.front());
+      distance = std::min(distance, (round_end + Round_length -
+                                     Round_counter - 1) % Round_length);
+    }
+
+    uint64_t quiet = std::min<uint64_t>(distance, cycles);
+    Round_counter = (Round_counter + quiet) % Round_length;
+    cycles -= quiet;
+
+    if (cycles) {
+      tick(s);
+      cycles--;
+    }
+  }
+}
+
+void tdm_memory_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write_config(Round_length);
+  cw.write_config(Round_start);
+
+  fixed_delay_memory_t::save_state(cw);
+  cw.write(Round_counter);
+  cw.write(Is_Transferring);
+}
+
+void tdm_memory_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.check_config(Round_length, "TDM round length");
+  cr.check_config(Round_start, "TDM slot");
+
+  fixed_delay_memory_t::restore_state(cr);
+  cr.read(Round_counter);
+  cr.read(Is_Transferring);
+}
+
 #ifdef RAMULATOR
 namespace patmos {
   template <class T>
@@ -702,8 +1082,14 @@ template <class T>
 bool ramulator_memory_t<T>::read(simulator_t &s, uword_t address, byte_t *value,
                                  uword_t size, bool is_fetch)
 {
+  // complete the access immediately during a functional warm-up
+  if (s.Is_functional)
+  {
+    return ideal_memory_t::read(s, address, value, size, is_fetch);
+  }
+
   // No request pending?
-  if (Pending_start == 0)
+  if (Num_bursts_pending == 0)
   {
     // compute request characteristics.
     Pending_start = align_down(address, Num_burst_bytes);
@@ -785,8 +1171,14 @@ template <class T>
 bool ramulator_memory_t<T>::write(simulator_t &s, uword_t address,
                                   byte_t *value, uword_t size)
 {
+  // complete the access immediately during a functional warm-up
+  if (s.Is_functional)
+  {
+    return ideal_memory_t::write(s, address, value, size);
+  }
+
   // No request pending?
-  if (Pending_start == 0)
+  if (Num_bursts_pending == 0)
   {
     // compute request characteristics.
     Pending_start = align_down(address, Num_burst_bytes);
@@ -879,6 +1271,35 @@ void ramulator_memory_t<T>::tick(simulator_t &s)
   }
 }
 
+template <class T>
+void ramulator_memory_t<T>::add_counters(stats_counters_t &counters)
+{
+  counters.add("reads", Num_requests_load);
+  counters.add("writes", Num_requests_store);
+  counters.add("read_bursts", Num_bursts_load);
+  counters.add("write_bursts", Num_bursts_store);
+  counters.add("bytes_read", Num_bytes_load);
+  counters.add("bytes_written", Num_bytes_store);
+  counters.add("load_stall_cycles", Num_stall_cycles_load);
+  counters.add("store_stall_cycles", Num_stall_cycles_store);
+  counters.add("load_queue_full", Num_full_queue_load);
+  counters.add("store_queue_full", Num_full_queue_store);
+}
+
+template <class T>
+void ramulator_memory_t<T>::save_state(checkpoint_writer_t &cw) const
+{
+  throw std::ios_base::failure(
+                       "Checkpoints are not supported for ramulator memories.");
+}
+
+template <class T>
+void ramulator_memory_t<T>::restore_state(checkpoint_reader_t &cr)
+{
+  throw std::ios_base::failure(
+                       "Checkpoints are not supported for ramulator memories.");
+}
+
 template <class T>
 void ramulator_memory_t<T>::print_stats(const simulator_t &s, std::ostream &os,
                                         const stats_options_t& options)
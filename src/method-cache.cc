@@ -37,9 +37,11 @@
 #include "method-cache.h"
 
 #include "basic-types.h"
+#include "checkpoint.h"
 #include "endian-conversion.h"
 #include "instr-cache.h"
 #include "simulation-core.h"
+#include "stats-counters.h"
 #include "symbol.h"
 
 #include <cassert>
@@ -88,11 +90,26 @@ void ideal_method_cache_t::tick(simulator_t &s)
   // do nothing here
 }
 
+uint64_t ideal_method_cache_t::get_idle_cycles(simulator_t &s)
+{
+  return std::numeric_limits<uint64_t>::max();
+}
+
 void ideal_method_cache_t::print(const simulator_t &s, std::ostream &os)
 {
   // nothing to do here either, since the cache has no internal state.
 }
 
+void ideal_method_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(current_base);
+}
+
+void ideal_method_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(current_base);
+}
+
 void ideal_method_cache_t::print_stats(const simulator_t &s, std::ostream &os,
                                        const stats_options_t& options)
 {
@@ -598,6 +615,18 @@ void lru_method_cache_t::tick(simulator_t &s)
     Num_stall_cycles++;
 }
 
+uint64_t lru_method_cache_t::get_idle_cycles(simulator_t &s)
+{
+  // transfers are timed by the memory
+  return std::numeric_limits<uint64_t>::max();
+}
+
+void lru_method_cache_t::skip_cycles(simulator_t &s, uint64_t cycles)
+{
+  if (Phase != IDLE)
+    Num_stall_cycles += cycles;
+}
+
 void lru_method_cache_t::print(const simulator_t &s, std::ostream &os)
 {
   os << boost::format(" #M: %1$02d #B: %2$02d\n")
@@ -782,7 +811,25 @@ void lru_method_cache_t::reset_stats()
   }
 }
 
-void lru_method_cache_t::flush_cache()
+void lru_method_cache_t::add_counters(stats_counters_t &counters)
+{
+  counters.add("blocks_allocated", Num_blocks_allocated);
+  counters.add("max_blocks_allocated", Num_max_blocks_allocated, true);
+  counters.add("bytes_transferred", Num_bytes_transferred);
+  counters.add("max_bytes_transferred", Num_max_bytes_transferred, true);
+  counters.add("bytes_fetched", Num_bytes_fetched);
+  counters.add("blocks_freed", Num_blocks_freed);
+  counters.add("max_blocks_freed", Max_blocks_freed, true);
+  counters.add("max_active_methods", Num_max_active_methods, true);
+  counters.add("hits", Num_hits);
+  counters.add("misses", Num_misses);
+  counters.add("misses_returns", Num_misses_ret);
+  counters.add("evictions_capacity", Num_evictions_capacity);
+  counters.add("evictions_tag", Num_evictions_tag);
+  counters.add("stall_cycles", Num_stall_cycles);
+}
+
+void lru_method_cache_t::flush_cache(simulator_t &s)
 {
   if (Num_active_methods < 2) return;
 
@@ -797,6 +844,52 @@ void lru_method_cache_t::flush_cache()
   Num_active_blocks = Methods[Num_blocks - 1].Num_blocks;
 }
 
+void lru_method_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write_config(Num_blocks);
+  cw.write_config(Num_block_bytes);
+  cw.write_config(Num_max_methods);
+
+  cw.write(Phase);
+  cw.write(Num_allocate_blocks);
+  cw.write(Num_method_size);
+  cw.write(Num_active_methods);
+  cw.write(Num_active_blocks);
+
+  // the method entries, the utilization is only used for statistics
+  for(unsigned int i = Num_blocks - Num_active_methods; i < Num_blocks; i++)
+  {
+    cw.write(Methods[i].Address);
+    cw.write(Methods[i].Num_blocks);
+    cw.write(Methods[i].Num_bytes);
+  }
+}
+
+void lru_method_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.check_config(Num_blocks, "method cache size");
+  cr.check_config(Num_block_bytes, "method cache block size");
+  cr.check_config(Num_max_methods, "method cache methods");
+
+  cr.read(Phase);
+  cr.read(Num_allocate_blocks);
+  cr.read(Num_method_size);
+  cr.read(Num_active_methods);
+  cr.read(Num_active_blocks);
+
+  if (Num_active_methods > Num_blocks) {
+    cr.error("invalid method cache state");
+  }
+
+  for(unsigned int i = Num_blocks - Num_active_methods; i < Num_blocks; i++)
+  {
+    uword_t address = cr.read<uword_t>();
+    uword_t num_blocks = cr.read<uword_t>();
+    uword_t num_bytes = cr.read<uword_t>();
+    Methods[i].update(address, num_blocks, num_bytes);
+  }
+}
+
 /// free dynamically allocated cache memory.
 lru_method_cache_t::~lru_method_cache_t()
 {
@@ -847,7 +940,7 @@ bool fifo_method_cache_t::fetch(simulator_t &s, uword_t base, uword_t address, w
   return base_t::do_fetch(s, base_t::Methods[active_method], address, iw);
 }
 
-void fifo_method_cache_t::flush_cache()
+void fifo_method_cache_t::flush_cache(simulator_t &s)
 {
   if (Num_active_methods < 2) return;
 
@@ -867,3 +960,18 @@ void fifo_method_cache_t::flush_cache()
   Num_active_blocks = Methods[Num_blocks - 1].Num_blocks;
 }
 
+void fifo_method_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  base_t::save_state(cw);
+  cw.write<uint64_t>(active_method);
+}
+
+void fifo_method_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  base_t::restore_state(cr);
+
+  active_method = cr.read<uint64_t>();
+  if (active_method >= Num_blocks) {
+    cr.error("invalid method cache state");
+  }
+}
@@ -0,0 +1,239 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Simulation of several Patmos cores sharing the global memory.
+//
+
+#include "multicore.h"
+#include "simulation-core.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace patmos
+{
+  multicore_t::multicore_t(sync_e sync, uint64_t quantum,
+                           unsigned int num_threads) :
+      Sync(sync), Quantum(std::max<uint64_t>(quantum, 1)),
+      Num_threads(std::max(num_threads, 1u)), Failed_core(0), Max_cycles(0),
+      Num_cycles(0), Num_slice_cycles(0), Is_done(false), Num_waiting(0),
+      Generation(0), Num_finished(0)
+  {
+  }
+
+  multicore_t::~multicore_t()
+  {
+    for(unsigned int i = 0; i < Exceptions.size(); i++)
+    {
+      delete Exceptions[i];
+    }
+  }
+
+  void multicore_t::add_core(simulator_t &s, std::ostream *debug_out)
+  {
+    Cores.push_back(&s);
+    Debug_outs.push_back(debug_out);
+    Exceptions.push_back(NULL);
+  }
+
+  void multicore_t::update_slice()
+  {
+    // stop when core 0 halted or any core raised an error
+    Is_done = (Num_cycles == Max_cycles) || Exceptions[0];
+    for(unsigned int i = 1; i < Exceptions.size(); i++)
+    {
+      if (Exceptions[i] &&
+          Exceptions[i]->get_kind() != simulation_exception_t::HALT)
+        Is_done = true;
+    }
+
+    uint64_t slice = (Sync == SY_CYCLE) ? 1 : Quantum;
+    Num_slice_cycles = std::min(slice, Max_cycles - Num_cycles);
+  }
+
+  void multicore_t::start_slice()
+  {
+    Is_finished.assign(Cores.size(), false);
+    Num_finished = 0;
+    for(unsigned int i = 0; i < Cores.size(); i++)
+    {
+      Cores[i]->Is_shared_access_granted = false;
+    }
+  }
+
+  void multicore_t::finish_slice(unsigned int core)
+  {
+    // with a single thread, the cores run one after another anyway
+    if (Num_threads == 1)
+      return;
+
+    std::unique_lock<std::mutex> lock(Mutex);
+
+    Is_finished[core] = true;
+    while (Num_finished < Cores.size() && Is_finished[Num_finished])
+    {
+      Num_finished++;
+    }
+    Finished.notify_all();
+  }
+
+  void multicore_t::wait_for_turn(unsigned int core)
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+
+    Finished.wait(lock, [&] { return Num_finished >= core; });
+  }
+
+  bool multicore_t::synchronize()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+
+    uint64_t generation = Generation;
+
+    if (++Num_waiting == Num_threads)
+    {
+      // the last thread to arrive prepares the next slice
+      Num_cycles += Num_slice_cycles;
+      update_slice();
+      start_slice();
+
+      Num_waiting = 0;
+      Generation++;
+      Synchronized.notify_all();
+    }
+    else
+    {
+      Synchronized.wait(lock, [&] { return Generation != generation; });
+    }
+
+    return !Is_done;
+  }
+
+  void multicore_t::simulate(unsigned int thread, word_t entry,
+                             uint64_t debug_cycle, debug_format_e debug_fmt,
+                             std::ostream &debug_out, bool debug_nopc,
+                             bool collect_instr_stats)
+  {
+    do
+    {
+      for(unsigned int i = thread; i < Cores.size(); i += Num_threads)
+      {
+        if (!Exceptions[i])
+        {
+          try
+          {
+            Cores[i]->step(entry, debug_cycle, debug_fmt,
+                           Debug_outs[i] ? *Debug_outs[i] : debug_out,
+                           debug_nopc, Num_slice_cycles, collect_instr_stats);
+          }
+          catch (const simulation_exception_t &e)
+          {
+            Exceptions[i] = new simulation_exception_t(e);
+          }
+        }
+
+        finish_slice(i);
+      }
+    } while (synchronize());
+  }
+
+  void multicore_t::run(word_t entry, uint64_t debug_cycle,
+                        debug_format_e debug_fmt, std::ostream &debug_out,
+                        bool debug_nopc, uint64_t max_cycles,
+                        bool collect_instr_stats)
+  {
+    assert(!Cores.empty());
+
+    Num_threads = std::min<unsigned int>(Num_threads, Cores.size());
+    Max_cycles = max_cycles;
+    Num_cycles = 0;
+    update_slice();
+    start_slice();
+
+    // order the accesses to shared state when several threads simulate the
+    // cores
+    if (Num_threads > 1)
+    {
+      for(unsigned int i = 0; i < Cores.size(); i++)
+      {
+        Cores[i]->Multicore = this;
+        Cores[i]->Core_id = i;
+      }
+    }
+
+    // the calling thread simulates its share of the cores as well
+    std::vector<std::thread> threads;
+    for(unsigned int t = 1; t < Num_threads; t++)
+    {
+      threads.push_back(std::thread(&multicore_t::simulate, this, t, entry,
+                                    debug_cycle, debug_fmt, std::ref(debug_out),
+                                    debug_nopc, collect_instr_stats));
+    }
+
+    simulate(0, entry, debug_cycle, debug_fmt, debug_out, debug_nopc,
+             collect_instr_stats);
+
+    for(unsigned int t = 0; t < threads.size(); t++)
+    {
+      threads[t].join();
+    }
+
+    for(unsigned int i = 0; i < Cores.size(); i++)
+    {
+      Cores[i]->Multicore = NULL;
+    }
+
+    for(unsigned int i = 0; i < Cores.size(); i++)
+    {
+      Cores[i]->finalize();
+    }
+
+    // pass on the first error, or the halt of core 0
+    for(unsigned int i = 0; i < Cores.size(); i++)
+    {
+      if (Exceptions[i] &&
+          Exceptions[i]->get_kind() != simulation_exception_t::HALT)
+      {
+        Failed_core = i;
+        throw *Exceptions[i];
+      }
+    }
+
+    if (Exceptions[0])
+    {
+      Failed_core = 0;
+      throw *Exceptions[0];
+    }
+  }
+}
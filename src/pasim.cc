@@ -35,6 +35,7 @@
 //
 
 #include "command-line.h"
+#include "core-components.h"
 #include "loader.h"
 #include "dbgstack.h"
 #include "data-cache.h"
@@ -42,11 +43,16 @@
 #include "instr-cache.h"
 #include "instr-spm.h"
 #include "method-cache.h"
+#include "multicore.h"
 #include "simulation-core.h"
 #include "stack-cache.h"
+#include "self-profile.h"
+#include "stats-counters.h"
 #include "streams.h"
 #include "symbol.h"
 #include "memory-map.h"
+#include "checkpoint.h"
+#include "debug-sink.h"
 #include "noc.h"
 #include "uart.h"
 #include "rtc.h"
@@ -57,12 +63,22 @@
 #include <termios.h>
 #include <signal.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
 
 
 /// Construct a global memory for the simulation.
@@ -108,9 +124,9 @@ static patmos::memory_t &create_global_memory(patmos::main_memory_kind_e kind,
         if (burst_time == 0 && read_delay == 0)
           return *new patmos::ideal_memory_t(size, randomize_mem, chkreads);
         else if (page_size == 0)
-          return *new patmos::fixed_delay_memory_t(size, burst_size, posted,
-                                                  burst_time, read_delay,
-                                                  randomize_mem, chkreads);
+          return *new patmos::default_memory_t(size, burst_size, posted,
+                                               burst_time, read_delay,
+                                               randomize_mem, chkreads);
         else
           return *new patmos::variable_burst_memory_t(size, burst_size, page_size,
                                                   posted, burst_time, read_delay,
@@ -135,15 +151,90 @@ static patmos::memory_t &create_global_memory(patmos::main_memory_kind_e kind,
   abort();
 }
 
+/// Construct a set-associative cache with the replacement policy of a cache
+/// kind.
+/// @param sck The kind of the cache requested, SAC_DM for a direct-mapped
+/// cache.
+/// @param assoc The associativity of the cache.
+/// @param num_blocks The size of the cache in blocks.
+/// @param line_size The size of one cache line.
+/// @param wp The write policy of the cache.
+/// @param walloc Flag indicating whether write misses allocate a line.
+/// @param seed Seed of randomized replacement policies.
+/// @param victims The number of lines of the victim buffer.
+/// @param pf The kind of the prefetcher.
+/// @param gm Global memory accessed on a cache miss.
+/// @return An instance of a set-associative cache.
+static patmos::data_cache_t *create_set_assoc_cache(
+                                         patmos::set_assoc_cache_type sck,
+                                         unsigned int assoc,
+                                         unsigned int num_blocks,
+                                         unsigned int line_size,
+                                         patmos::write_policy_e wp,
+                                         bool walloc, unsigned int seed,
+                                         unsigned int victims,
+                                         patmos::prefetch_type pf,
+                                         patmos::memory_t &gm)
+{
+  switch (sck.policy)
+  {
+    case patmos::SAC_DM:
+      assert(sck.associativity == 1);
+      // Fallthrough to LRU with 1-way assoc to model direct mapped cache
+    case patmos::SAC_LRU:
+      return new patmos::default_data_cache_t(
+                          gm, assoc, num_blocks, line_size, wp, walloc, seed,
+                          victims, pf);
+    case patmos::SAC_FIFO:
+      return new patmos::set_assoc_data_cache_t<patmos::fifo_replacement_t>(
+                          gm, assoc, num_blocks, line_size, wp, walloc, seed,
+                          victims, pf);
+    case patmos::SAC_PLRU:
+      return new patmos::set_assoc_data_cache_t<patmos::tree_plru_replacement_t>(
+                          gm, assoc, num_blocks, line_size, wp, walloc, seed,
+                          victims, pf);
+    case patmos::SAC_BPLRU:
+      return new patmos::set_assoc_data_cache_t<patmos::bit_plru_replacement_t>(
+                          gm, assoc, num_blocks, line_size, wp, walloc, seed,
+                          victims, pf);
+    case patmos::SAC_RANDOM:
+      return new patmos::set_assoc_data_cache_t<patmos::random_replacement_t>(
+                          gm, assoc, num_blocks, line_size, wp, walloc, seed,
+                          victims, pf);
+    case patmos::SAC_SRRIP:
+      return new patmos::set_assoc_data_cache_t<patmos::srrip_replacement_t>(
+                          gm, assoc, num_blocks, line_size, wp, walloc, seed,
+                          victims, pf);
+    case patmos::SAC_BRRIP:
+      return new patmos::set_assoc_data_cache_t<patmos::brrip_replacement_t>(
+                          gm, assoc, num_blocks, line_size, wp, walloc, seed,
+                          victims, pf);
+    case patmos::SAC_IDEAL:
+    case patmos::SAC_NO:
+      break;
+  }
+
+  abort();
+}
+
 /// Construct a data cache for the simulation.
 /// @param dck The kind of the data cache requested.
 /// @param size The requested size of the data cache in bytes.
 /// @param line_size The size of one cache line.
+/// @param wp The write policy of the data cache.
+/// @param walloc Flag indicating whether write misses allocate a line.
+/// @param seed Seed of randomized replacement policies.
+/// @param victims The number of lines of the victim buffer.
+/// @param pf The kind of the prefetcher.
 /// @param gm Global memory accessed on a cache miss.
 /// @return An instance of a data cache.
 static patmos::data_cache_t &create_data_cache(patmos::set_assoc_cache_type dck,
                                                unsigned int size,
                                                unsigned int line_size,
+                                               patmos::write_policy_e wp,
+                                               bool walloc, unsigned int seed,
+                                               unsigned int victims,
+                                               patmos::prefetch_type pf,
                                                patmos::memory_t &gm)
 {
   unsigned int num_blocks = (size - 1)/line_size + 1;
@@ -156,16 +247,10 @@ static patmos::data_cache_t &create_data_cache(patmos::set_assoc_cache_type dck,
       return *new patmos::ideal_data_cache_t(gm);
     case patmos::SAC_NO:
       return *new patmos::no_data_cache_t(gm);
-    case patmos::SAC_DM:
-      assert(dck.associativity == 1);
-      // Fallthrough to LRU with 1-way assoc to model direct mapped cache
-    case patmos::SAC_LRU:
-      return *new patmos::set_assoc_data_cache_t<true>(gm, assoc, num_blocks, line_size);
-    case patmos::SAC_FIFO:
-      return *new patmos::set_assoc_data_cache_t<false>(gm, assoc, num_blocks, line_size);
+    default:
+      return *create_set_assoc_cache(dck, assoc, num_blocks, line_size,
+                                     wp, walloc, seed, victims, pf, gm);
   };
-
-  abort();
 }
 
 /// Construct a method cache for the simulation.
@@ -199,8 +284,8 @@ static patmos::instr_cache_t &create_method_cache(patmos::method_cache_e mck,
 }
 
 static patmos::instr_cache_t &create_iset_cache(patmos::set_assoc_cache_type isck,
-       unsigned int size, unsigned int line_size,
-       patmos::memory_t &gm)
+       unsigned int size, unsigned int line_size, unsigned int seed,
+       patmos::prefetch_type pf, patmos::memory_t &gm)
 {
   unsigned int num_blocks = ((size - 1)/line_size) + 1;
   // Make it fully-associative?
@@ -212,32 +297,19 @@ static patmos::instr_cache_t &create_iset_cache(patmos::set_assoc_cache_type isc
       return *new patmos::instr_cache_wrapper_t<true>(new patmos::ideal_data_cache_t(gm));
     case patmos::SAC_NO:
       return *new patmos::no_instr_cache_t(gm);
-    case patmos::SAC_DM:
-      assert(isck.associativity == 1);
-      // Fallthrough to LRU with 1-way assoc to model direct mapped cache
-    case patmos::SAC_LRU:
-    {
-      patmos::data_cache_t *lru =
-        new patmos::set_assoc_data_cache_t<true>(gm, assoc, num_blocks, line_size);
-
-      return *new patmos::instr_cache_wrapper_t<true>(lru);
-    }
-    case patmos::SAC_FIFO:
-    {
-      patmos::data_cache_t *fifo =
-        new patmos::set_assoc_data_cache_t<false>(gm, assoc, num_blocks, line_size);
-
-      return *new patmos::instr_cache_wrapper_t<true>(fifo);
-    }
+    default:
+      return *new patmos::instr_cache_wrapper_t<true>(
+                   create_set_assoc_cache(isck, assoc, num_blocks, line_size,
+                                          patmos::WP_THROUGH, false, seed,
+                                          0, pf, gm));
   }
-
-  abort();
 }
 
 static patmos::instr_cache_t &create_instr_cache(patmos::instr_cache_e ick,
        patmos::set_assoc_cache_type isck, patmos::method_cache_e mck,
        unsigned int size, unsigned int line_size, unsigned int block_size,
-       unsigned int mcmethods, unsigned int ispm_size, patmos::memory_t &gm)
+       unsigned int mcmethods, unsigned int ispm_size, unsigned int seed,
+       patmos::prefetch_type pf, patmos::memory_t &gm)
 {
   patmos::instr_cache_t *icache;
   switch (ick) {
@@ -245,14 +317,14 @@ static patmos::instr_cache_t &create_instr_cache(patmos::instr_cache_e ick,
       icache = &create_method_cache(mck, size, block_size, mcmethods, gm);
       break;
     case patmos::IC_ICACHE:
-      icache = &create_iset_cache(isck, size, line_size, gm);
+      icache = &create_iset_cache(isck, size, line_size, seed, pf, gm);
       break;
     default:
       abort();
   }
 
   if (ispm_size > 0) {
-    icache = new patmos::instr_spm_t(gm, icache, ispm_size);
+    icache = new patmos::default_instr_cache_t(gm, icache, ispm_size);
   }
 
   return *icache;
@@ -282,7 +354,7 @@ static patmos::stack_cache_t &create_stack_cache(patmos::stack_cache_e sck,
       // The stack cache always uses a granularity of words for allocation
       unsigned int num_blocks = (size - 1) / 4 + 1;
 
-      return *new patmos::block_stack_cache_t(gm, num_blocks, 4);
+      return *new patmos::default_stack_cache_t(gm, num_blocks, 4);
     }
     case patmos::SC_ABLOCK:
     {
@@ -309,6 +381,152 @@ static patmos::stack_cache_t &create_stack_cache(patmos::stack_cache_e sck,
   abort();
 }
 
+/// A kind of a component stored in a checkpoint, and its description.
+typedef std::pair<uint64_t, const char*> checkpoint_kind_t;
+
+/// Get the kinds of the main memory and the caches, as selected by the
+/// create_* functions. A checkpoint is restored only into components of the
+/// same kinds.
+/// @return The kinds of the components and their descriptions.
+static std::vector<checkpoint_kind_t> get_checkpoint_kinds(
+                                        patmos::main_memory_kind_e gkind,
+                                        unsigned int cores,
+                                        unsigned int gtime, int tdelay,
+                                        unsigned int psize,
+                                        patmos::set_assoc_cache_type dck,
+                                        patmos::instr_cache_e ick,
+                                        patmos::set_assoc_cache_type isck,
+                                        patmos::method_cache_e mck,
+                                        unsigned int ispmsize,
+                                        patmos::stack_cache_e sck)
+{
+  bool ideal = cores == 1 && gtime == 0 && tdelay == 0;
+
+  std::vector<checkpoint_kind_t> kinds;
+  kinds.push_back(checkpoint_kind_t(gkind, "kind of the main memory"));
+  kinds.push_back(checkpoint_kind_t(cores > 1, "main memory arbitration"));
+  kinds.push_back(checkpoint_kind_t(ideal, "ideal main memory"));
+  kinds.push_back(checkpoint_kind_t(!ideal && psize != 0,
+                                    "paged main memory"));
+  kinds.push_back(checkpoint_kind_t(dck.policy, "kind of the data cache"));
+  kinds.push_back(checkpoint_kind_t(ick, "kind of the instruction cache"));
+  kinds.push_back(checkpoint_kind_t(ick == patmos::IC_MCACHE
+                                        ? (uint64_t)mck : (uint64_t)isck.policy,
+                                    "kind of the instruction cache"));
+  kinds.push_back(checkpoint_kind_t(ispmsize > 0, "instruction scratchpad"));
+  kinds.push_back(checkpoint_kind_t(sck, "kind of the stack cache"));
+  return kinds;
+}
+
+/// The streams of a core of a multi-core simulation simulated by several host
+/// threads. The cores share the UART and the debug output through stream
+/// buffers serializing the accesses, each with streams of its own.
+struct core_streams_t
+{
+  std::istream uin;
+  std::ostream uout;
+  std::ostream dout;
+
+  core_streams_t(std::streambuf *uin, std::streambuf *uout,
+                 std::streambuf *dout) :
+    uin(uin), uout(uout), dout(dout)
+  {
+  }
+};
+
+/// An additional core of a multi-core simulation, i.e., a core other than
+/// core 0. All cores access the same global memory content through their own
+/// TDM port and share the NOC SPM, everything else is private to the core.
+struct core_t
+{
+  patmos::memory_t &gm;
+  patmos::instr_cache_t &ic;
+  patmos::data_cache_t &dc;
+  patmos::stack_cache_t &sc;
+
+  patmos::excunit_t excunit;
+  patmos::ideal_memory_t lm;
+  patmos::memory_map_t mm;
+  patmos::simulator_t s;
+
+  patmos::rtc_t rtc;
+  patmos::cpuinfo_t cpuinfo;
+  patmos::perfcounters_t perfcounters;
+  patmos::uart_t uart;
+  patmos::led_t leds;
+  patmos::deadline_t deadline;
+  patmos::noc_t noc;
+
+  /// Construct the core, reading the device configuration from the
+  /// command-line options.
+  /// @param vm The command-line options.
+  /// @param cpu_id The ID of the core.
+  /// @param gm The port of the core to the global memory.
+  /// @param ic The instruction cache of the core.
+  /// @param dc The data cache of the core.
+  /// @param sc The stack cache of the core.
+  /// @param nm The shared NOC SPM.
+  core_t(const boost::program_options::variables_map &vm, unsigned int cpu_id,
+         patmos::memory_t &gm, patmos::instr_cache_t &ic,
+         patmos::data_cache_t &dc, patmos::stack_cache_t &sc,
+         patmos::memory_t &nm, patmos::symbol_map_t &sym,
+         std::istream &uin, bool uin_istty, std::ostream &uout) :
+    gm(gm), ic(ic), dc(dc), sc(sc),
+    excunit(mmbase(vm) + address(vm, "excunit_offset")),
+    lm(vm["lsize"].as<patmos::byte_size_t>().value(), false,
+       vm["chkreads"].as<patmos::mem_check_e>()),
+    mm(lm, std::min(mmbase(vm), address(vm, "nocbase")),
+       address(vm, "mmhigh")),
+    s(vm["freq"].as<double>(), gm, mm, dc, ic, sc, sym, excunit,
+      vm.count("permissive-dual-issue") != 0),
+    rtc(s, mmbase(vm) + address(vm, "timer_offset"), vm["freq"].as<double>()),
+    cpuinfo(mmbase(vm) + address(vm, "cpuinfo_offset"), cpu_id,
+            vm["freq"].as<double>(), vm["cores"].as<unsigned int>()),
+    perfcounters(mmbase(vm) + address(vm, "perfcounters_offset")),
+    uart(mmbase(vm) + address(vm, "uart_offset"), uin, uin_istty, uout),
+    leds(mmbase(vm) + address(vm, "led_offset"), uout),
+    deadline(mmbase(vm) + address(vm, "deadline_offset")),
+    noc(address(vm, "nocbase"),
+        address(vm, "nocbase") + address(vm, "noc_route_offset"),
+        address(vm, "nocbase") + address(vm, "noc_st_offset"),
+        address(vm, "nocbase") + address(vm, "noc_spm_offset"),
+        vm["nocsize"].as<patmos::byte_size_t>().value(), nm)
+  {
+    bool debug_intrs = vm.count("debug-intrs") > 0;
+    excunit.enable_interrupts(vm["interrupt"].as<int>() > 0);
+    excunit.enable_debug(debug_intrs);
+    rtc.enable_debug(debug_intrs);
+
+    mm.add_device(cpuinfo);
+    mm.add_device(excunit);
+    mm.add_device(perfcounters);
+    mm.add_device(uart);
+    mm.add_device(leds);
+    mm.add_device(deadline);
+    mm.add_device(rtc);
+    mm.add_device(noc);
+  }
+
+  ~core_t()
+  {
+    delete &gm;
+    delete &dc;
+    delete &ic;
+    delete &sc;
+  }
+
+  static unsigned int address(const boost::program_options::variables_map &vm,
+                              const char *name)
+  {
+    return vm[name].as<patmos::address_t>().value();
+  }
+
+  static unsigned int mmbase(const boost::program_options::variables_map &vm)
+  {
+    return address(vm, "mmbase");
+  }
+};
+
 /// Disable the line buffering
 void disable_line_buffering()
 {
@@ -331,150 +549,49 @@ void disable_line_buffering()
   }
 }
 
-int main(int argc, char **argv)
-{
-  // We disable line buffering to ensure output is always
-  // produced immediately. Without this, pasim might exit
-  // without flushing its output buffer.
-  disable_line_buffering();
-  
-  // define command-line options
-  boost::program_options::options_description generic_options(
-    "Generic options:\n for memory/cache sizes the following units are allowed:"
-    " k, m, g, or kb, mb, gb");
-  generic_options.add_options()
-    ("help,h", "produce help message")
-    ("maxc,c", boost::program_options::value<unsigned int>()->default_value(0, "inf."), "stop simulation after the given number of cycles")
-    ("binary,b", boost::program_options::value<std::string>(), "binary or elf-executable file (stdin: -)")
-    ("debug", boost::program_options::value<unsigned int>()->implicit_value(0), "enable step-by-step debug tracing after cycle")
-    ("debug-fmt", boost::program_options::value<patmos::debug_format_e>()->default_value(patmos::DF_DEFAULT),
-                  "format of the debug trace (short, trace, instr, blocks, calls, calls-indent, default, long, all)")
-    ("debug-file", boost::program_options::value<std::string>()->default_value(""), "output debug trace in file (stdout: -)")
-    ("debug-cache", boost::program_options::value<patmos::debug_cache_e>()->default_value(patmos::DC_NONE),
-                  "Print all cache updates (=none,miss,all)")
-    ("debug-intrs", "print out all status changes of the exception unit.")
-    ("debug-nopc", "do not print PC and cycles counter in debug output")
-    ("debug-access", boost::program_options::value<patmos::address_t>(), "print accesses to the given address or symbol.")
-    ("wpfile", boost::program_options::value<std::string>()->default_value(""), "only print trace for watchpoints provided in the given file.")
-    ("stats-file,o", boost::program_options::value<std::string>()->default_value(""), "write statistics to a file (stdout: -)")
-    ("print-stats", boost::program_options::value<patmos::address_t>(), "print statistics for a given function only.")
-    ("flush-caches", boost::program_options::value<patmos::address_t>(), "flush all caches when reaching the given address (can be a symbol name).")
-    ("hitmiss-stats", "Print hit/miss cache accesses (requires '--full')")
-    ("full,V", "full statistics output")
-    ("verbose,v", "enable short statistics output");
-
-  boost::program_options::options_description memory_options("Memory options");
-  memory_options.add_options()
-#ifdef RAMULATOR
-    ("gkind,R", boost::program_options::value<patmos::main_memory_kind_e>()->default_value(patmos::GM_SIMPLE), "kind of main memory (simple, ddr3, ddr4, lpddr3, lpddr4)")
-#endif // RAMULATOR
-    ("gsize,g",  boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_MEMORY_BYTES), "global memory size in bytes.")
-    ("gtime,G",  boost::program_options::value<unsigned int>()->default_value(patmos::NUM_MEMORY_TRANSFER_LATENCY),
-                 "global memory transfer time per burst in cycles")
-    ("tdelay,t", boost::program_options::value<int>()->default_value(0), "read delay to global memory per request in cycles.")
-    ("trefresh", boost::program_options::value<unsigned int>()->default_value(0), "refresh cycles per TDM round.")
-    ("bsize",    boost::program_options::value<unsigned int>()->default_value(patmos::NUM_MEMORY_BLOCK_BYTES), "burst size (and alignment) of the memory system.")
-    ("psize",    boost::program_options::value<patmos::byte_size_t>()->default_value(0), "Memory page size. Enables variable burst lengths for single-core.")
-    ("posted,p", boost::program_options::value<unsigned int>()->default_value(0), "Enable posted writes (sets max queue size)")
-    ("ispmsize", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_ISPM_MEMORY_BYTES), "instruction SPM size in bytes, 0 to disable.")
-    ("lsize,l",  boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_LOCAL_MEMORY_BYTES), "local data memory size in bytes.")
-    ("mem-rand", boost::program_options::value<unsigned int>()->default_value(0), "Initialize memories with random data.")
-    ("chkreads", boost::program_options::value<patmos::mem_check_e>()->default_value(patmos::MCK_NONE),
-                 "Check for reads of uninitialized data, either per byte (warn, err) or per access (warn-addr, err-addr). Disables the data cache.")
-    ("with-mmu", boost::program_options::value<bool>()->default_value(false), "Simulate memory management unit.")
-#ifdef RAMULATOR
-    ("ramul-config", boost::program_options::value<std::string>()->default_value(""), "name of ramulator configuration file.")
-#endif // RAMULATOR
-;
-
-  boost::program_options::options_description noc_options("Network-on-chip options");
-  noc_options.add_options()
-    ("nocbase",          boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_BASE_ADDRESS), "base address of the NOC device map address range")
-    ("noc_route_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_DMA_P_OFFSET), "offset of the NOC routing information device map")
-    ("noc_st_offset",    boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_DMA_ST_OFFSET), "offset of the NOC slot table device map")
-    ("noc_spm_offset",   boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_SPM_OFFSET), "offset of the NOC SPM")
-    ("nocsize",          boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NOC_SPM_SIZE),   "size of the NOC SPM");
-
-  boost::program_options::options_description cache_options("Cache options");
-  cache_options.add_options()
-    ("dcsize,d", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_DATA_CACHE_BYTES), "data cache size in bytes")
-    ("dckind,D", boost::program_options::value<patmos::set_assoc_cache_type>()->default_value(patmos::set_assoc_cache_type(patmos::SAC_DM,1)),
-                 "kind of direct mapped/fully-/set-associative data cache (ideal, no, dm, lru[N], fifo[N])")
-    ("dlsize",   boost::program_options::value<patmos::byte_size_t>()->default_value(0), "size of a data cache line in bytes, defaults to burst size if set to 0")
-
-    ("scsize,s", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_STACK_CACHE_BYTES), "stack cache size in bytes")
-    ("sckind,S", boost::program_options::value<patmos::stack_cache_e>()->default_value(patmos::SC_BLOCK), "kind of stack cache (ideal, block, ablock, lblock, dcache)")
-
-    ("icache,C", boost::program_options::value<patmos::instr_cache_e>()->default_value(patmos::IC_MCACHE), "kind of instruction cache (mcache, icache)")
-    ("ickind,K", boost::program_options::value<patmos::set_assoc_cache_type>()->default_value(patmos::set_assoc_cache_type(patmos::SAC_LRU,2)),
-                 "kind of direct mapped/fully-/set-associative I-cache (ideal, no, dm, lru[N], fifo[N]")
-    ("ilsize",   boost::program_options::value<patmos::byte_size_t>()->default_value(0), "size of an I-cache line in bytes, defaults to burst size if set to 0")
+/// Serializes the accesses to loaders, which are shared by batch runs.
+static std::mutex Loader_mutex;
 
-    ("mcsize,m", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_METHOD_CACHE_BYTES),
-                 "method cache / instruction cache size in bytes")
-    ("mckind,M", boost::program_options::value<patmos::method_cache_e>()->default_value(patmos::MC_FIFO), "kind of method cache (ideal, lru, fifo)")
-    ("mcmethods",boost::program_options::value<unsigned int>()->default_value(patmos::NUM_METHOD_CACHE_MAX_METHODS),
-                 "Maximum number of methods in the method cache, defaults to number of blocks if zero")
-    ("mbsize",   boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_METHOD_CACHE_BLOCK_BYTES),
-                 "method cache block size in bytes, defaults to burst size if zero");
+/// A simulation run of the batch mode.
+struct batch_job_t
+{
+  /// The name of the simulated binary.
+  std::string Binary;
 
-  boost::program_options::options_description sim_options("Simulator options");
-  sim_options.add_options()
-    ("cpuid",  boost::program_options::value<unsigned int>()->default_value(0), "Set CPU ID in the simulator")
-    ("cores,N", boost::program_options::value<unsigned int>()->default_value(1), "Set number of CPUs (enables memory TDM)")
-    ("freq",   boost::program_options::value<double>()->default_value(80.0), "Set CPU Frequency in Mhz")
-    ("mmbase", boost::program_options::value<patmos::address_t>()->default_value(patmos::IOMAP_BASE_ADDRESS), "base address of the IO device map address range")
-    ("mmhigh", boost::program_options::value<patmos::address_t>()->default_value(patmos::IOMAP_HIGH_ADDRESS), "highest address of the IO device map address range")
-    ("cpuinfo_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::CPUINFO_OFFSET), "offset where the cpuinfo device is mapped")
-    ("excunit_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::EXCUNIT_OFFSET), "offset where the exception unit is mapped")
-    ("timer_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::TIMER_OFFSET), "offset where the timer device is mapped")
-    ("perfcounters_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::PERFCOUNTERS_OFFSET), "offset where the performance counters device is mapped")
-    ("mmu_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::MMU_OFFSET), "offset where the memory management unit is mapped")
-    ("uart_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::UART_OFFSET), "offset where the UART device is mapped")
-    ("led_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::LED_OFFSET), "offset where the LED device is mapped")
-    ("deadline_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::DEADLINE_OFFSET), "offset where the deadline device is mapped")
-    ("ethmac_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::ETHMAC_OFFSET), "offset where the EthMac device is mapped")
-    ("ethmac_ip_addr", boost::program_options::value<std::string>()->default_value(""), "Provide virtual network interface with the given IP address")
-    ("permissive-dual-issue", "Enables instructions in the second issue slot that are otherwise prohibited (e.g. loads, stores, branches). Some restrictions apply, which require some instruction combinations to not be enabled simultaneously (e.g. 2 loads).");
+  /// The index of the configuration in the batch file.
+  unsigned int Config;
 
-  boost::program_options::options_description uart_options("UART options");
-  uart_options.add_options()
-    ("in,I", boost::program_options::value<std::string>()->default_value("-"), "input file for UART simulation (stdin: -)")
-    ("out,O", boost::program_options::value<std::string>()->default_value("-"), "output file for UART simulation (stdout: -)");
+  /// The loader of the binary, shared by all runs of the binary.
+  patmos::loader_t *Loader;
 
-  boost::program_options::options_description interrupt_options("Interrupt options");
-  interrupt_options.add_options()
-    ("interrupt", boost::program_options::value<int>()->default_value(1), "enable or disable interrupts");
+  /// The options of the run.
+  boost::program_options::variables_map Options;
 
-  boost::program_options::positional_options_description pos;
-  pos.add("binary", 1);
+  /// The outcome of the run (halt, maxc, or error).
+  std::string Status;
 
-  boost::program_options::options_description cmdline_options;
-  cmdline_options.add(generic_options).add(memory_options).add(cache_options)
-                 .add(noc_options).add(sim_options).add(uart_options)
-                 .add(interrupt_options);
+  /// The exit code of the program.
+  int Exit_code;
 
-  // process command-line options
-  boost::program_options::variables_map vm;
-  try
-  {
-    boost::program_options::store(
-                          boost::program_options::command_line_parser(argc, argv)
-                            .options(cmdline_options).positional(pos).run(), vm);
-    boost::program_options::notify(vm);
+  /// The names and final values of the counters of the simulators.
+  std::vector<std::pair<std::string, uint64_t> > Counters;
 
-    // help message
-    if (vm.count("help")) {
-      std::cout << cmdline_options << "\n";
-      return 1;
-    }
-  }
-  catch(boost::program_options::error &e)
+  batch_job_t(const std::string &binary, unsigned int config,
+              patmos::loader_t *loader) :
+    Binary(binary), Config(config), Loader(loader), Status("error"),
+    Exit_code(-1)
   {
-    std::cerr << cmdline_options << "\n" << e.what() << "\n\n";
-    return 1;
   }
-
+};
+
+/// Simulate a program with the given options.
+/// @param vm The command-line options.
+/// @param job The batch run to simulate, or NULL to simulate the binary given
+/// by the options.
+/// @return The exit code of the program, or -1 in case of an error.
+static int simulate(const boost::program_options::variables_map &vm,
+                    batch_job_t *job)
+{
   // get some command-line  options
   std::string binary;
   if (vm.count("binary")) {
@@ -484,6 +601,13 @@ int main(int argc, char **argv)
     return 1;
   }
   std::string stats_out(vm["stats-file"].as<std::string>());
+  uint64_t stats_interval = vm["stats-interval"].as<uint64_t>();
+  std::string interval_out(vm["stats-interval-file"].as<std::string>());
+  patmos::stats_format_e interval_fmt =
+                      vm["stats-interval-format"].as<patmos::stats_format_e>();
+  bool self_profile = vm.count("self-profile") && !job;
+  unsigned int self_profile_interval = self_profile ?
+                                 vm["self-profile"].as<unsigned int>() : 0;
 
   std::string uart_in(vm["in"].as<std::string>());
   std::string uart_out(vm["out"].as<std::string>());
@@ -513,10 +637,55 @@ int main(int argc, char **argv)
   unsigned int ethmac_offset = vm["ethmac_offset"].as<patmos::address_t>().value();
   std::string  ethmac_ip_addr = vm["ethmac_ip_addr"].as<std::string>();
   bool permissive_dual_issue = vm.count("permissive-dual-issue") != 0;
+  patmos::engine_e engine = vm["engine"].as<patmos::engine_e>();
+  bool multicore = vm.count("multicore") != 0;
+  patmos::sync_e sync = vm["sync"].as<patmos::sync_e>();
+  unsigned int quantum = vm["quantum"].as<unsigned int>();
+  unsigned int threads = vm["threads"].as<unsigned int>();
+  bool with_mmu = vm["with-mmu"].as<bool>();
+  bool checkpoint = vm.count("checkpoint-at") != 0;
+  patmos::sim_point_t checkpoint_at;
+  if (checkpoint) {
+    checkpoint_at = vm["checkpoint-at"].as<patmos::sim_point_t>();
+  }
+  std::string checkpoint_file = vm["checkpoint-file"].as<std::string>();
+  std::string restore_file = vm.count("restore") ?
+                                     vm["restore"].as<std::string>() : "";
+
+  if (checkpoint && job) {
+    std::cerr << "Checkpoints cannot be written with --batch.\n";
+    return 1;
+  }
+
+  if (multicore) {
+    if (with_mmu) {
+      std::cerr << "The MMU is not supported with --multicore.\n";
+      return 1;
+    }
+    if (checkpoint || !restore_file.empty()) {
+      std::cerr << "Checkpoints are not supported with --multicore.\n";
+      return 1;
+    }
+    if (vm.count("warmup-until") || vm.count("warmup-instrs")) {
+      std::cerr << "The functional warm-up is not supported with --multicore.\n";
+      return 1;
+    }
+    if (vm["debug-fmt"].as<patmos::debug_format_e>() == patmos::DF_BTRACE) {
+      std::cerr << "The binary trace is not supported with --multicore.\n";
+      return 1;
+    }
+    if (vm["dcwrite"].as<patmos::write_policy_e>() == patmos::WP_BACK) {
+      std::cerr << "The write-back data cache is not coherent and not "
+                   "supported with --multicore.\n";
+      return 1;
+    }
+    // the cores are numbered from 0 on
+    cpuid = 0;
+  }
 
 
 #ifdef RAMULATOR
-  patmos::main_memory_kind_e gkind = patmos::GM_SIMPLE;
+  patmos::main_memory_kind_e gkind =
                                    vm["gkind"].as<patmos::main_memory_kind_e>();
 #else
   patmos::main_memory_kind_e gkind = patmos::GM_SIMPLE;
@@ -545,6 +714,12 @@ int main(int argc, char **argv)
   unsigned int trefresh = vm["trefresh"].as<unsigned int>();
 
   patmos::set_assoc_cache_type dck = vm["dckind"].as<patmos::set_assoc_cache_type>();
+  patmos::write_policy_e dcwrite = vm["dcwrite"].as<patmos::write_policy_e>();
+  bool dcalloc = vm.count("dcalloc") > 0;
+  unsigned int cseed = vm["cseed"].as<unsigned int>();
+  unsigned int dcvictim = vm["dcvictim"].as<unsigned int>();
+  patmos::prefetch_type dcprefetch = vm["dcprefetch"].as<patmos::prefetch_type>();
+  patmos::prefetch_type icprefetch = vm["icprefetch"].as<patmos::prefetch_type>();
   patmos::stack_cache_e sck = vm["sckind"].as<patmos::stack_cache_e>();
   patmos::instr_cache_e ick = vm["icache"].as<patmos::instr_cache_e>();
   patmos::method_cache_e mck = vm["mckind"].as<patmos::method_cache_e>();
@@ -582,14 +757,28 @@ int main(int argc, char **argv)
     flush_caches_addr = vm["flush-caches"].as<patmos::address_t>();
   }
 
+  bool warmup_until = vm.count("warmup-until") > 0;
+  patmos::address_t warmup_addr(std::numeric_limits<unsigned int>::max());
+  if (warmup_until) {
+    warmup_addr = vm["warmup-until"].as<patmos::address_t>();
+  }
+  uint64_t warmup_instrs = vm.count("warmup-instrs") ?
+                               vm["warmup-instrs"].as<uint64_t>() :
+                               std::numeric_limits<uint64_t>::max();
+  bool warmup = warmup_until || vm.count("warmup-instrs");
+
   bool excunit_enabled = vm["interrupt"].as<int>() > 0;
 
   bool randomize_mem = vm["mem-rand"].as<unsigned int>() > 0;
   patmos::mem_check_e chkreads = vm["chkreads"].as<patmos::mem_check_e>();
 
   bool hitmiss_stats = (vm.count("hitmiss-stats") != 0);
+  patmos::stats_format_e stats_format =
+                               vm["stats-format"].as<patmos::stats_format_e>();
   bool long_stats = (vm.count("full") != 0);
-  bool verbose = (vm.count("verbose") != 0) || long_stats;
+  // statistics in a format for scripts are wanted even without -v
+  bool verbose = (vm.count("verbose") != 0) || long_stats ||
+                 stats_format != patmos::SF_TEXT;
 
   if (!mbsize) mbsize = bsize;
 
@@ -612,9 +801,26 @@ int main(int argc, char **argv)
 
   std::ostream *dout = NULL;
 
-  // Seed rand with a fixed value so that every simulation run produces the same
-  // results.
-  srand(0);
+  // the time series of the statistics, batch runs do not sample
+  std::ostream *iout = NULL;
+  patmos::stats_sampler_t *sampler = NULL;
+
+  // the debug file and the sink writing to it in the background
+  std::ostream *dfile = NULL;
+  patmos::debug_sink_t *dsink = NULL;
+
+  // batch runs get no UART input and discard all output
+  std::istringstream no_input;
+  std::ostream no_output(NULL);
+
+  // the cores other than core 0 in a multi-core simulation
+  std::vector<core_t*> others;
+
+  // the streams of all cores when several threads simulate the cores
+  patmos::synchronized_streambuf_t *sync_uin = NULL;
+  patmos::synchronized_streambuf_t *sync_uout = NULL;
+  patmos::synchronized_streambuf_t *sync_dout = NULL;
+  std::vector<core_streams_t*> core_streams;
 
   // setup simulation framework
   patmos::memory_t &gm = create_global_memory(gkind, freq, cores, cpuid, gsize,
@@ -625,26 +831,62 @@ int main(int argc, char **argv)
   patmos::instr_cache_t &ic = create_instr_cache(ick, isck, mck, mcsize,
                                                  ilsize ? ilsize : bsize,
                                                  mbsize, mcmethods,
-                                                 ispmsize, gm);
+                                                 ispmsize, cseed, icprefetch,
+                                                 gm);
   patmos::data_cache_t &dc = create_data_cache(dck, dcsize,
-                                               dlsize ? dlsize : bsize, gm);
+                                               dlsize ? dlsize : bsize,
+                                               dcwrite, dcalloc, cseed,
+                                               dcvictim, dcprefetch, gm);
   patmos::stack_cache_t &sc = create_stack_cache(sck, scsize, bsize, gm, dc);
 
   try
   {
     // open streams
-    in = patmos::get_stream<std::ifstream>(binary, std::cin);
-
-    uin = patmos::get_stream<std::ifstream>(uart_in, std::cin);
-    uout = patmos::get_stream<std::ofstream>(uart_out, std::cout);
-
-    dout = patmos::get_stream<std::ofstream>(debug_out, std::cerr);
-    sout = patmos::get_stream<std::ofstream>(stats_out, std::cerr);
+    if (job) {
+      uin = &no_input;
+      uout = dout = sout = &no_output;
+    } else {
+      in = patmos::get_stream<std::ifstream>(binary, std::cin);
+
+      uin = patmos::get_stream<std::ifstream>(uart_in, std::cin);
+      uout = patmos::get_stream<std::ofstream>(uart_out, std::cout);
+
+      dout = patmos::get_stream<std::ofstream>(debug_out, std::cerr);
+      sout = patmos::get_stream<std::ofstream>(stats_out, std::cerr);
+
+      if (stats_interval)
+        iout = patmos::get_stream<std::ofstream>(interval_out, std::cerr);
+
+      // format and write the debug output to a file in a background thread,
+      // if there is a host CPU to spare and a single simulation thread
+      // writes to it
+      if (debug_out != "" && debug_out != "-" &&
+          std::thread::hardware_concurrency() > 1 &&
+          !(multicore && threads > 1)) {
+        dfile = dout;
+        dsink = new patmos::debug_sink_t(*dfile);
+        dout = new std::ostream(dsink);
+      }
+    }
 
     // check if the uart input stream is a tty.
     bool uin_istty = (uin == &std::cin) && isatty(STDIN_FILENO);
 
-    assert(in && sout && uin && uout && dout);
+    assert((in || job) && sout && uin && uout && dout);
+
+    if (multicore && threads > 1) {
+      sync_uin = new patmos::synchronized_streambuf_t(uin->rdbuf());
+      sync_uout = new patmos::synchronized_streambuf_t(uout->rdbuf());
+      sync_dout = new patmos::synchronized_streambuf_t(dout->rdbuf());
+      for(unsigned int i = 0; i < cores; i++)
+        core_streams.push_back(new core_streams_t(sync_uin, sync_uout,
+                                                  sync_dout));
+    }
+
+    // the streams of core 0
+    std::istream &uin0 = core_streams.empty() ? *uin : core_streams[0]->uin;
+    std::ostream &uout0 = core_streams.empty() ? *uout : core_streams[0]->uout;
+    std::ostream &dout0 = core_streams.empty() ? *dout : core_streams[0]->dout;
 
     // finalize simulation framework
     // setup exception unit
@@ -657,6 +899,11 @@ int main(int argc, char **argv)
     patmos::ideal_memory_t nm(nocsize, false, patmos::MCK_NONE);
     patmos::memory_map_t mm(lm, std::min(mmbase,nocbase), mmhigh);
 
+    // the cores access the NOC SPM in turns when simulated by several threads
+    if (multicore) {
+      nm.share_with_cores();
+    }
+
     patmos::symbol_map_t sym;
 
     patmos::simulator_t s(freq, gm, mm, dc, ic, sc, sym, excunit, permissive_dual_issue);
@@ -667,8 +914,9 @@ int main(int argc, char **argv)
     stats_options.instruction_stats = long_stats;
     stats_options.profiling_stats = long_stats;
     stats_options.hitmiss_stats = hitmiss_stats;
+    stats_options.format = stats_format;
     stats_options.debug_cache = debug_cache;
-    stats_options.debug_out = dout;
+    stats_options.debug_out = &dout0;
 
     // set up timer device
     patmos::rtc_t rtc(s, mmbase+timer_offset, freq);
@@ -677,8 +925,8 @@ int main(int argc, char **argv)
     // setup IO mapped devices
     patmos::cpuinfo_t cpuinfo(mmbase+cpuinfo_offset, cpuid, freq, cores);
     patmos::perfcounters_t perfcounters(mmbase+perfcounters_offset);
-    patmos::uart_t uart(mmbase+uart_offset, *uin, uin_istty, *uout);
-    patmos::led_t leds(mmbase+led_offset, *uout);
+    patmos::uart_t uart(mmbase+uart_offset, uin0, uin_istty, uout0);
+    patmos::led_t leds(mmbase+led_offset, uout0);
     patmos::deadline_t deadline(mmbase+deadline_offset);
     patmos::ethmac_t ethmac(mmbase+ethmac_offset, ethmac_ip_addr);
     patmos::noc_t noc(nocbase, nocbase+noc_route_offset, nocbase+noc_st_offset,
@@ -695,19 +943,56 @@ int main(int argc, char **argv)
     mm.add_device(noc);
 
     // add MMU to simulation
-    bool with_mmu = vm["with-mmu"].as<bool>();
     if (with_mmu) {
       patmos::mmu_t mmu(mmbase+mmu_offset, &excunit);
       mm.add_device(mmu);
       gm.set_mmu(&mmu);
     }
 
+    // set up the other cores, each with its own port to the global memory
+    std::vector<patmos::simulator_t*> sims(1, &s);
+    for(unsigned int i = 1; multicore && i < cores; i++)
+    {
+      patmos::memory_t &cgm = create_global_memory(gkind, freq, cores, i,
+                                                   gsize, bsize, psize, posted,
+                                                   gtime, tdelay, trefresh,
+                                                   randomize_mem, chkreads,
+                                                   ramul_config);
+      static_cast<patmos::ideal_memory_t&>(cgm).share_content(
+                                        static_cast<patmos::ideal_memory_t&>(gm));
+      patmos::instr_cache_t &cic = create_instr_cache(ick, isck, mck, mcsize,
+                                                      ilsize ? ilsize : bsize,
+                                                      mbsize, mcmethods,
+                                                      ispmsize, cseed,
+                                                      icprefetch, cgm);
+      patmos::data_cache_t &cdc = create_data_cache(dck, dcsize,
+                                                    dlsize ? dlsize : bsize,
+                                                    dcwrite, dcalloc, cseed,
+                                                    dcvictim, dcprefetch, cgm);
+      patmos::stack_cache_t &csc = create_stack_cache(sck, scsize, bsize,
+                                                      cgm, cdc);
+
+      if (core_streams.empty()) {
+        others.push_back(new core_t(vm, i, cgm, cic, cdc, csc, nm, sym,
+                                    *uin, uin_istty, *uout));
+        others.back()->s.Dbg_stack.get_stats_options() = stats_options;
+      } else {
+        others.push_back(new core_t(vm, i, cgm, cic, cdc, csc, nm, sym,
+                                    core_streams[i]->uin, uin_istty,
+                                    core_streams[i]->uout));
+        others.back()->s.Dbg_stack.get_stats_options() = stats_options;
+        others.back()->s.Dbg_stack.get_stats_options().debug_out =
+                                                     &core_streams[i]->dout;
+      }
+      sims.push_back(&others.back()->s);
+    }
+
     // load input program
     patmos::section_list_t text;
-    patmos::loader_t *loader = patmos::create_loader(*in);
+    patmos::loader_t *loader = job ? job->Loader : patmos::create_loader(*in);
     patmos::uword_t entry = loader->get_program_entry();
 
-    if (!loader->is_ELF()) {
+    if (!job && !loader->is_ELF()) {
       // some output for compatibility
       std::cerr << boost::format("Loaded: %1% bytes\n")
                    % loader->get_binary_size();
@@ -715,6 +1000,9 @@ int main(int argc, char **argv)
 
     try
     {
+      // batch runs share the loader of a binary
+      std::lock_guard<std::mutex> lock(Loader_mutex);
+
       loader->load_symbols(sym, text);
       loader->load_to_memory(s, gm);
     }
@@ -736,31 +1024,135 @@ int main(int argc, char **argv)
 
     if (debug_accesses) {
       debug_access_addr.parse(sym);
-      s.Debug_mem_address.insert(debug_access_addr.value());
     }
-
-    // setup stats reset trigger
     if (print_stats) {
       print_stats_func.parse(sym);
-      s.Dbg_stack.print_function_stats(print_stats_func.value(), *sout);
-    }
-
-    if (!wpfile.empty()) {
-      s.read_watchpoint_file(wpfile);
     }
-
     if (flush_caches) {
       flush_caches_addr.parse(sym);
-      s.flush_caches_at(flush_caches_addr.value());
+    }
+    if (warmup_until &&
+        warmup_addr.parse(sym) == std::numeric_limits<unsigned int>::max()) {
+      std::cerr << "Unknown symbol for --warmup-until.\n";
+      goto _cleanup;
     }
 
-    // start execution
-    bool success = false;
-    try
+    for(unsigned int i = 0; i < sims.size(); i++)
     {
-      s.run(entry, debug_cycle, debug_fmt, *dout, debug_nopc,
-            max_cycle, long_stats);
-      success = true;
+      if (debug_accesses) {
+        sims[i]->debug_mem_address(debug_access_addr.value());
+      }
+
+      // setup stats reset trigger
+      if (print_stats) {
+        sims[i]->Dbg_stack.print_function_stats(print_stats_func.value(),
+                                                *sout);
+      }
+
+      if (!wpfile.empty()) {
+        sims[i]->read_watchpoint_file(wpfile);
+      }
+
+      if (flush_caches) {
+        sims[i]->flush_caches_at(flush_caches_addr.value());
+      }
+
+      if (dsink) {
+        sims[i]->trace_to(*dsink);
+      }
+
+      sims[i]->set_engine(engine);
+    }
+
+    // continue from a checkpoint, the cycle limit refers to the whole run
+    uint64_t num_cycles = max_cycle;
+    std::vector<checkpoint_kind_t> checkpoint_kinds =
+        get_checkpoint_kinds(gkind, cores, gtime, tdelay, psize, dck, ick,
+                             isck, mck, ispmsize, sck);
+    if (!restore_file.empty()) {
+      patmos::checkpoint_reader_t cr(restore_file);
+      for (unsigned int i = 0; i < checkpoint_kinds.size(); i++) {
+        cr.check_config(checkpoint_kinds[i].first, checkpoint_kinds[i].second);
+      }
+      s.restore_state(cr);
+      cr.finish();
+
+      if (max_cycle != std::numeric_limits<uint64_t>::max()) {
+        num_cycles = max_cycle - std::min(max_cycle, s.Cycle);
+      }
+    }
+
+    // stop when reaching the checkpoint
+    if (checkpoint) {
+      if (checkpoint_at.is_symbol()) {
+        patmos::word_t address = sym.find(checkpoint_at.symbol());
+        if (address == -1) {
+          std::cerr << boost::format("Unknown symbol for --checkpoint-at: %1%\n")
+                       % checkpoint_at.symbol();
+          goto _cleanup;
+        }
+        s.stop_at(address);
+      }
+      else {
+        num_cycles = std::min(num_cycles, checkpoint_at.cycle() -
+                                 std::min(checkpoint_at.cycle(), s.Cycle));
+      }
+    }
+
+    // start execution
+    bool success = false;
+    bool halted = false;
+    patmos::multicore_t mc(sync, quantum, threads);
+    patmos::self_profile_t profile(self_profile_interval);
+    try
+    {
+      // batch runs do not print the statistics per instruction
+      bool collect_instr_stats = long_stats && !job;
+
+      // execute functionally up to the part to simulate in detail, the cycles
+      // of the warm-up count for the cycle limits.
+      if (warmup) {
+        uint64_t start_cycle = s.Cycle;
+        s.warm_up(entry, warmup_addr.value(), warmup_instrs, num_cycles);
+        s.reset_stats();
+
+        if (num_cycles != std::numeric_limits<uint64_t>::max()) {
+          num_cycles -= s.Cycle - start_cycle;
+        }
+      }
+
+      // sample the counters of all cores along the cycles of core 0
+      if (iout) {
+        sampler = new patmos::stats_sampler_t(*iout, interval_fmt,
+                                              stats_interval);
+        if (others.empty())
+          s.add_counters(sampler->get_counters());
+        else {
+          for(unsigned int i = 0; i < sims.size(); i++)
+            sims[i]->add_counters(sampler->get_counters(),
+                                  (boost::format("core%1%.") % i).str());
+        }
+        s.sample_stats(*sampler);
+      }
+
+      // measure the host time of the cycle-accurate simulation of core 0
+      if (self_profile) {
+        s.self_profile(profile);
+        profile.start(s.Cycle, s.Num_retired);
+      }
+
+      if (others.empty()) {
+        s.run(entry, debug_cycle, debug_fmt, *dout, debug_nopc,
+              num_cycles, collect_instr_stats);
+      } else {
+        for(unsigned int i = 0; i < sims.size(); i++)
+          mc.add_core(*sims[i], core_streams.empty() ? NULL :
+                                                   &core_streams[i]->dout);
+
+        mc.run(entry, debug_cycle, debug_fmt, *dout, debug_nopc,
+               max_cycle, collect_instr_stats);
+      }
+      success = true;
     }
     catch (patmos::simulation_exception_t e)
     {
@@ -770,18 +1162,88 @@ int main(int argc, char **argv)
           // get the exit code
           exit_code = e.get_info();
           success = true;
+          halted = true;
           break;
         default:
+          if (job) {
+            std::cerr << boost::format("%1%, configuration %2%: ")
+                       % binary % job->Config;
+          }
+          if (!others.empty()) {
+            std::cerr << boost::format("Core %1%: ") % mc.get_failed_core();
+          }
           std::cerr << e.to_string(sym);
-	  std::cerr << s.Dbg_stack;
+	  std::cerr << sims[mc.get_failed_core()]->Dbg_stack;
+      }
+    }
+
+    if (self_profile) {
+      profile.stop(s.Cycle, s.Num_retired);
+    }
+
+    // write the checkpoint once it is reached, a program halting before
+    // the checkpoint fails the run
+    if (success && checkpoint) {
+      if (!halted && (checkpoint_at.is_symbol() ? s.PC == s.Stop_PC
+                                       : s.Cycle == checkpoint_at.cycle())) {
+        patmos::checkpoint_writer_t cw(checkpoint_file);
+        for (unsigned int i = 0; i < checkpoint_kinds.size(); i++) {
+          cw.write_config(checkpoint_kinds[i].first);
+        }
+        s.save_state(cw);
+        cw.finish();
+      }
+      else {
+        std::cerr << boost::format("Checkpoint %1% not reached.\n")
+                     % checkpoint_at;
+        success = false;
+        exit_code = -1;
       }
     }
 
-    if (success) {
-      if (verbose && !print_stats) {
-        s.print_stats(*sout);
+    if (job) {
+      job->Exit_code = exit_code;
+
+      // copy the counters, the simulators do not outlive the run
+      patmos::stats_counters_t counters;
+      for(unsigned int i = 0; i < sims.size(); i++)
+      {
+        std::string prefix(others.empty() ? "" :
+                                   (boost::format("core%1%.") % i).str());
+        counters.set_prefix(prefix);
+        counters.add_value("cycles", sims[i]->Cycle);
+        sims[i]->add_counters(counters, prefix);
+      }
+      for(unsigned int i = 0; i < counters.size(); i++)
+      {
+        job->Counters.push_back(std::make_pair(counters.name(i),
+                                               counters.value(i)));
+      }
+      job->Status = !success ? "error" : (halted ? "halt" : "maxc");
+    }
+    else if (success) {
+      if (verbose && !print_stats && stats_format != patmos::SF_TEXT &&
+          !others.empty()) {
+        // a single document with the statistics of all cores
+        patmos::stats_counters_t counters;
+        for(unsigned int i = 0; i < sims.size(); i++)
+          sims[i]->add_stats(counters, stats_options,
+                             (boost::format("core%1%.") % i).str());
+        counters.write(*sout, stats_format);
+      }
+      else if (verbose && !print_stats) {
+        for(unsigned int i = 0; i < sims.size(); i++)
+        {
+          if (!others.empty()) {
+            *sout << boost::format("Core %1%:\n") % i;
+          }
+          sims[i]->print_stats(*sout);
+        }
+        if (dsink && stats_format == patmos::SF_TEXT) {
+          dsink->print_stats(*sout);
+        }
       }
-      if (verbose) {
+      if (verbose && stats_format == patmos::SF_TEXT) {
         *sout << "Pasim options:\n  ";
 
         // TODO make this more generic.. somehow.
@@ -790,9 +1252,22 @@ int main(int argc, char **argv)
           *sout << " --maxc=" << max_cycle;
         if (flush_caches)
           *sout << " --flush-caches=" << flush_caches_addr;
+        if (checkpoint)
+          *sout << " --checkpoint-at=" << checkpoint_at
+                << " --checkpoint-file=" << checkpoint_file;
+        if (!restore_file.empty())
+          *sout << " --restore=" << restore_file;
+        if (warmup_until)
+          *sout << " --warmup-until=" << warmup_addr;
+        if (vm.count("warmup-instrs"))
+          *sout << " --warmup-instrs=" << warmup_instrs;
         *sout << " --cpuid=" << cpuid << " --cores=" << cores;
         *sout << " --freq=" << freq;
         *sout << " --interrupt=" << excunit_enabled;
+        *sout << " --engine=" << engine;
+        if (multicore)
+          *sout << " --multicore --sync=" << sync << " --quantum=" << quantum
+                << " --threads=" << threads;
 
         *sout << "\n  ";
         *sout << " --mmbase=" << mmbase << " --mmhigh=" << mmhigh;
@@ -828,11 +1303,21 @@ int main(int argc, char **argv)
         *sout << " --lsize=" << lsize;
         *sout << " --dckind=" << dck;
         *sout << " --dcsize=" << dcsize << " --dlsize=" << dlsize;
+        *sout << " --dcwrite=" << dcwrite;
+        if (dcalloc)
+          *sout << " --dcalloc";
+        *sout << " --cseed=" << cseed;
+        if (dcvictim)
+          *sout << " --dcvictim=" << dcvictim;
+        if (dcprefetch.kind != patmos::PF_NO)
+          *sout << " --dcprefetch=" << dcprefetch;
         *sout << " --sckind=" << sck;
         *sout << " --scsize=" << scsize;
 
         *sout << "\n  ";
         *sout << " --icache=" << ick << " --ickind=" << isck;
+        if (icprefetch.kind != patmos::PF_NO)
+          *sout << " --icprefetch=" << icprefetch;
         *sout << " --ilsize=" << ilsize;
         *sout << " --mckind=" << mck;
         *sout << " --mcsize=" << mcsize << " --mbsize=" << mbsize;
@@ -840,6 +1325,9 @@ int main(int argc, char **argv)
 
         *sout << "\n\n";
       }
+      if (self_profile) {
+        profile.print(*sout);
+      }
     }
   }
   catch(std::ios_base::failure f)
@@ -850,19 +1338,574 @@ int main(int argc, char **argv)
 _cleanup:
   // free memory/cache instances
   // note: no need to free the local memory here.
+  for(unsigned int i = 0; i < others.size(); i++)
+    delete others[i];
+  for(unsigned int i = 0; i < core_streams.size(); i++)
+    delete core_streams[i];
+  delete sync_uin;
+  delete sync_uout;
+  delete sync_dout;
   delete &gm;
   delete &dc;
   delete &ic;
   delete &sc;
+  delete sampler;
 
   // free streams
-  patmos::free_stream(in);
+  if (!job) {
+    patmos::free_stream(in);
 
-  patmos::free_stream(uin);
-  patmos::free_stream(uout);
+    patmos::free_stream(uin);
+    patmos::free_stream(uout);
 
-  patmos::free_stream(dout);
-  patmos::free_stream(sout);
+    if (dsink) {
+      delete dout;
+      delete dsink;
+      dout = dfile;
+    }
+    patmos::free_stream(dout);
+    patmos::free_stream(sout);
+    patmos::free_stream(iout);
+  }
 
   return exit_code;
 }
+
+/// A configuration of the batch mode, mapping option names to values.
+typedef std::map<std::string, std::string> batch_config_t;
+
+/// Remove leading and trailing white space from a string.
+static std::string trim(const std::string &str)
+{
+  std::string::size_type first = str.find_first_not_of(" \t\r");
+  if (first == std::string::npos)
+    return "";
+
+  return str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+}
+
+/// Quote a field of a CSV table if needed.
+static std::string csv_field(const std::string &str)
+{
+  if (str.find_first_of(",\"\n") == std::string::npos)
+    return str;
+
+  std::string result("\"");
+  for(unsigned int i = 0; i < str.size(); i++)
+  {
+    if (str[i] == '"')
+      result += '"';
+    result += str[i];
+  }
+  return result + "\"";
+}
+
+/// Read the configurations of the batch mode, either from a CSV file with the
+/// option names in the first row and one configuration per following row, or
+/// from a JSON file containing an array of objects mapping option names to
+/// values. Empty values select the default value of an option.
+/// @param file The name of the file.
+/// @param columns The option names in the order of their first use.
+/// @param configs The configurations read from the file.
+/// @return True on success, otherwise an error was printed.
+static bool read_batch_configs(const std::string &file,
+                               std::vector<std::string> &columns,
+                               std::vector<batch_config_t> &configs)
+{
+  std::ifstream is(file.c_str());
+  if (!is.good()) {
+    std::cerr << "Failed to open file: " << file << "\n";
+    return false;
+  }
+
+  char first = 0;
+  is >> first;
+  is.seekg(0);
+
+  if (first == '[' || first == '{') {
+    try
+    {
+      boost::property_tree::ptree tree;
+      boost::property_tree::read_json(is, tree);
+
+      for(boost::property_tree::ptree::const_iterator i(tree.begin()),
+          ie(tree.end()); i != ie; i++)
+      {
+        batch_config_t config;
+        for(boost::property_tree::ptree::const_iterator j(i->second.begin()),
+            je(i->second.end()); j != je; j++)
+        {
+          if (std::find(columns.begin(), columns.end(), j->first) ==
+              columns.end())
+            columns.push_back(j->first);
+
+          config[j->first] = j->second.data();
+        }
+        configs.push_back(config);
+      }
+    }
+    catch(boost::property_tree::json_parser_error &e)
+    {
+      std::cerr << e.what() << "\n";
+      return false;
+    }
+    return true;
+  }
+
+  std::string line;
+  unsigned int line_num = 0;
+  while (std::getline(is, line))
+  {
+    line_num++;
+    if (trim(line).empty() || trim(line)[0] == '#')
+      continue;
+
+    // split the line into its fields
+    std::vector<std::string> fields;
+    std::istringstream ls(line);
+    std::string field;
+    while (std::getline(ls, field, ','))
+      fields.push_back(trim(field));
+    if (!line.empty() && line[line.size() - 1] == ',')
+      fields.push_back("");
+
+    if (columns.empty()) {
+      for(unsigned int i = 0; i < fields.size(); i++)
+      {
+        std::string name = fields[i];
+        name.erase(0, name.find_first_not_of('-'));
+        columns.push_back(name);
+      }
+      continue;
+    }
+
+    if (fields.size() != columns.size()) {
+      std::cerr << boost::format("%1%:%2%: Expected %3% values, found %4%.\n")
+                   % file % line_num % columns.size() % fields.size();
+      return false;
+    }
+
+    batch_config_t config;
+    for(unsigned int i = 0; i < fields.size(); i++)
+    {
+      config[columns[i]] = fields[i];
+    }
+    configs.push_back(config);
+  }
+
+  return true;
+}
+
+/// Simulate the batch runs, taking the next run from the list until all runs
+/// are done. Called by several host threads at once.
+/// @param jobs The batch runs.
+/// @param next The index of the next batch run to simulate.
+static void simulate_batch_jobs(std::vector<batch_job_t*> &jobs,
+                                std::atomic<unsigned int> &next)
+{
+  for(unsigned int i = next++; i < jobs.size(); i = next++)
+  {
+    simulate(jobs[i]->Options, jobs[i]);
+  }
+}
+
+/// Simulate every binary given on the command line with every configuration
+/// of the batch file and print a CSV table of the results. Each binary is
+/// read only once, the runs are distributed over several host threads.
+/// @param vm The command-line options.
+/// @param args The command-line arguments, providing the options that are not
+/// set by a configuration.
+/// @param options The descriptions of all command-line options.
+/// @param pos The description of the positional command-line options.
+/// @return 0 if all simulations succeeded, 1 otherwise.
+static int run_batch(const boost::program_options::variables_map &vm,
+                     const std::vector<std::string> &args,
+                     const boost::program_options::options_description &options,
+                     const boost::program_options::positional_options_description &pos)
+{
+  std::vector<std::string> columns;
+  std::vector<batch_config_t> configs;
+  if (!read_batch_configs(vm["batch"].as<std::string>(), columns, configs))
+    return 1;
+
+  std::vector<std::string> binaries;
+  if (vm.count("binary")) {
+    binaries.push_back(vm["binary"].as<std::string>());
+  }
+  if (vm.count("more-binaries")) {
+    const std::vector<std::string> &more =
+                        vm["more-binaries"].as<std::vector<std::string> >();
+    binaries.insert(binaries.end(), more.begin(), more.end());
+  }
+  if (binaries.empty()) {
+    std::cout << "No program to simulate specified. Use --help for more options.\n";
+    return 1;
+  }
+
+  // the options of each configuration, options not set by the configuration
+  // are taken from the command-line
+  std::vector<boost::program_options::variables_map> config_options;
+  for(unsigned int c = 0; c < configs.size(); c++)
+  {
+    std::vector<std::string> config_args;
+    for(batch_config_t::const_iterator i(configs[c].begin()),
+        ie(configs[c].end()); i != ie; i++)
+    {
+      const boost::program_options::option_description *o =
+                                        options.find_nothrow(i->first, false);
+      if (!o) {
+        std::cerr << boost::format("Unknown option in batch configuration: %1%\n")
+                     % i->first;
+        return 1;
+      }
+
+      if (o->semantic()->max_tokens() == 0) {
+        // a switch, given as a boolean value
+        if (i->second == "1" || i->second == "true" || i->second == "yes")
+          config_args.push_back("--" + i->first);
+      }
+      else if (!i->second.empty()) {
+        config_args.push_back("--" + i->first + "=" + i->second);
+      }
+    }
+
+    boost::program_options::variables_map cvm;
+    try
+    {
+      boost::program_options::store(
+                    boost::program_options::command_line_parser(config_args)
+                      .options(options).run(), cvm);
+      boost::program_options::store(
+                    boost::program_options::command_line_parser(args)
+                      .options(options).positional(pos).run(), cvm);
+      boost::program_options::notify(cvm);
+    }
+    catch(boost::program_options::error &e)
+    {
+      std::cerr << boost::format("Invalid batch configuration %1%: %2%\n")
+                   % c % e.what();
+      return 1;
+    }
+    config_options.push_back(cvm);
+  }
+
+  // read each binary once, all runs of a binary share its loader
+  std::vector<batch_job_t*> jobs;
+  for(unsigned int b = 0; b < binaries.size(); b++)
+  {
+    patmos::loader_t *loader;
+    try
+    {
+      std::istream *in = patmos::get_stream<std::ifstream>(binaries[b],
+                                                           std::cin);
+      loader = patmos::create_loader(*in);
+      patmos::free_stream(in);
+    }
+    catch(const std::ios_base::failure &f)
+    {
+      std::cerr << f.what() << "\n";
+      return 1;
+    }
+
+    for(unsigned int c = 0; c < configs.size(); c++)
+    {
+      jobs.push_back(new batch_job_t(binaries[b], c, loader));
+      jobs.back()->Options = config_options[c];
+    }
+  }
+
+  unsigned int num_threads = vm["jobs"].as<unsigned int>();
+  if (!num_threads) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  num_threads = std::min<unsigned int>(num_threads, jobs.size());
+
+  // the calling thread simulates its share of the runs as well
+  std::atomic<unsigned int> next(0);
+  std::vector<std::thread> threads;
+  for(unsigned int t = 1; t < num_threads; t++)
+  {
+    threads.push_back(std::thread(simulate_batch_jobs, std::ref(jobs),
+                                  std::ref(next)));
+  }
+  simulate_batch_jobs(jobs, next);
+  for(unsigned int t = 0; t < threads.size(); t++)
+  {
+    threads[t].join();
+  }
+
+  // print the results
+  int result = 0;
+  std::ostream *sout = NULL;
+  try
+  {
+    sout = patmos::get_stream<std::ofstream>(vm["stats-file"].as<std::string>(),
+                                             std::cout);
+
+    *sout << "binary,config";
+    for(unsigned int i = 0; i < columns.size(); i++)
+    {
+      *sout << "," << csv_field(columns[i]);
+    }
+    // the counters of all runs, in the order they first appear; runs with
+    // other cache kinds may lack some of them
+    std::vector<std::string> counter_names;
+    std::set<std::string> known_names;
+    for(unsigned int j = 0; j < jobs.size(); j++)
+    {
+      for(unsigned int i = 0; i < jobs[j]->Counters.size(); i++)
+      {
+        const std::string &name(jobs[j]->Counters[i].first);
+        if (known_names.insert(name).second)
+          counter_names.push_back(name);
+      }
+    }
+
+    *sout << ",status,exit_code";
+    for(unsigned int i = 0; i < counter_names.size(); i++)
+    {
+      *sout << "," << csv_field(counter_names[i]);
+    }
+    *sout << "\n";
+
+    for(unsigned int j = 0; j < jobs.size(); j++)
+    {
+      const batch_job_t &job(*jobs[j]);
+
+      *sout << csv_field(job.Binary) << "," << job.Config;
+      for(unsigned int i = 0; i < columns.size(); i++)
+      {
+        batch_config_t::const_iterator value(
+                                       configs[job.Config].find(columns[i]));
+        *sout << ","
+              << (value != configs[job.Config].end() ?
+                                            csv_field(value->second) : "");
+      }
+      *sout << "," << job.Status << "," << job.Exit_code;
+
+      std::map<std::string, uint64_t> values(job.Counters.begin(),
+                                             job.Counters.end());
+      for(unsigned int i = 0; i < counter_names.size(); i++)
+      {
+        std::map<std::string, uint64_t>::const_iterator value(
+                                             values.find(counter_names[i]));
+        *sout << ",";
+        if (value != values.end())
+          *sout << value->second;
+      }
+      *sout << "\n";
+
+      if (job.Status == "error")
+        result = 1;
+    }
+  }
+  catch(const std::ios_base::failure &f)
+  {
+    std::cerr << f.what() << "\n";
+    result = 1;
+  }
+  patmos::free_stream(sout);
+
+  for(unsigned int j = 0; j < jobs.size(); j++)
+  {
+    delete jobs[j];
+  }
+
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  // We disable line buffering to ensure output is always
+  // produced immediately. Without this, pasim might exit
+  // without flushing its output buffer.
+  disable_line_buffering();
+  
+  // define command-line options
+  boost::program_options::options_description generic_options(
+    "Generic options:\n for memory/cache sizes the following units are allowed:"
+    " k, m, g, or kb, mb, gb");
+  generic_options.add_options()
+    ("help,h", "produce help message")
+    ("maxc,c", boost::program_options::value<unsigned int>()->default_value(0, "inf."), "stop simulation after the given number of cycles")
+    ("binary,b", boost::program_options::value<std::string>(), "binary or elf-executable file (stdin: -)")
+    ("debug", boost::program_options::value<unsigned int>()->implicit_value(0), "enable step-by-step debug tracing after cycle")
+    ("debug-fmt", boost::program_options::value<patmos::debug_format_e>()->default_value(patmos::DF_DEFAULT),
+                  "format of the debug trace (short, trace, btrace, instr, blocks, calls, calls-indent, default, long, all)")
+    ("debug-file", boost::program_options::value<std::string>()->default_value(""), "output debug trace in file (stdout: -)")
+    ("debug-cache", boost::program_options::value<patmos::debug_cache_e>()->default_value(patmos::DC_NONE),
+                  "Print all cache updates (=none,miss,all)")
+    ("debug-intrs", "print out all status changes of the exception unit.")
+    ("debug-nopc", "do not print PC and cycles counter in debug output")
+    ("debug-access", boost::program_options::value<patmos::address_t>(), "print accesses to the given address or symbol.")
+    ("wpfile", boost::program_options::value<std::string>()->default_value(""), "only print trace for watchpoints provided in the given file, one 'address[-last|+size] [rwx]' per line; r and w print the accesses")
+    ("stats-file,o", boost::program_options::value<std::string>()->default_value(""), "write statistics to a file (stdout: -)")
+    ("stats-format", boost::program_options::value<patmos::stats_format_e>()->default_value(patmos::SF_TEXT), "format of the statistics (text, csv, json), csv and json print the short statistics unless -V is given")
+    ("stats-interval", boost::program_options::value<uint64_t>()->default_value(0), "write the increase of the statistics counters every given number of cycles")
+    ("stats-interval-file", boost::program_options::value<std::string>()->default_value(""), "write the statistics of the intervals to a file (stdout: -)")
+    ("stats-interval-format", boost::program_options::value<patmos::stats_format_e>()->default_value(patmos::SF_CSV), "format of the statistics of the intervals (text, csv, json)")
+    ("print-stats", boost::program_options::value<patmos::address_t>(), "print statistics for a given function only.")
+    ("flush-caches", boost::program_options::value<patmos::address_t>(), "flush all caches when reaching the given address (can be a symbol name).")
+    ("hitmiss-stats", "Print hit/miss cache accesses (requires '--full')")
+    ("self-profile", boost::program_options::value<unsigned int>()->implicit_value(64), "print the host time spent in the simulator's components, measured in every given number of cycles, and the simulation speed (of core 0 with --multicore)")
+    ("full,V", "full statistics output")
+    ("verbose,v", "enable short statistics output");
+
+  boost::program_options::options_description memory_options("Memory options");
+  memory_options.add_options()
+#ifdef RAMULATOR
+    ("gkind,R", boost::program_options::value<patmos::main_memory_kind_e>()->default_value(patmos::GM_SIMPLE), "kind of main memory (simple, ddr3, ddr4, lpddr3, lpddr4)")
+#endif // RAMULATOR
+    ("gsize,g",  boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_MEMORY_BYTES), "global memory size in bytes.")
+    ("gtime,G",  boost::program_options::value<unsigned int>()->default_value(patmos::NUM_MEMORY_TRANSFER_LATENCY),
+                 "global memory transfer time per burst in cycles")
+    ("tdelay,t", boost::program_options::value<int>()->default_value(0), "read delay to global memory per request in cycles.")
+    ("trefresh", boost::program_options::value<unsigned int>()->default_value(0), "refresh cycles per TDM round.")
+    ("bsize",    boost::program_options::value<unsigned int>()->default_value(patmos::NUM_MEMORY_BLOCK_BYTES), "burst size (and alignment) of the memory system.")
+    ("psize",    boost::program_options::value<patmos::byte_size_t>()->default_value(0), "Memory page size. Enables variable burst lengths for single-core.")
+    ("posted,p", boost::program_options::value<unsigned int>()->default_value(0), "Enable posted writes (sets max queue size)")
+    ("ispmsize", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_ISPM_MEMORY_BYTES), "instruction SPM size in bytes, 0 to disable.")
+    ("lsize,l",  boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_LOCAL_MEMORY_BYTES), "local data memory size in bytes.")
+    ("mem-rand", boost::program_options::value<unsigned int>()->default_value(0), "Initialize memories with random data.")
+    ("chkreads", boost::program_options::value<patmos::mem_check_e>()->default_value(patmos::MCK_NONE),
+                 "Check for reads of uninitialized data, either per byte (warn, err) or per access (warn-addr, err-addr). Disables the data cache.")
+    ("with-mmu", boost::program_options::value<bool>()->default_value(false), "Simulate memory management unit.")
+#ifdef RAMULATOR
+    ("ramul-config", boost::program_options::value<std::string>()->default_value(""), "name of ramulator configuration file.")
+#endif // RAMULATOR
+;
+
+  boost::program_options::options_description noc_options("Network-on-chip options");
+  noc_options.add_options()
+    ("nocbase",          boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_BASE_ADDRESS), "base address of the NOC device map address range")
+    ("noc_route_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_DMA_P_OFFSET), "offset of the NOC routing information device map")
+    ("noc_st_offset",    boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_DMA_ST_OFFSET), "offset of the NOC slot table device map")
+    ("noc_spm_offset",   boost::program_options::value<patmos::address_t>()->default_value(patmos::NOC_SPM_OFFSET), "offset of the NOC SPM")
+    ("nocsize",          boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NOC_SPM_SIZE),   "size of the NOC SPM");
+
+  boost::program_options::options_description cache_options("Cache options");
+  cache_options.add_options()
+    ("dcsize,d", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_DATA_CACHE_BYTES), "data cache size in bytes")
+    ("dckind,D", boost::program_options::value<patmos::set_assoc_cache_type>()->default_value(patmos::set_assoc_cache_type(patmos::SAC_DM,1)),
+                 "kind of direct mapped/fully-/set-associative data cache (ideal, no, dm, lru[N], fifo[N], plru[N], bplru[N], rand[N], srrip[N], brrip[N])")
+    ("dlsize",   boost::program_options::value<patmos::byte_size_t>()->default_value(0), "size of a data cache line in bytes, defaults to burst size if set to 0")
+    ("dcwrite",  boost::program_options::value<patmos::write_policy_e>()->default_value(patmos::WP_THROUGH), "write policy of the data cache (wt, wb), write-back lines do not see stores bypassing the cache")
+    ("dcalloc",  "allocate data cache lines on write misses")
+    ("cseed",    boost::program_options::value<unsigned int>()->default_value(1), "seed of the random and bimodal replacement of set-associative caches")
+    ("dcvictim", boost::program_options::value<unsigned int>()->default_value(0), "number of lines of the victim buffer of a set-associative data cache")
+    ("dcprefetch", boost::program_options::value<patmos::prefetch_type>()->default_value(patmos::prefetch_type(patmos::PF_NO, 0)), "prefetcher of a set-associative data cache (no, next[N], stride[N])")
+
+    ("scsize,s", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_STACK_CACHE_BYTES), "stack cache size in bytes")
+    ("sckind,S", boost::program_options::value<patmos::stack_cache_e>()->default_value(patmos::SC_BLOCK), "kind of stack cache (ideal, block, ablock, lblock, dcache)")
+
+    ("icache,C", boost::program_options::value<patmos::instr_cache_e>()->default_value(patmos::IC_MCACHE), "kind of instruction cache (mcache, icache)")
+    ("ickind,K", boost::program_options::value<patmos::set_assoc_cache_type>()->default_value(patmos::set_assoc_cache_type(patmos::SAC_LRU,2)),
+                 "kind of direct mapped/fully-/set-associative I-cache (ideal, no, dm, lru[N], fifo[N], plru[N], bplru[N], rand[N], srrip[N], brrip[N])")
+    ("ilsize",   boost::program_options::value<patmos::byte_size_t>()->default_value(0), "size of an I-cache line in bytes, defaults to burst size if set to 0")
+    ("icprefetch", boost::program_options::value<patmos::prefetch_type>()->default_value(patmos::prefetch_type(patmos::PF_NO, 0)), "prefetcher of a set-associative I-cache (no, next[N], stride[N])")
+
+    ("mcsize,m", boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_METHOD_CACHE_BYTES),
+                 "method cache / instruction cache size in bytes")
+    ("mckind,M", boost::program_options::value<patmos::method_cache_e>()->default_value(patmos::MC_FIFO), "kind of method cache (ideal, lru, fifo)")
+    ("mcmethods",boost::program_options::value<unsigned int>()->default_value(patmos::NUM_METHOD_CACHE_MAX_METHODS),
+                 "Maximum number of methods in the method cache, defaults to number of blocks if zero")
+    ("mbsize",   boost::program_options::value<patmos::byte_size_t>()->default_value(patmos::NUM_METHOD_CACHE_BLOCK_BYTES),
+                 "method cache block size in bytes, defaults to burst size if zero");
+
+  boost::program_options::options_description sim_options("Simulator options");
+  sim_options.add_options()
+    ("cpuid",  boost::program_options::value<unsigned int>()->default_value(0), "Set CPU ID in the simulator")
+    ("cores,N", boost::program_options::value<unsigned int>()->default_value(1), "Set number of CPUs (enables memory TDM)")
+    ("freq",   boost::program_options::value<double>()->default_value(80.0), "Set CPU Frequency in Mhz")
+    ("mmbase", boost::program_options::value<patmos::address_t>()->default_value(patmos::IOMAP_BASE_ADDRESS), "base address of the IO device map address range")
+    ("mmhigh", boost::program_options::value<patmos::address_t>()->default_value(patmos::IOMAP_HIGH_ADDRESS), "highest address of the IO device map address range")
+    ("cpuinfo_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::CPUINFO_OFFSET), "offset where the cpuinfo device is mapped")
+    ("excunit_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::EXCUNIT_OFFSET), "offset where the exception unit is mapped")
+    ("timer_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::TIMER_OFFSET), "offset where the timer device is mapped")
+    ("perfcounters_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::PERFCOUNTERS_OFFSET), "offset where the performance counters device is mapped")
+    ("mmu_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::MMU_OFFSET), "offset where the memory management unit is mapped")
+    ("uart_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::UART_OFFSET), "offset where the UART device is mapped")
+    ("led_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::LED_OFFSET), "offset where the LED device is mapped")
+    ("deadline_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::DEADLINE_OFFSET), "offset where the deadline device is mapped")
+    ("ethmac_offset", boost::program_options::value<patmos::address_t>()->default_value(patmos::ETHMAC_OFFSET), "offset where the EthMac device is mapped")
+    ("ethmac_ip_addr", boost::program_options::value<std::string>()->default_value(""), "Provide virtual network interface with the given IP address")
+    ("multicore", "simulate all cores (see --cores) in this process, sharing the global memory and the NOC SPM; the cores get the CPU IDs 0 to N-1")
+    ("sync", boost::program_options::value<patmos::sync_e>()->default_value(patmos::SY_CYCLE),
+             "synchronization of the cores with --multicore (cycle, quantum)")
+    ("quantum", boost::program_options::value<unsigned int>()->default_value(1000), "maximum number of cycles a core runs ahead of the others with --sync=quantum")
+    ("threads", boost::program_options::value<unsigned int>()->default_value(1), "number of host threads simulating the cores with --multicore; within a slice, the cores access the global memory, the NOC SPM, and the UART in the order of their IDs, such that the results match those of a single thread, only the debug output of the cores may interleave differently")
+    ("engine", boost::program_options::value<patmos::engine_e>()->default_value(patmos::EN_CYCLE),
+               "execution engine (cycle, bb); bb executes basic blocks that are translated once, with the same timing and results as cycle, and falls back to cycle while debug output is printed")
+    ("warmup-until", boost::program_options::value<patmos::address_t>(), "execute functionally, without the timing of the memories, until reaching the given address (can be a symbol name), then continue cycle-accurately; the statistics cover the cycle-accurate part only")
+    ("warmup-instrs", boost::program_options::value<uint64_t>(), "execute functionally for at most the given number of instructions, see --warmup-until")
+    ("permissive-dual-issue", "Enables instructions in the second issue slot that are otherwise prohibited (e.g. loads, stores, branches). Some restrictions apply, which require some instruction combinations to not be enabled simultaneously (e.g. 2 loads).");
+
+  boost::program_options::options_description uart_options("UART options");
+  uart_options.add_options()
+    ("in,I", boost::program_options::value<std::string>()->default_value("-"), "input file for UART simulation (stdin: -)")
+    ("out,O", boost::program_options::value<std::string>()->default_value("-"), "output file for UART simulation (stdout: -)");
+
+  boost::program_options::options_description interrupt_options("Interrupt options");
+  interrupt_options.add_options()
+    ("interrupt", boost::program_options::value<int>()->default_value(1), "enable or disable interrupts");
+
+  boost::program_options::options_description checkpoint_options("Checkpoint options");
+  checkpoint_options.add_options()
+    ("checkpoint-at", boost::program_options::value<patmos::sim_point_t>(), "write a checkpoint and stop when reaching the given cycle or the address of the given symbol")
+    ("checkpoint-file", boost::program_options::value<std::string>()->default_value("pasim.ckpt"), "file to write the checkpoint to")
+    ("restore", boost::program_options::value<std::string>(), "continue the simulation from a checkpoint file, the memories and caches must be of the same kinds and sizes, statistics start at the restored cycle");
+
+  boost::program_options::options_description batch_options("Batch options");
+  batch_options.add_options()
+    ("batch", boost::program_options::value<std::string>(), "simulate all binaries given on the command line with each configuration of a CSV or JSON file, print a table of the results as statistics")
+    ("jobs,j", boost::program_options::value<unsigned int>()->default_value(0, "#host cores"), "number of simulations running in parallel with --batch");
+
+  boost::program_options::options_description hidden_options;
+  hidden_options.add_options()
+    ("more-binaries", boost::program_options::value<std::vector<std::string> >());
+
+  boost::program_options::positional_options_description pos;
+  pos.add("binary", 1);
+  pos.add("more-binaries", -1);
+
+  boost::program_options::options_description cmdline_options;
+  cmdline_options.add(generic_options).add(memory_options).add(cache_options)
+                 .add(noc_options).add(sim_options).add(uart_options)
+                 .add(interrupt_options).add(checkpoint_options)
+                 .add(batch_options);
+
+  boost::program_options::options_description all_options;
+  all_options.add(cmdline_options).add(hidden_options);
+
+  // process command-line options
+  std::vector<std::string> args(argv + 1, argv + argc);
+  boost::program_options::variables_map vm;
+  try
+  {
+    boost::program_options::store(
+                          boost::program_options::command_line_parser(args)
+                            .options(all_options).positional(pos).run(), vm);
+    boost::program_options::notify(vm);
+
+    // help message
+    if (vm.count("help")) {
+      std::cout << cmdline_options << "\n";
+      return 1;
+    }
+  }
+  catch(boost::program_options::error &e)
+  {
+    std::cerr << cmdline_options << "\n" << e.what() << "\n\n";
+    return 1;
+  }
+
+  if (vm.count("batch")) {
+    return run_batch(vm, args, all_options, pos);
+  }
+  else if (vm.count("more-binaries")) {
+    std::cerr << "Several programs can only be simulated with --batch.\n";
+    return 1;
+  }
+
+  return simulate(vm, NULL);
+}
@@ -0,0 +1,86 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Main file of a converter of binary traces (see pasim --debug-fmt=btrace)
+// into the textual trace format.
+//
+
+#include "streams.h"
+#include "trace.h"
+
+#include <boost/format.hpp>
+
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+  // check arguments
+  if (argc != 3)
+  {
+    std::cerr << "Usage: patrace <input> <output>\n";
+    return 1;
+  }
+
+  // open streams
+  try
+  {
+    std::istream &in = *patmos::get_stream<std::ifstream>(argv[1], std::cin);
+    std::ostream &out = *patmos::get_stream<std::ofstream>(argv[2], std::cout);
+
+    patmos::trace_reader_t reader(in);
+
+    // print the records exactly as pasim --debug-fmt=trace
+    patmos::uword_t address;
+    uint64_t cycle, count, records = 0;
+    while (reader.read(address, cycle, count))
+    {
+      patmos::print_trace_record(out, address, cycle, count);
+      records++;
+    }
+
+    // some status messages
+    std::cerr << boost::format("Converted: %1% records\n") % records;
+
+    // free streams
+    patmos::free_stream(&in);
+    patmos::free_stream(&out);
+  }
+  catch(const std::ios_base::failure &f)
+  {
+    std::cerr << f.what() << "\n";
+    return -1;
+  }
+
+  return 0;
+}
@@ -36,6 +36,7 @@
 
 
 #include "profiling.h"
+#include "stats-counters.h"
 
 //#include <iostream>
 #include <sstream>
@@ -200,6 +201,41 @@ namespace patmos
     return os;
   }
 
+  void profiling_t::add_stats(stats_counters_t &counters,
+                              symbol_map_t &sym) const
+  {
+    std::string prefix(counters.get_prefix());
+
+    for(std::map<uword_t, prof_funcinfo_t>::const_iterator
+            i = cycles_map.begin(), e = cycles_map.end(); i != e; ++i)
+    {
+      std::stringstream func_name;
+
+      if (sym.contains(i->first)) {
+        sym.print(func_name, i->first, true);
+      } else {
+        func_name << boost::format("%#x") % i->first;
+      }
+
+      // strip the brackets around symbols, dots separate the counter names
+      std::string name(func_name.str());
+      if (name.size() > 2 && name[0] == '<' && name[name.size() - 1] == '>')
+        name = name.substr(1, name.size() - 2);
+      std::replace(name.begin(), name.end(), '.', '_');
+
+      const prof_funcinfo_t *entry = &i->second;
+
+      counters.set_prefix(prefix + name + ".");
+      counters.add_value("calls", entry->num_calls);
+      counters.add_value("min", entry->min);
+      counters.add_value("max", entry->max);
+      counters.add_value("self", entry->self);
+      counters.add_value("total", entry->total);
+    }
+
+    counters.set_prefix(prefix);
+  }
+
   void profiling_t::reset_stats(uint64_t cycle)
   {
     reset_cycle = cycle;
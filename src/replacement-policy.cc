@@ -0,0 +1,343 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Implementation of the replacement policies of set-associative caches.
+//
+
+#include "replacement-policy.h"
+
+#include "checkpoint.h"
+
+#include <algorithm>
+
+using namespace patmos;
+
+lru_replacement_t::lru_replacement_t(unsigned int num_sets,
+                                     unsigned int associativity, uword_t seed) :
+    Associativity(associativity), Stamps(num_sets * associativity, 0),
+    Clock(0)
+{
+}
+
+unsigned int lru_replacement_t::victim(unsigned int set) const
+{
+  // evict the way with the oldest stamp
+  const uint64_t *stamps = &Stamps[set * Associativity];
+  return std::min_element(stamps, stamps + Associativity) - stamps;
+}
+
+void lru_replacement_t::order(unsigned int set,
+                              std::vector<unsigned int> &ways) const
+{
+  const uint64_t *stamps = &Stamps[set * Associativity];
+  std::sort(ways.begin(), ways.end(), [stamps](unsigned int a, unsigned int b)
+            { return stamps[a] > stamps[b]; });
+}
+
+void lru_replacement_t::invalidate()
+{
+}
+
+void lru_replacement_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(Clock);
+  cw.write(Stamps.data(), Stamps.size() * sizeof(uint64_t));
+}
+
+void lru_replacement_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(Clock);
+  cr.read(Stamps.data(), Stamps.size() * sizeof(uint64_t));
+}
+
+
+fifo_replacement_t::fifo_replacement_t(unsigned int num_sets,
+                                       unsigned int associativity,
+                                       uword_t seed) :
+    Associativity(associativity), Next(num_sets, 0)
+{
+}
+
+void fifo_replacement_t::order(unsigned int set,
+                               std::vector<unsigned int> &ways) const
+{
+  // the way before the pointer was inserted last
+  unsigned int newest = Next[set] + Associativity - 1;
+  unsigned int assoc = Associativity;
+  std::sort(ways.begin(), ways.end(),
+            [newest, assoc](unsigned int a, unsigned int b)
+            { return (newest - a) % assoc < (newest - b) % assoc; });
+}
+
+void fifo_replacement_t::invalidate()
+{
+  std::fill(Next.begin(), Next.end(), 0);
+}
+
+void fifo_replacement_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(Next.data(), Next.size() * sizeof(unsigned int));
+}
+
+void fifo_replacement_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(Next.data(), Next.size() * sizeof(unsigned int));
+}
+
+
+tree_plru_replacement_t::tree_plru_replacement_t(unsigned int num_sets,
+                                                 unsigned int associativity,
+                                                 uword_t seed) :
+    Associativity(associativity), Num_leaves(1)
+{
+  while (Num_leaves < Associativity)
+    Num_leaves *= 2;
+
+  Nodes.resize(num_sets * (Num_leaves - 1), 0);
+}
+
+void tree_plru_replacement_t::access(unsigned int set, unsigned int way)
+{
+  byte_t *nodes = Nodes.data() + set * (Num_leaves - 1);
+
+  // let the nodes on the path to the way point to the other halves
+  unsigned int node = 0;
+  unsigned int first = 0;
+  for(unsigned int size = Num_leaves; size > 1; size /= 2)
+  {
+    unsigned int half = size / 2;
+    if (way < first + half)
+    {
+      nodes[node] = 1;
+      node = 2 * node + 1;
+    }
+    else
+    {
+      nodes[node] = 0;
+      node = 2 * node + 2;
+      first += half;
+    }
+  }
+}
+
+unsigned int tree_plru_replacement_t::victim(unsigned int set) const
+{
+  const byte_t *nodes = Nodes.data() + set * (Num_leaves - 1);
+
+  // follow the nodes, avoiding the padding ways of the tree
+  unsigned int node = 0;
+  unsigned int first = 0;
+  for(unsigned int size = Num_leaves; size > 1; size /= 2)
+  {
+    unsigned int half = size / 2;
+    if (nodes[node] && first + half < Associativity)
+    {
+      node = 2 * node + 2;
+      first += half;
+    }
+    else
+    {
+      node = 2 * node + 1;
+    }
+  }
+
+  return first;
+}
+
+void tree_plru_replacement_t::invalidate()
+{
+  std::fill(Nodes.begin(), Nodes.end(), 0);
+}
+
+void tree_plru_replacement_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(Nodes.data(), Nodes.size());
+}
+
+void tree_plru_replacement_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(Nodes.data(), Nodes.size());
+}
+
+
+bit_plru_replacement_t::bit_plru_replacement_t(unsigned int num_sets,
+                                               unsigned int associativity,
+                                               uword_t seed) :
+    Associativity(associativity), Num_words((associativity + 63) / 64),
+    Bits(num_sets * Num_words, 0)
+{
+}
+
+void bit_plru_replacement_t::access(unsigned int set, unsigned int way)
+{
+  uint64_t *bits = &Bits[set * Num_words];
+  bits[way / 64] |= (uint64_t)1 << (way % 64);
+
+  // check if all bits are set
+  for(unsigned int w = 0; w < Num_words; w++)
+  {
+    uint64_t all = w + 1 < Num_words || Associativity % 64 == 0 ?
+                   ~(uint64_t)0 : ((uint64_t)1 << (Associativity % 64)) - 1;
+    if (bits[w] != all)
+      return;
+  }
+
+  // start over, keeping the bit of the accessed way
+  std::fill(bits, bits + Num_words, 0);
+  bits[way / 64] = (uint64_t)1 << (way % 64);
+}
+
+unsigned int bit_plru_replacement_t::victim(unsigned int set) const
+{
+  const uint64_t *bits = &Bits[set * Num_words];
+  for(unsigned int w = 0; w < Num_words; w++)
+  {
+    if (~bits[w])
+    {
+      unsigned int way = w * 64 + __builtin_ctzll(~bits[w]);
+      if (way < Associativity)
+        return way;
+    }
+  }
+
+  // a direct-mapped set has no choice
+  return 0;
+}
+
+void bit_plru_replacement_t::invalidate()
+{
+  std::fill(Bits.begin(), Bits.end(), 0);
+}
+
+void bit_plru_replacement_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(Bits.data(), Bits.size() * sizeof(uint64_t));
+}
+
+void bit_plru_replacement_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(Bits.data(), Bits.size() * sizeof(uint64_t));
+}
+
+
+random_replacement_t::random_replacement_t(unsigned int num_sets,
+                                           unsigned int associativity,
+                                           uword_t seed) :
+    Associativity(associativity), State(seed ? seed : 1)
+{
+}
+
+void random_replacement_t::invalidate()
+{
+}
+
+void random_replacement_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(State);
+}
+
+void random_replacement_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(State);
+}
+
+
+template<bool BIMODAL>
+rrip_replacement_t<BIMODAL>::rrip_replacement_t(unsigned int num_sets,
+                                                unsigned int associativity,
+                                                uword_t seed) :
+    Associativity(associativity), Values(num_sets * associativity, DISTANT),
+    State(seed ? seed : 1)
+{
+}
+
+template<bool BIMODAL>
+void rrip_replacement_t<BIMODAL>::insert(unsigned int set, unsigned int way)
+{
+  byte_t *values = &Values[set * Associativity];
+
+  // age all ways until the evicted one would have been distant; evicting an
+  // invalid way, which is distant already, does not age the set
+  byte_t age = DISTANT - values[way];
+  if (age)
+  {
+    for(unsigned int i = 0; i < Associativity; i++)
+      values[i] += age;
+  }
+
+  if (BIMODAL)
+  {
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    values[way] = State % BIMODAL_THROTTLE == 0 ? DISTANT - 1 : DISTANT;
+  }
+  else
+  {
+    values[way] = DISTANT - 1;
+  }
+}
+
+template<bool BIMODAL>
+unsigned int rrip_replacement_t<BIMODAL>::victim(unsigned int set) const
+{
+  // the first way with the most distant prediction
+  const byte_t *values = &Values[set * Associativity];
+  return std::max_element(values, values + Associativity) - values;
+}
+
+template<bool BIMODAL>
+void rrip_replacement_t<BIMODAL>::invalidate()
+{
+  std::fill(Values.begin(), Values.end(), DISTANT);
+}
+
+template<bool BIMODAL>
+void rrip_replacement_t<BIMODAL>::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write(State);
+  cw.write(Values.data(), Values.size());
+}
+
+template<bool BIMODAL>
+void rrip_replacement_t<BIMODAL>::restore_state(checkpoint_reader_t &cr)
+{
+  cr.read(State);
+  cr.read(Values.data(), Values.size());
+}
+
+namespace patmos {
+  // Explicit instantiation of template class for linking.
+  template class rrip_replacement_t<false>;
+  template class rrip_replacement_t<true>;
+}
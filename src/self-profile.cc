@@ -0,0 +1,112 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+
+//
+// Measuring the host time spent in the components of the simulator itself.
+//
+
+#include "self-profile.h"
+
+#include <algorithm>
+
+#include <boost/format.hpp>
+
+namespace patmos
+{
+  /// Names of the components, in the order of self_profile_component_e.
+  static const char *Component_names[SP_NUM_COMPONENTS] =
+  {
+    "decode", "icache", "MW", "EX", "DR", "pipeline", "local memory",
+    "memory", "dcache", "scache", "print", "stats", "skip"
+  };
+
+  self_profile_t::self_profile_t(unsigned int interval)
+    : Interval(std::max(interval, 1u)), Countdown(1), Num_iterations(0),
+      Num_sampled(0), Ns(), Wall_ns(0), Start_cycle(0), Start_retired(0),
+      Num_cycles(0), Num_retired(0)
+  {
+  }
+
+  void self_profile_t::start(uint64_t cycle, uint64_t retired)
+  {
+    Start_cycle = cycle;
+    Start_retired = retired;
+    Start_time = host_clock_t::now();
+  }
+
+  void self_profile_t::stop(uint64_t cycle, uint64_t retired)
+  {
+    Wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    host_clock_t::now() - Start_time).count();
+    Num_cycles = cycle - Start_cycle;
+    Num_retired = retired - Start_retired;
+  }
+
+  void self_profile_t::print(std::ostream &os) const
+  {
+    double seconds = Wall_ns / 1e9;
+    double cycles = std::max<uint64_t>(Num_cycles, 1);
+
+    os << boost::format("\nSelf Profile: (every %1% iterations)\n"
+                        "   Host Time        : %2$10.3f s\n"
+                        "   Cycles           : %3$10d %4$10.3f MHz\n"
+                        "   Retired          : %5$10d %6$10.3f MIPS\n"
+                        "   Iterations       : %7$10d %8$10d sampled\n\n"
+                        "   %9$-16s : %10$10s %11$10s %12$10s\n")
+       % Interval % seconds
+       % Num_cycles % (seconds > 0 ? Num_cycles / seconds / 1e6 : 0.0)
+       % Num_retired % (seconds > 0 ? Num_retired / seconds / 1e6 : 0.0)
+       % Num_iterations % Num_sampled
+       % "Component" % "ms" % "ns/cycle" % "share";
+
+    // extrapolate the measured iterations to all iterations
+    double scale = Num_sampled ? (double)Num_iterations / Num_sampled : 0.0;
+
+    double total_ns = 0;
+    for(unsigned int i = 0; i < SP_NUM_COMPONENTS; i++)
+    {
+      double ns = Ns[i] * scale;
+      total_ns += ns;
+
+      os << boost::format("   %1$-16s : %2$10.3f %3$10.2f %4$9.2f%%\n")
+         % Component_names[i] % (ns / 1e6) % (ns / cycles)
+         % (Wall_ns ? 100.0 * ns / Wall_ns : 0.0);
+    }
+
+    // the remaining time, e.g., the loop itself and the measurement
+    double other_ns = std::max(Wall_ns - total_ns, 0.0);
+    os << boost::format("   %1$-16s : %2$10.3f %3$10.2f %4$9.2f%%\n")
+       % "other" % (other_ns / 1e6) % (other_ns / cycles)
+       % (Wall_ns ? 100.0 * other_ns / Wall_ns : 0.0);
+  }
+}
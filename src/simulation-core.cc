@@ -35,22 +35,31 @@
 //
 
 #include "simulation-core.h"
+#include "basic-block.h"
+#include "checkpoint.h"
+#include "core-components.h"
 #include "data-cache.h"
+#include "debug-sink.h"
 #include "instruction.h"
 #include "memory.h"
 #include "method-cache.h"
+#include "multicore.h"
 #include "stack-cache.h"
+#include "stats-counters.h"
 #include "symbol.h"
 #include "excunit.h"
 #include "instructions.h"
 #include "rtc.h"
-#include <boost/optional.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <ios>
 #include <iostream>
 #include <iomanip>
 #include <limits>
 #include <fstream>
+#include <sstream>
+#include <typeinfo>
 
 namespace patmos
 {
@@ -69,18 +78,26 @@ namespace patmos
       Delay_counter(0), Halt(false),
       Exception_handling_counter(0),
       Flush_Cache_PC(std::numeric_limits<unsigned int>::max()),
-      Stats_Start_Cycle(0),
-      Traced_instructions(0),
-      Num_NOPs(0), Use_permissive_dual_issue(use_permissive_dual_issue), Decoder(use_permissive_dual_issue)
+      Stop_PC(std::numeric_limits<unsigned int>::max()),
+      Is_functional(false), Multicore(NULL), Core_id(0),
+      Is_shared_access_granted(false),
+      Stats_Start_Cycle(0), Stats_sampler(NULL),
+      Stats_sample_cycle(std::numeric_limits<uint64_t>::max()),
+      Self_profile(NULL), Is_self_profiled(false),
+      Is_default_core(typeid(memory) == typeid(default_memory_t) &&
+                      typeid(instr_cache) == typeid(default_instr_cache_t) &&
+                      typeid(data_cache) == typeid(default_data_cache_t) &&
+                      typeid(stack_cache) == typeid(default_stack_cache_t)),
+      Engine(EN_CYCLE), Blocks(NULL),
+      Traced_instructions(0), Trace_writer(NULL), Debug_sink(NULL),
+      Num_NOPs(0), Num_retired(0), Use_permissive_dual_issue(use_permissive_dual_issue), Decoder(use_permissive_dual_issue)
   {
     // initialize the pipeline
     for(unsigned int i = 0; i < NUM_STAGES; i++)
     {
       Num_stall_cycles[i] = 0;
-      for(unsigned int j = 0; j < NUM_SLOTS; j++)
-      {
-        Pipeline[i][j] = instruction_data_t();
-      }
+      Pipeline[i] = Pipeline_bundles[i];
+      Pipeline_translated[i] = NULL;
     }
 
     // Initialize instruction statistics
@@ -91,6 +108,11 @@ namespace patmos
       Num_bubbles_retired[j] = 0;
     }
 
+    for(unsigned int i = 0; i < Decoder.get_num_instructions(); i++)
+    {
+      Stats_instructions.push_back(decoder_t::create_instruction(i));
+    }
+
     // Create the interrupt instruction
     Instr_INTR       = new i_intr_t();
     Instr_INTR->ID   = -1;
@@ -105,17 +127,23 @@ namespace patmos
   {
     delete Instr_INTR;
     delete Instr_HALT;
+    delete Trace_writer;
+    delete Blocks;
+
+    for(unsigned int i = 0; i < Stats_instructions.size(); i++)
+    {
+      delete Stats_instructions[i];
+    }
   }
 
   void simulator_t::read_watchpoint_file(std::string wpfilename)
   {
     std::ifstream  wpfile(wpfilename.c_str());
-    // TODO do some error handling.
-    int wp;
-    // TODO handle hex addresses and symbol names
-    while (wpfile >> wp) {
-      Watchpoints.insert(wp);
-    }
+    if (!wpfile.good())
+      throw std::ios_base::failure("Failed to open file: " + wpfilename);
+
+    // TODO handle symbol names
+    Watchpoints.read(wpfile);
   }
 
   void simulator_t::pipeline_invoke(Pipeline_t pst,
@@ -127,62 +155,39 @@ namespace patmos
       debug_out << pst << " : ";
     }
 
-    auto &pipe_instr0 = Pipeline[pst][0];
-    auto &pipe_instr1 = Pipeline[pst][1];
-    auto pred0 = PRR.get(pipe_instr0.Pred).get();
-    auto pred1 = PRR.get(pipe_instr1.Pred).get();
+    // bundles fetched from a basic block call the simulation functions bound
+    // to their instructions, the checks of the bundle were done when it was
+    // translated.
+    const translated_bundle_t *tb = Pipeline_translated[pst];
+    if (tb && !debug)
+    {
+      instruction_data_t *ops = Pipeline[pst];
 
-    if(pred0 && pred1 && f == &instruction_data_t::DR) {
-      boost::optional<const char*> err;
+      check_stage(pst, tb);
 
-      if(pipe_instr0.I->get_dst_reg(Pipeline[pst][0]) != patmos::GPR_e::r0 &&
-        pipe_instr0.I->get_dst_reg(Pipeline[pst][0]) == pipe_instr1.I->get_dst_reg(Pipeline[pst][1])
-      ){
-        err = "register write";
-      } else if(Use_permissive_dual_issue) {
-        assert(NUM_SLOTS = 2);
-
-#define is_combi(pred1, pred2) (\
-    (pipe_instr0.I->pred1() && pipe_instr1.I->pred2()) || \
-    (pipe_instr0.I->pred2() && pipe_instr1.I->pred1()) )
+      for(unsigned int i = 0; i < NUM_SLOTS; i++)
+      {
+        if (!ops[i].I)
+          continue;
 
-        // Check permissive instructions
-        if( is_combi(is_load, is_load) ||
-            is_combi(is_store, is_store) ||
-            is_combi(is_store, is_load)
-        ){
-          err = "load/store";
-        } else if(is_combi(is_stack_op, is_stack_op)){
-          err = "stack";
-        } else if(is_combi(is_main_mem_op, is_main_mem_op)){
-          err = "main-memory";
-        } else if(is_combi(is_flow_control, is_flow_control)) {
-          err = "control-flow";
-        } else if(is_combi(is_multiply, is_multiply)) {
-          err = "multiply";
+        try {
+          tb->Functions[pst][i](*this, ops[i]);
+        }
+        catch (patmos::simulation_exception_t e)
+        {
+          e.set_offending_instruction(ops[i]);
+          throw e;
         }
       }
 
-      if(err) {
-        auto msg = std::string("Two simultaneously enabled ");
-        msg.append(*err);
-        msg.append(" operations");
-        patmos::simulation_exception_t::illegal(msg, Pipeline[pst][0]);
-      }
+      return;
     }
 
+    check_stage(pst, NULL);
+
     // invoke simulation functions
     for(unsigned int i = 0; i < NUM_SLOTS; i++)
     {
-      // If an invalid instruction reaches its execution stage, throw error
-      // This is because the predicate of preceding instructions may decide whether succeeding instruction
-      // execute. Predicates are only ready in the execution stage of preceding instruction, where
-      // invalids might be flushed. If not, then we are sure the invalid should have been executed
-      // and can therefore error
-      if(f == &instruction_data_t::EX && Pipeline[pst][i].I == &instruction_data_t::Invalid_Instr){
-    	  patmos::simulation_exception_t::illegal("", Pipeline[pst][i]);
-      }
-
       // debug output
       if (debug)
       {
@@ -214,13 +219,148 @@ namespace patmos
     }
   }
 
+  void simulator_t::check_stage(Pipeline_t pst,
+                                const translated_bundle_t *tb) const
+  {
+    const instruction_data_t *ops = Pipeline[pst];
+
+    if (pst == SDR && PRR.get(ops[0].Pred).get() &&
+        PRR.get(ops[1].Pred).get())
+    {
+      const char *err = tb ? tb->Conflict : get_dual_issue_conflict(ops);
+
+      if (err)
+      {
+        simulation_exception_t::illegal(
+               std::string("Two simultaneously enabled ") + err +
+               " operations", ops[0]);
+      }
+    }
+
+    // If an invalid instruction reaches its execution stage, throw error
+    // This is because the predicate of preceding instructions may decide whether succeeding instruction
+    // execute. Predicates are only ready in the execution stage of preceding instruction, where
+    // invalids might be flushed. If not, then we are sure the invalid should have been executed
+    // and can therefore error
+    if (pst == SEX)
+    {
+      for(unsigned int i = 0; i < NUM_SLOTS; i++)
+      {
+        if (ops[i].I == &instruction_data_t::Invalid_Instr)
+          simulation_exception_t::illegal("", ops[i]);
+      }
+    }
+  }
+
+  const char *simulator_t::get_dual_issue_conflict(
+                                       const instruction_data_t *bundle) const
+  {
+    const instruction_data_t &pipe_instr0 = bundle[0];
+    const instruction_data_t &pipe_instr1 = bundle[1];
+
+    if (!pipe_instr0.I || !pipe_instr1.I)
+      return NULL;
+
+    if(pipe_instr0.I->get_dst_reg(pipe_instr0) != patmos::GPR_e::r0 &&
+      pipe_instr0.I->get_dst_reg(pipe_instr0) == pipe_instr1.I->get_dst_reg(pipe_instr1)
+    ){
+      return "register write";
+    } else if(Use_permissive_dual_issue) {
+      assert(NUM_SLOTS = 2);
+
+#define is_combi(pred1, pred2) (\
+    (pipe_instr0.I->pred1() && pipe_instr1.I->pred2()) || \
+    (pipe_instr0.I->pred2() && pipe_instr1.I->pred1()) )
+
+      // Check permissive instructions
+      if( is_combi(is_load, is_load) ||
+          is_combi(is_store, is_store) ||
+          is_combi(is_store, is_load)
+      ){
+        return "load/store";
+      } else if(is_combi(is_stack_op, is_stack_op)){
+        return "stack";
+      } else if(is_combi(is_main_mem_op, is_main_mem_op)){
+        return "main-memory";
+      } else if(is_combi(is_flow_control, is_flow_control)) {
+        return "control-flow";
+      } else if(is_combi(is_multiply, is_multiply)) {
+        return "multiply";
+      }
+
+#undef is_combi
+    }
+
+    return NULL;
+  }
+
+  void simulator_t::check_load_hazard() const
+  {
+    if (is_stalling(SMW))
+      return;
+
+    // the registers of translated bundles were determined when they were
+    // translated.
+    const translated_bundle_t *tb_MW = Pipeline_translated[SMW];
+    const translated_bundle_t *tb_EX = Pipeline_translated[SEX];
+
+    GPR_e dst = r0;
+    if (tb_MW)
+      dst = tb_MW->Load_dst;
+    else
+    {
+      const instruction_t *mem_instr = Pipeline[SMW][0].I;
+      if (mem_instr && mem_instr->is_load())
+        dst = mem_instr->get_dst_reg(Pipeline[SMW][0]);
+    }
+
+    if (dst == r0)
+      return;
+
+    for (unsigned int j = 0; j < NUM_SLOTS; j++) {
+      const instruction_t *ex_instr = Pipeline[SEX][j].I;
+      if (!ex_instr)
+        continue;
+
+      GPR_e src1 = tb_EX ? tb_EX->Src1[j] :
+                           ex_instr->get_src1_reg(Pipeline[SEX][j]);
+      GPR_e src2 = tb_EX ? tb_EX->Src2[j] :
+                           ex_instr->get_src2_reg(Pipeline[SEX][j]);
+
+      // Either operand is the same as the source of the previous load
+      // instruction
+      if ((src1 == dst || src2 == dst) &&
+          // The instruction is being executed (predicate is true)
+          PRR.get(Pipeline[SEX][j].Pred).get() &&
+          // The previous load instruction is being executed
+          PRR.get(Pipeline[SMW][0].Pred).get())
+      {
+        simulation_exception_t::illegal("Use of load result without delay slot!",
+          Pipeline[SEX][j]
+        );
+      }
+    }
+  }
+
+  void simulator_t::flush_blocks()
+  {
+    if (Blocks)
+      Blocks->flush();
+
+    for(unsigned int i = 0; i < NUM_STAGES; i++)
+    {
+      Pipeline_translated[i] = NULL;
+    }
+  }
+
   void simulator_t::pipeline_flush(Pipeline_t pst)
   {
     for (int i = 0; i < pst; i++)
     {
+      Pipeline_translated[i] = NULL;
       for(unsigned int j = 0; j < NUM_SLOTS; j++)
       {
-        Pipeline[i][j] = instruction_data_t();
+        Pipeline[i][j].reset();
       }
     }
   }
@@ -260,7 +400,10 @@ namespace patmos
 
           // update instruction statistics
           if (ops.DR_Pred)
+          {
             stat.Num_retired++;
+            Num_retired++;
+          }
           else
             stat.Num_discarded++;
         }
@@ -270,8 +413,95 @@ namespace patmos
     }
   }
 
+  template<typename COMPONENTS>
+  uint64_t simulator_t::get_idle_cycles()
+  {
+    // only skip when the whole pipeline is waiting in MW and nothing is
+    // fetched, the stalled stages are then simply repeated.
+    if (Stall != SMW || !Disable_IF)
+      return 0;
+
+    for(unsigned int j = 0; j < NUM_SLOTS; j++)
+    {
+      if (Pipeline[SEX][j].I && Pipeline[SEX][j].I->has_ex_side_effects())
+        return 0;
+    }
+
+    typedef typename COMPONENTS::memory_type memory_type;
+    typedef typename COMPONENTS::data_cache_type data_cache_type;
+    typedef typename COMPONENTS::instr_cache_type instr_cache_type;
+    typedef typename COMPONENTS::stack_cache_type stack_cache_type;
+
+    uint64_t cycles = static_cast<memory_type&>(Memory).get_idle_cycles(*this);
+    cycles = std::min(cycles, Local_memory.get_idle_cycles(*this));
+    cycles = std::min(cycles, static_cast<data_cache_type&>(Data_cache).
+                                                     get_idle_cycles(*this));
+    cycles = std::min(cycles, static_cast<instr_cache_type&>(Instr_cache).
+                                                     get_idle_cycles(*this));
+    cycles = std::min(cycles, static_cast<stack_cache_type&>(Stack_cache).
+                                                     get_idle_cycles(*this));
+    return cycles;
+  }
+
+  template<typename COMPONENTS>
+  void simulator_t::skip_idle_cycles(uint64_t cycles)
+  {
+    typedef typename COMPONENTS::memory_type memory_type;
+    typedef typename COMPONENTS::data_cache_type data_cache_type;
+    typedef typename COMPONENTS::instr_cache_type instr_cache_type;
+    typedef typename COMPONENTS::stack_cache_type stack_cache_type;
+
+    Local_memory.skip_cycles(*this, cycles);
+    static_cast<memory_type&>(Memory).skip_cycles(*this, cycles);
+    static_cast<data_cache_type&>(Data_cache).skip_cycles(*this, cycles);
+    static_cast<instr_cache_type&>(Instr_cache).skip_cycles(*this, cycles);
+    static_cast<stack_cache_type&>(Stack_cache).skip_cycles(*this, cycles);
+
+    Num_stall_cycles[SMW] += cycles;
+  }
+
+  void simulator_t::advance_pipeline()
+  {
+    // Move pipeline stages and insert bubbles after stalling stage.
+    // If Stall == SXX, we do not stall, but a bubble is inserted in SIF,
+    // which is later replaced by the fetched instruction.
+    // The stages are moved by rotating the pointers, the retiring bundle is
+    // reused for the bubble.
+    if (Stall < SMW)
+    {
+      instruction_data_t *retired = Pipeline[SMW];
+
+      for (int i = SMW; i > Stall+1; i--)
+      {
+        Pipeline[i] = Pipeline[i-1];
+        Pipeline_translated[i] = Pipeline_translated[i-1];
+      }
+
+      Pipeline[Stall+1] = retired;
+      Pipeline_translated[Stall+1] = NULL;
+
+      for (unsigned int j = 0; j < NUM_SLOTS; j++)
+      {
+        retired[j].reset();
+      }
+    }
+
+    // if we are stalling in MW, reset the bypass in EX so that it can be
+    // filled by the stalled EX stage again (needs to be done for all
+    // stalled bypasses).
+    if (is_stalling(SEX)) {
+      for(unsigned int i = 0; i < NUM_SLOTS; i++)
+      {
+        Pipeline[SEX][i].GPR_EX_Rd.reset();
+      }
+    }
+  }
+
+  template<typename COMPONENTS>
   void simulator_t::instruction_fetch()
   {
+    typedef typename COMPONENTS::instr_cache_type instr_cache_type;
+
     // we get a pointer to the instructions of the IF stage, for easier
     // reference
     instruction_data_t *instr_SIF = Pipeline[SIF];
@@ -280,10 +510,11 @@ namespace patmos
       // When we are halting, just fill the pipeline with halt instructions
       // halt when we flushed the whole pipeline.
       instr_SIF[0] = instruction_data_t::mk_CFLrt(*Instr_HALT, p0, 1, r0, r0);
+      Pipeline_translated[SIF] = NULL;
 
       for(unsigned int i = 1; i < NUM_SLOTS; i++)
       {
-        instr_SIF[i] = instruction_data_t();
+        instr_SIF[i].reset();
       }
 
       return;
@@ -293,7 +524,11 @@ namespace patmos
     // NB: We fetch in each cycle, as preparation for supporting a standard
     //     I-Cache in addition.
     word_t iw[NUM_SLOTS];
-    if (!Instr_cache.fetch(*this, BASE, PC, iw))
+    bool is_fetched = static_cast<instr_cache_type&>(Instr_cache).
+                                                   fetch(*this, BASE, PC, iw);
+    profile(SP_ICACHE);
+
+    if (!is_fetched)
     {
       // Stall the whole pipeline
       pipeline_stall(SMW);
@@ -318,10 +553,11 @@ namespace patmos
         instr_SIF[0] = instruction_data_t::mk_CFLi(*Instr_INTR, p0, 0,
                                                    exception.Address, exception.Address);
         instr_SIF[0].Address = PC;
+        Pipeline_translated[SIF] = NULL;
 
         for(unsigned int i = 1; i < NUM_SLOTS; i++)
         {
-          instr_SIF[i] = instruction_data_t();
+          instr_SIF[i].reset();
         }
 
         // Handling interrupt, next CPU cycle no new instructions have to be decoded
@@ -333,22 +569,57 @@ namespace patmos
         // Putting more empty instrutions after an interrupt
         for(unsigned int i = 0; i < NUM_SLOTS; i++)
         {
-          instr_SIF[i] = instruction_data_t();
+          instr_SIF[i].reset();
         }
+        Pipeline_translated[SIF] = NULL;
         Exception_handling_counter--;
 
       }
       else
       {
-        // decode the instruction word.
-        unsigned int iw_size = Decoder.decode(iw, instr_SIF, false);
-        assert(iw_size != 0);
+        // take the bundle from its basic block, or decode the instruction
+        // word.
+        const translated_bundle_t *tb = NULL;
+        if (Engine == EN_BB)
+        {
+          if (!Blocks)
+            Blocks = new block_cache_t();
+
+          tb = Blocks->fetch(*this, PC, iw);
+
+          // the blocks were dropped, forget their bundles.
+          if (!tb)
+            flush_blocks();
+        }
+        Pipeline_translated[SIF] = tb;
+
+        unsigned int iw_size;
+        unsigned intr_delay;
+        bool is_NOP;
+        if (tb)
+        {
+          for(unsigned int i = 0; i < NUM_SLOTS; i++)
+          {
+            instr_SIF[i].set_decoded(tb->Ops[i]);
+          }
+          iw_size = tb->Size;
+          intr_delay = tb->Intr_delay_slots;
+          is_NOP = tb->Is_NOP;
+        }
+        else
+        {
+          iw_size = Decoder.decode_cached(PC, iw, instr_SIF);
+          assert(iw_size != 0);
 
-        // First pipeline is special.. handle branches and loads.
-        const instruction_t *i0 = instr_SIF[0].I;
+          // First pipeline is special.. handle branches and loads.
+          const instruction_t *i0 = instr_SIF[0].I;
+          intr_delay = i0->get_intr_delay_slots(instr_SIF[0]);
+
+          // Detect NOPs as "subi r0 = ...;"
+          is_NOP = Decoder.is_NOP(&instr_SIF[0]) && !instr_SIF[1].I;
+        }
 
         // Track branch delay slots
-        unsigned intr_delay = i0->get_intr_delay_slots(instr_SIF[0]);
         if(intr_delay >= Delay_counter)
           Delay_counter = intr_delay;
         else if (Delay_counter)
@@ -356,16 +627,12 @@ namespace patmos
 
         for(unsigned int j = 0; j < NUM_SLOTS; j++)
         {
-          // assign fetch address to new instructions
-          instr_SIF[j].Address = PC + j*sizeof(word_t);
-
           // track instructions fetched
           if (instr_SIF[j].I)
             Instruction_stats[j][instr_SIF[j].I->ID].Num_fetched++;
         }
 
-        // Detect NOPs as "subi r0 = ...;"
-        if (Decoder.is_NOP(&instr_SIF[0]) && !instr_SIF[1].I)
+        if (is_NOP)
         {
           Num_NOPs++;
         }
@@ -376,10 +643,131 @@ namespace patmos
     }
   }
 
+  void simulator_t::add_counters(stats_counters_t &counters,
+                                 const std::string &prefix) const
+  {
+    counters.set_prefix(prefix);
+    counters.add("retired", Num_retired);
+    counters.add("nops", Num_NOPs);
+    for (int i = SIF; i < NUM_STAGES; i++)
+    {
+      std::ostringstream name;
+      name << "stalls." << (Pipeline_t)i;
+      counters.add(name.str(), Num_stall_cycles[i]);
+    }
+    for (unsigned int i = 0; i < NUM_SLOTS; i++)
+    {
+      counters.add((boost::format("bubbles.slot%1%") % i).str(),
+                   Num_bubbles_retired[i]);
+    }
+
+    counters.set_prefix(prefix + "icache.");
+    Instr_cache.add_counters(counters);
+    counters.set_prefix(prefix + "dcache.");
+    Data_cache.add_counters(counters);
+    counters.set_prefix(prefix + "scache.");
+    Stack_cache.add_counters(counters);
+    counters.set_prefix(prefix + "memory.");
+    Memory.add_counters(counters);
+    counters.set_prefix("");
+  }
+
+  void simulator_t::add_stats(stats_counters_t &counters,
+                              const stats_options_t &options,
+                              const std::string &prefix) const
+  {
+    counters.set_prefix(prefix);
+    counters.add_value("cycles", Cycle - Stats_Start_Cycle);
+
+    add_counters(counters, prefix);
+
+    // statistics per instruction, skipping instructions never fetched
+    if (!options.short_stats)
+    {
+      for(unsigned int i = 0; i < Instruction_stats[0].size(); i++)
+      {
+        const instruction_t &I(Decoder.get_instruction(i));
+
+        bool is_used = false;
+        for (unsigned int j = 0; j < NUM_SLOTS; j++)
+        {
+          const instruction_stat_t &S(Instruction_stats[j][i]);
+          is_used |= S.Num_fetched || S.Num_retired || S.Num_discarded;
+        }
+        if (!is_used)
+          continue;
+
+        for (unsigned int j = 0; j < NUM_SLOTS; j++)
+        {
+          const instruction_stat_t &S(Instruction_stats[j][i]);
+
+          counters.set_prefix((boost::format("%1%instructions.%2%.slot%3%.")
+                               % prefix % I.Name % j).str());
+          counters.add("fetched", S.Num_fetched);
+          counters.add("retired", S.Num_retired);
+          counters.add("discarded", S.Num_discarded);
+        }
+      }
+    }
+
+    // profile of the functions
+    if (options.profiling_stats && !Profiling.empty())
+    {
+      counters.set_prefix(prefix + "functions.");
+      Profiling.add_stats(counters, Symbols);
+    }
+
+    counters.set_prefix("");
+  }
+
+  void simulator_t::sample_stats(stats_sampler_t &sampler)
+  {
+    Stats_sampler = &sampler;
+    Stats_sample_cycle = Cycle + sampler.get_interval();
+    sampler.start(Cycle);
+  }
+
+  void simulator_t::finalize()
+  {
+    Profiling.finalize(Cycle);
+
+    // write the last, incomplete interval
+    if (Stats_sampler &&
+        Cycle + Stats_sampler->get_interval() > Stats_sample_cycle)
+    {
+      Stats_sampler->sample(Cycle);
+      Stats_sample_cycle = Cycle + Stats_sampler->get_interval();
+    }
+
+    if (Trace_writer)
+      Trace_writer->flush();
+  }
+
   void simulator_t::run(word_t entry, uint64_t debug_cycle,
                         debug_format_e debug_fmt, std::ostream &debug_out,
                         bool debug_nopc, uint64_t max_cycles,
                         bool collect_instr_stats)
+  {
+    try
+    {
+      step(entry, debug_cycle, debug_fmt, debug_out, debug_nopc, max_cycles,
+           collect_instr_stats);
+    }
+    catch (simulation_exception_t e)
+    {
+      finalize();
+
+      // pass on to caller
+      throw e;
+    }
+
+    finalize();
+  }
+
+  void simulator_t::step(word_t entry, uint64_t debug_cycle,
+                         debug_format_e debug_fmt, std::ostream &debug_out,
+                         bool debug_nopc, uint64_t max_cycles,
+                         bool collect_instr_stats)
   {
     // do some initializations before executing the first instruction.
     if (Cycle == 0)
@@ -390,6 +778,41 @@ namespace patmos
       Dbg_stack.initialize(entry);
     }
 
+    if (Is_default_core)
+    {
+      step_core<default_core_t>(debug_cycle, debug_fmt, debug_out, debug_nopc,
+                                max_cycles, collect_instr_stats);
+    }
+    else
+    {
+      step_core<generic_core_t>(debug_cycle, debug_fmt, debug_out, debug_nopc,
+                                max_cycles, collect_instr_stats);
+    }
+  }
+
+  template<typename COMPONENTS>
+  void simulator_t::tick_components()
+  {
+    Local_memory.tick(*this);
+    profile(SP_LOCAL_MEMORY);
+    static_cast<typename COMPONENTS::memory_type&>(Memory).tick(*this);
+    profile(SP_MEMORY);
+    static_cast<typename COMPONENTS::instr_cache_type&>(Instr_cache).
+                                                                  tick(*this);
+    profile(SP_ICACHE);
+    static_cast<typename COMPONENTS::data_cache_type&>(Data_cache).
+                                                                  tick(*this);
+    profile(SP_DCACHE);
+    static_cast<typename COMPONENTS::stack_cache_type&>(Stack_cache).
+                                                                  tick(*this);
+    profile(SP_SCACHE);
+  }
+
+  template<typename COMPONENTS>
+  void simulator_t::step_core(uint64_t debug_cycle, debug_format_e debug_fmt,
+                              std::ostream &debug_out, bool debug_nopc,
+                              uint64_t max_cycles, bool collect_instr_stats)
+  {
     try
     {
       // start of main simulation loop
@@ -398,70 +821,44 @@ namespace patmos
         bool debug = (Cycle >= debug_cycle);
         bool debug_pipeline = debug && (debug_fmt >= DF_LONG);
 
+        // measure the host time of the components in some iterations
+        Is_self_profiled = Self_profile && Self_profile->begin_iteration();
+
         // reset the stall counter.
         Stall = SXX;
 
         // Simulate the instruction fetch stage first.
         // MW stage might need the nPC from instruction fetch for return info.
         if (!Disable_IF) {
-          instruction_fetch();
+          instruction_fetch<COMPONENTS>();
+          profile(SP_DECODE);
         }
 
         // invoke simulation functions
         pipeline_invoke(SMW, &instruction_data_t::MW, debug_pipeline);
+        profile(SP_MW);
         pipeline_invoke(SEX, &instruction_data_t::EX, debug_pipeline);
+        profile(SP_EX);
         pipeline_invoke(SDR, &instruction_data_t::DR, debug_pipeline);
+        profile(SP_DR);
         // invoke IF only for printing
-        pipeline_invoke(SIF, NULL, debug_pipeline);
+        if (debug_pipeline) {
+          pipeline_invoke(SIF, NULL, debug_pipeline);
+          profile(SP_PRINT);
+        }
 
         // print instructions in EX stage
         if (debug && debug_fmt == DF_INSTRUCTIONS)
         {
           print_instructions(debug_out, SEX, debug_nopc);
+          profile(SP_PRINT);
         }
 
         track_retiring_instructions();
 
-        // Check for load hazards ..
-        if (!is_stalling(SMW)) {
-          const instruction_t *mem_instr = Pipeline[SMW][0].I;
-
-          if (mem_instr && mem_instr->is_load()) {
-            GPR_e dst = mem_instr->get_dst_reg(Pipeline[SMW][0]);
-
-            if (dst != r0) {
-              for (unsigned int j = 0; j < NUM_SLOTS; j++) {
-                const instruction_t *ex_instr = Pipeline[SEX][j].I;
-                if (  ex_instr && 
-                      // Either operand is the same as the source of the previous load instruction
-                      (ex_instr->get_src1_reg(Pipeline[SEX][j]) == dst ||
-                      ex_instr->get_src2_reg(Pipeline[SEX][j]) == dst) &&
-                      // The instruction is being executed (predicate is true)
-                      PRR.get(Pipeline[SEX][j].Pred).get() &&
-                      // The previous load instruction is being executed
-                      PRR.get(Pipeline[SMW][0].Pred).get())
-                {
-                  simulation_exception_t::illegal("Use of load result without delay slot!",
-                    Pipeline[SEX][j]
-                  );
-                }
-              }
-            }
-          }
-        }
+        check_load_hazard();
 
-        // Move pipeline stages and insert bubbles after stalling stage.
-        // If Stall == SXX, we do not stall, but a bubble is inserted in SIF,
-        // which is later replaced by the fetched instruction.
-        for (int i = SMW; i >= Stall+1; i--)
-        {
-          for (unsigned int j = 0; j < NUM_SLOTS; j++)
-          {
-            Pipeline[i][j] = (i==Stall+1)
-                                ? instruction_data_t() // insert bubble
-                                : Pipeline[i-1][j];    // get previous stage
-          }
-        }
+        advance_pipeline();
 
         // Update the Program counter. Either nPC was updated in the fetch stage
         // or it was overwritten by a CFL instruction in EX/MW stage.
@@ -472,34 +869,28 @@ namespace patmos
             flush_caches();
           }
 
+          // finish the current cycle when reaching the stop PC
+          if (PC != nPC && nPC == Stop_PC) {
+            max_cycles = cycle + 1;
+          }
+
           PC = nPC;
           // We just inserted a bubble at SIF before, enable fetching for
           // this new instruction.
           Disable_IF = false;
         }
 
-        // if we are stalling in MW, reset the bypass in EX so that it can be
-        // filled by the stalled EX stage again (needs to be done for all
-        // stalled bypasses).
-        if (is_stalling(SEX)) {
-          for(unsigned int i = 0; i < NUM_SLOTS; i++)
-          {
-            Pipeline[SEX][i].GPR_EX_Rd.reset();
-          }
-        }
-
         // track pipeline stalls
         Num_stall_cycles[Stall]++;
+        profile(SP_PIPELINE);
 
         // advance the time for the method cache, stack cache, and memory
-        Local_memory.tick(*this);
-        Memory.tick(*this);
-        Instr_cache.tick(*this);
-        Stack_cache.tick(*this);
+        tick_components<COMPONENTS>();
 
         if (debug)
         {
           print(debug_out, debug_fmt, debug_nopc);
+          profile(SP_PRINT);
         }
 
         // Collect stats for instructions
@@ -507,94 +898,181 @@ namespace patmos
           for (unsigned int j = 0; j < NUM_SLOTS; j++)
           {
             if (Pipeline[SMW][j].I && Pipeline[SMW][j].I->ID >= 0) {
-              // I am too lazy now to remove all the const's..
-              instruction_t &I(Decoder.get_instruction(Pipeline[SMW][j].I->ID));
+              instruction_t &I(*Stats_instructions[Pipeline[SMW][j].I->ID]);
               I.collect_stats(*this, Pipeline[SMW][j]);
             }
           }
         }
+
+        // write a sample of the statistics at the end of each interval
+        if (Cycle + 1 >= Stats_sample_cycle)
+        {
+          Stats_sampler->sample(Cycle + 1);
+          Stats_sample_cycle = Cycle + 1 + Stats_sampler->get_interval();
+        }
+        profile(SP_STATS);
+
+        // skip ahead while the pipeline is waiting for the memory, but do not
+        // skip over the start of the debug output, the cycle limit, or the
+        // end of a sampling interval.
+        if (!debug && Stall == SMW)
+        {
+          uint64_t idle = std::min(std::min(debug_cycle - Cycle - 1,
+                                            max_cycles - cycle - 1),
+                                   std::min(Stats_sample_cycle - Cycle - 2,
+                                            get_idle_cycles<COMPONENTS>()));
+          if (idle)
+          {
+            skip_idle_cycles<COMPONENTS>(idle);
+            cycle += idle;
+            Cycle += idle;
+          }
+          profile(SP_SKIP);
+        }
       } // end of simulation loop
     }
     catch (simulation_exception_t e)
     {
-      Profiling.finalize(Cycle);
+      // pass on to caller
+      e.set_cycle(Cycle, PC);
+      throw e;
+    }
+  }
+
+  void simulator_t::warm_up(word_t entry, uword_t address,
+                            uint64_t max_instructions, uint64_t max_cycles)
+  {
+    // do some initializations before executing the first instruction.
+    if (Cycle == 0)
+    {
+      BASE = PC = nPC = entry;
+      Instr_cache.initialize(*this, entry);
+      Profiling.initialize(entry);
+      Dbg_stack.initialize(entry);
+    }
+
+    Is_functional = true;
+    Is_self_profiled = false;
+
+    try
+    {
+      uint64_t num_instructions = 0;
+
+      // the pipeline still defines the semantics of the instructions, only
+      // the memories do not stall and no statistics are collected.
+      for(uint64_t cycle = 0;
+          cycle < max_cycles && num_instructions < max_instructions;
+          cycle++, Cycle++)
+      {
+        // reset the stall counter.
+        Stall = SXX;
+
+        if (!Disable_IF) {
+          instruction_fetch<generic_core_t>();
+        }
+
+        pipeline_invoke(SMW, &instruction_data_t::MW);
+        pipeline_invoke(SEX, &instruction_data_t::EX);
+        pipeline_invoke(SDR, &instruction_data_t::DR);
+
+        // count the instructions leaving the pipeline whose predicate is
+        // true, see track_retiring_instructions
+        if (!is_stalling(SMW)) {
+          for (unsigned int j = 0; j < NUM_SLOTS; j++)
+          {
+            const instruction_data_t &ops = Pipeline[SMW][j];
+            if (ops.I && ops.I->ID >= 0 && ops.DR_Pred)
+              num_instructions++;
+          }
+        }
+
+        advance_pipeline();
+
+        if (!is_stalling(SIF)) {
+          if (PC != nPC && nPC == Flush_Cache_PC) {
+            flush_caches();
+          }
+
+          // finish the warm-up when reaching the given address
+          if (PC != nPC && nPC == address) {
+            max_cycles = cycle + 1;
+          }
+
+          PC = nPC;
+          Disable_IF = false;
+        }
+
+        // devices and caches may still depend on the time passing
+        tick_components<generic_core_t>();
+      }
+    }
+    catch (simulation_exception_t e)
+    {
+      Is_functional = false;
 
       // pass on to caller
       e.set_cycle(Cycle, PC);
       throw e;
     }
 
-    Profiling.finalize(Cycle);
+    Is_functional = false;
   }
 
   void simulator_t::print_registers(std::ostream &os,
-                                    debug_format_e debug_fmt, bool nopc) const
+                                    debug_format_e debug_fmt, bool nopc,
+                                    debug_sink_t *sink) const
   {
+    word_t gpr[NUM_GPR];
+    for(unsigned int r = r0; r < NUM_GPR; r++)
+    {
+      gpr[r] = GPR.get((GPR_e)r).get();
+    }
+
     if (debug_fmt == DF_SHORT)
     {
-      for(unsigned int r = r0; r < NUM_GPR; r++)
-      {
-        os << boost::format(" r%1$-2d: %2$08x") % r % GPR.get((GPR_e)r).get();
-      }
+      if (sink)
+        sink->registers('r', r0, gpr, NUM_GPR, true);
+      else
+        print_debug_registers(os, 'r', r0, gpr, NUM_GPR, true);
       os << "\n";
     }
     else
     {
-      if (!nopc) {
-        os << boost::format("\nCyc : %1%\n PRR: ") % Cycle;
-      } else {
-        os << "PRR: ";
-      }
-
-      // print values of predicate registers
+      // get values of predicate registers, printed as s0.
       unsigned int sz_value = 0;
       for(int p = NUM_PRR - 1; p >= 0; p--)
       {
-        bit_t pred_value = PRR.get((PRR_e)p).get();
-        sz_value |= pred_value << p;
-        os << pred_value;
+        sz_value |= PRR.get((PRR_e)p).get() << p;
       }
 
-      if (!nopc) {
-        os << boost::format("  BASE: %1$08x   PC : %2$08x   ")
-          % BASE % PC;
-
-        Symbols.print(os, PC);
+      word_t spr[NUM_SPR];
+      spr[s0] = sz_value;
+      for(unsigned int s = s1; s < NUM_SPR; s++)
+      {
+        spr[s] = SPR.get((SPR_e)s).get();
       }
 
+      if (sink)
+        sink->header(Cycle, PC, BASE, sz_value, nopc, Symbols);
+      else
+        print_debug_header(os, Cycle, PC, BASE, sz_value, nopc, Symbols);
+
       os << "\n ";
 
       // print values of general purpose registers
-      for(unsigned int r = r0; r < NUM_GPR; r++)
-      {
-        os << boost::format("r%1$-2d: %2$08x") % r % GPR.get((GPR_e)r).get();
+      if (sink)
+        sink->registers('r', r0, gpr, NUM_GPR, false);
+      else
+        print_debug_registers(os, 'r', r0, gpr, NUM_GPR, false);
 
-        if ((r & 0x7) == 7)
-        {
-          os << "\n ";
-        }
-        else
-        {
-          os << "   ";
-        }
-      }
       os << "\n ";
 
-      // print values of special purpose registers -- special handling of SZ.
-      os << boost::format("s0 : %1$08x   ") % sz_value;
-      for(unsigned int s = s1; s < NUM_SPR; s++)
-      {
-        os << boost::format("s%1$-2d: %2$08x") % s % SPR.get((SPR_e)s).get();
+      // print values of special purpose registers
+      if (sink)
+        sink->registers('s', s0, spr, NUM_SPR, false);
+      else
+        print_debug_registers(os, 's', s0, spr, NUM_SPR, false);
 
-        if ((s & 0x7) == 7)
-        {
-          os << "\n ";
-        }
-        else
-        {
-          os << "   ";
-        }
-      }
       os << "\n";
     }
   }
@@ -651,7 +1129,7 @@ namespace patmos
 
   void simulator_t::print(std::ostream &os, debug_format_e debug_fmt, bool nopc)
   {
-    if (debug_fmt == DF_TRACE)
+    if (debug_fmt == DF_TRACE || debug_fmt == DF_BTRACE)
     {
       // CAVEAT: this trace mode is used by platin's 'analyze-trace' module
       // do not change without adapting platin
@@ -670,14 +1148,28 @@ namespace patmos
           // Make the trace analysis happy, needed to handle delayed returns.
           Dbg_cnt_delay--;
         } else {
-          if (!Watchpoints.empty() && !Watchpoints.count(addr)) {
+          if (Watchpoints.watches(WK_EXEC) &&
+              !Watchpoints.contains(addr, WK_EXEC)) {
             return;
           }
         }
 
-        os << std::hex << std::setw(8) << std::setfill('0') << addr << ' '
-            << std::dec << Cycle << ' '
-            << Traced_instructions << '\n' << std::setfill(' ');
+        // with a debug sink the records are formatted by its writer thread
+        if (Debug_sink)
+        {
+          Debug_sink->trace(addr, Cycle, Traced_instructions,
+                            debug_fmt == DF_BTRACE);
+        }
+        else if (debug_fmt == DF_BTRACE)
+        {
+          if (!Trace_writer)
+            Trace_writer = new trace_writer_t(os);
+          Trace_writer->write(addr, Cycle, Traced_instructions);
+        }
+        else
+        {
+          print_trace_record(os, addr, Cycle, Traced_instructions);
+        }
 
         if (Pipeline[SMW][0].I && Pipeline[SMW][0].I->is_return()) {
           // Emit the delay slot of the return and the next instruction
@@ -699,11 +1191,10 @@ namespace patmos
         if (Symbols.contains(PC) ||
             PC < Debug_last_PC || PC > Debug_last_PC + NUM_SLOTS * 4)
         {
-          if (!nopc) {
-            os << boost::format("%1$08x %2$9d ") % PC % Cycle;
-          }
-          Symbols.print(os, PC);
-          os << "\n";
+          if (Debug_sink)
+            Debug_sink->block(PC, Cycle, nopc, Symbols);
+          else
+            print_debug_block(os, PC, Cycle, nopc, Symbols);
         }
         // Remember the current PC to check for jumps
         Debug_last_PC = PC;
@@ -716,15 +1207,17 @@ namespace patmos
 
         if (Dbg_is_intr) {
           // Anything operands we can print for an interrupt call?
-        } else if (Dbg_is_call) {
-          os << " args: " << boost::format("r3 = %1$08x, r4 = %2$08x, ")
-                % read_GPR_post_EX(*this, r3) % read_GPR_post_EX(*this, r4);
-          os << boost::format("r5 = %1$08x, r6 = %2$08x, r7 = %3$08x, r8 = %4$08x")
-                % read_GPR_post_EX(*this, r5) % read_GPR_post_EX(*this, r6)
-                % read_GPR_post_EX(*this, r7) % read_GPR_post_EX(*this, r8);
         } else {
-          os << " retval: " << boost::format("r1 = %1$08x, r2 = %2$08x")
-                % read_GPR_post_EX(*this, r1) % read_GPR_post_EX(*this, r2);
+          word_t values[6];
+          unsigned int first = Dbg_is_call ? r3 : r1;
+          for (unsigned int i = 0; i < (Dbg_is_call ? 6u : 2u); i++) {
+            values[i] = read_GPR_post_EX(*this, (GPR_e)(first + i));
+          }
+
+          if (Debug_sink)
+            Debug_sink->call_values(Dbg_is_call, values);
+          else
+            print_debug_call_values(os, Dbg_is_call, values);
         }
         os << "\n";
         Dbg_cnt_delay = 0;
@@ -761,28 +1254,27 @@ namespace patmos
           Dbg_is_intr = true;
         }
         if (Dbg_cnt_delay) {
-          if (!nopc) {
-            os << boost::format("%1$08x %2$9d ") % PC % Cycle;
-          }
-
-          if (debug_fmt == DF_CALLS_INDENT) {
-            for (unsigned i = 0; i < Dbg_stack.size(); i++) {
-              os << "  ";
-            }
-          }
-          os << (Dbg_is_intr ? "interrupt" : (Dbg_is_call ? "call" : "return"));
-          if (Dbg_cnt_delay == 1) os << " (nd)";
-          os << " from ";
-          Symbols.print(os, Pipeline[SMW][0].Address, true);
-          os << " to ";
-          Symbols.print(os, Pipeline[SMW][0].EX_Address, true);
+          debug_call_e kind = Dbg_is_intr ? DC_INTERRUPT :
+                                            (Dbg_is_call ? DC_CALL : DC_RETURN);
+          unsigned int indent = (debug_fmt == DF_CALLS_INDENT) ?
+                                                        Dbg_stack.size() : 0;
+          bool nd = (Dbg_cnt_delay == 1);
+
+          if (Debug_sink)
+            Debug_sink->call(kind, PC, Cycle, indent, nd,
+                             Pipeline[SMW][0].Address,
+                             Pipeline[SMW][0].EX_Address, nopc, Symbols);
+          else
+            print_debug_call(os, kind, PC, Cycle, indent, nd,
+                             Pipeline[SMW][0].Address,
+                             Pipeline[SMW][0].EX_Address, nopc, Symbols);
         }
       }
     }
     else
     {
       // print register values
-      print_registers(os, debug_fmt, nopc);
+      print_registers(os, debug_fmt, nopc, Debug_sink);
 
       if (debug_fmt == DF_ALL)
       {
@@ -809,11 +1301,19 @@ namespace patmos
 
   void simulator_t::flush_caches()
   {
-    Instr_cache.flush_cache();
-    Data_cache.flush_cache();
+    Instr_cache.flush_cache(*this);
+    Data_cache.flush_cache(*this);
+    Decoder.flush_decode_cache();
+    flush_blocks();
     // TODO flush the stack cache
   }
 
+  void simulator_t::wait_for_shared_access()
+  {
+    Multicore->wait_for_turn(Core_id);
+    Is_shared_access_granted = true;
+  }
+
   void simulator_t::reset_stats()
   {
     // TODO reset the statistics in the pipeline stages in the correct cycles.
@@ -834,6 +1334,7 @@ namespace patmos
     }
 
     Num_NOPs = 0;
+    Num_retired = 0;
     Stats_Start_Cycle = Cycle;
 
     Instr_cache.reset_stats();
@@ -851,6 +1352,15 @@ namespace patmos
   void simulator_t::print_stats(std::ostream &os,
                                 const stats_options_t &options) const
   {
+    // write all counters in a machine-readable format
+    if (options.format != SF_TEXT)
+    {
+      stats_counters_t counters;
+      add_stats(counters, options);
+      counters.write(os, options.format);
+      return;
+    }
+
     // print register values
     if (!options.short_stats) {
       print_registers(os, DF_DEFAULT);
@@ -885,7 +1395,7 @@ namespace patmos
     for(unsigned int i = 0; i < Instruction_stats[0].size(); i++)
     {
       // get instruction and statistics on it
-      const instruction_t &I(Decoder.get_instruction(i));
+      const instruction_t &I(*Stats_instructions[i]);
 
       if (!options.short_stats) {
         os << boost::format("   %1$15s:") % I.Name;
@@ -1032,6 +1542,253 @@ namespace patmos
     os << "\n";
   }
 
+  /// Checkpoint identifier of an empty pipeline slot.
+  static const int CHECKPOINT_NO_INSTR = -3;
+
+  /// Checkpoint identifier of the invalid instruction.
+  static const int CHECKPOINT_INVALID_INSTR = -4;
+
+  int simulator_t::get_checkpoint_id(const instruction_t *I) const
+  {
+    if (!I)
+      return CHECKPOINT_NO_INSTR;
+    else if (I == &instruction_data_t::Invalid_Instr)
+      return CHECKPOINT_INVALID_INSTR;
+    else
+      return I->ID;
+  }
+
+  const instruction_t *simulator_t::get_checkpoint_instruction(
+                                        checkpoint_reader_t &cr, int id) const
+  {
+    if (id == CHECKPOINT_NO_INSTR)
+      return NULL;
+    else if (id == CHECKPOINT_INVALID_INSTR)
+      return &instruction_data_t::Invalid_Instr;
+    else if (id == Instr_INTR->ID)
+      return Instr_INTR;
+    else if (id == Instr_HALT->ID)
+      return Instr_HALT;
+    else if (id < 0 || (unsigned int)id >= Decoder.get_num_instructions())
+      cr.error("invalid instruction in the pipeline");
+
+    return &Decoder.get_instruction(id);
+  }
+
+  /// Write a register operand of an instruction in the pipeline to a
+  /// checkpoint.
+  static void save_operand(checkpoint_writer_t &cw, const GPR_op_t &op)
+  {
+    cw.write<uint32_t>(op.get_index());
+    cw.write(op.get());
+  }
+
+  /// Read a register operand of an instruction in the pipeline from a
+  /// checkpoint.
+  static GPR_op_t restore_operand(checkpoint_reader_t &cr)
+  {
+    uint32_t index = cr.read<uint32_t>();
+    word_t value = cr.read<word_t>();
+    if (index >= NUM_GPR)
+      cr.error("invalid register in the pipeline");
+
+    return GPR_op_t((GPR_e)index, value);
+  }
+
+  /// Write the operands and the values of the pipeline stages of an
+  /// instruction in the pipeline to a checkpoint, except for the instruction
+  /// itself.
+  static void save_bundle(checkpoint_writer_t &cw,
+                          const instruction_data_t &ops)
+  {
+    // all operand fields are register indices or immediates of one word
+    word_t operands[sizeof(ops.OPS) / sizeof(word_t)];
+    static_assert(sizeof(ops.OPS) == sizeof(operands),
+                  "operands do not consist of words");
+    std::memcpy(operands, &ops.OPS, sizeof(operands));
+
+    cw.write(ops.Address);
+    cw.write<uint32_t>(ops.Pred);
+    for(unsigned int i = 0; i < sizeof(operands) / sizeof(word_t); i++)
+    {
+      cw.write(operands[i]);
+    }
+
+    cw.write(ops.DR_Ss);
+    cw.write(ops.DR_St);
+    save_operand(cw, ops.DR_Rs1);
+    save_operand(cw, ops.DR_Rs2);
+    cw.write(ops.DR_Ps1);
+    cw.write(ops.DR_Ps2);
+    cw.write(ops.DR_Pred);
+    cw.write(ops.MW_Discard);
+    cw.write(ops.MW_Initialized);
+
+    cw.write(ops.EX_result);
+    cw.write(ops.EX_mull);
+    cw.write(ops.EX_mulh);
+    cw.write(ops.EX_Ss);
+    cw.write(ops.EX_St);
+    cw.write(ops.GPR_EX_Rd.is_active());
+    if (ops.GPR_EX_Rd.is_active())
+    {
+      save_operand(cw, ops.GPR_EX_Rd.get());
+    }
+    cw.write(ops.EX_Rs);
+    cw.write(ops.EX_Address);
+    cw.write(ops.EX_Base);
+    cw.write(ops.EX_Offset);
+  }
+
+  /// Read the operands and the values of the pipeline stages of an
+  /// instruction in the pipeline from a checkpoint.
+  /// \see save_bundle
+  static void restore_bundle(checkpoint_reader_t &cr, instruction_data_t &ops)
+  {
+    word_t operands[sizeof(ops.OPS) / sizeof(word_t)];
+
+    cr.read(ops.Address);
+    uint32_t pred = cr.read<uint32_t>();
+    if (pred >= NUM_PRRn)
+      cr.error("invalid predicate in the pipeline");
+    ops.Pred = (PRR_e)pred;
+    for(unsigned int i = 0; i < sizeof(operands) / sizeof(word_t); i++)
+    {
+      cr.read(operands[i]);
+    }
+    std::memcpy(&ops.OPS, operands, sizeof(operands));
+
+    cr.read(ops.DR_Ss);
+    cr.read(ops.DR_St);
+    ops.DR_Rs1 = restore_operand(cr);
+    ops.DR_Rs2 = restore_operand(cr);
+    cr.read(ops.DR_Ps1);
+    cr.read(ops.DR_Ps2);
+    cr.read(ops.DR_Pred);
+    cr.read(ops.MW_Discard);
+    cr.read(ops.MW_Initialized);
+
+    cr.read(ops.EX_result);
+    cr.read(ops.EX_mull);
+    cr.read(ops.EX_mulh);
+    cr.read(ops.EX_Ss);
+    cr.read(ops.EX_St);
+    ops.GPR_EX_Rd.reset();
+    if (cr.read<bool>())
+    {
+      ops.GPR_EX_Rd.set(restore_operand(cr));
+    }
+    cr.read(ops.EX_Rs);
+    cr.read(ops.EX_Address);
+    cr.read(ops.EX_Base);
+    cr.read(ops.EX_Offset);
+  }
+
+  void simulator_t::save_state(checkpoint_writer_t &cw) const
+  {
+    // instructions in the pipeline are stored by their index in the
+    // instruction set, the kinds of the components are checked by the caller
+    cw.write_config(Decoder.get_num_instructions());
+
+    cw.write(Cycle);
+    cw.write(BASE);
+    cw.write(PC);
+    cw.write(nPC);
+    cw.write(Debug_last_PC);
+    cw.write(Stall);
+    cw.write(Disable_IF);
+    cw.write(Delay_counter);
+    cw.write(Halt);
+    cw.write(Exception_handling_counter);
+
+    for(unsigned int r = r0; r < NUM_GPR; r++)
+    {
+      cw.write(GPR.get((GPR_e)r).get());
+    }
+    for(unsigned int p = p0; p < NUM_PRR; p++)
+    {
+      cw.write(PRR.get((PRR_e)p).get());
+    }
+    for(unsigned int r = s0; r < NUM_SPR; r++)
+    {
+      cw.write(SPR.get((SPR_e)r).get());
+    }
+
+    for(unsigned int i = 0; i < NUM_STAGES; i++)
+    {
+      for(unsigned int j = 0; j < NUM_SLOTS; j++)
+      {
+        cw.write(get_checkpoint_id(Pipeline[i][j].I));
+        save_bundle(cw, Pipeline[i][j]);
+      }
+    }
+
+    Memory.save_state(cw);
+    Local_memory.save_state(cw);
+    Data_cache.save_state(cw);
+    Instr_cache.save_state(cw);
+    Stack_cache.save_state(cw);
+  }
+
+  void simulator_t::restore_state(checkpoint_reader_t &cr)
+  {
+    cr.check_config(Decoder.get_num_instructions(), "instruction set");
+
+    cr.read(Cycle);
+    cr.read(BASE);
+    cr.read(PC);
+    cr.read(nPC);
+    cr.read(Debug_last_PC);
+    cr.read(Stall);
+    cr.read(Disable_IF);
+    cr.read(Delay_counter);
+    cr.read(Halt);
+    cr.read(Exception_handling_counter);
+
+    for(unsigned int r = r0; r < NUM_GPR; r++)
+    {
+      GPR.set((GPR_e)r, cr.read<word_t>());
+    }
+    for(unsigned int p = p0; p < NUM_PRR; p++)
+    {
+      PRR.set((PRR_e)p, cr.read<bit_t>());
+    }
+    for(unsigned int r = s0; r < NUM_SPR; r++)
+    {
+      SPR.set((SPR_e)r, cr.read<word_t>());
+    }
+
+    for(unsigned int i = 0; i < NUM_STAGES; i++)
+    {
+      for(unsigned int j = 0; j < NUM_SLOTS; j++)
+      {
+        int id = cr.read<int>();
+        Pipeline[i][j].I = get_checkpoint_instruction(cr, id);
+        restore_bundle(cr, Pipeline[i][j]);
+      }
+    }
+
+    Memory.restore_state(cr);
+    Local_memory.restore_state(cr);
+    Data_cache.restore_state(cr);
+    Instr_cache.restore_state(cr);
+    Stack_cache.restore_state(cr);
+
+    // the decode cache is tagged with the instruction words, the restored
+    // code is thus never served from stale entries. The restored pipeline
+    // does not refer to translated bundles.
+    flush_blocks();
+
+    // statistics and profiling start at the restored cycle, a simulation
+    // that was not started yet is initialized by step as usual.
+    Stats_Start_Cycle = Cycle;
+    if (Cycle != 0)
+    {
+      Profiling.initialize(BASE, Cycle);
+      Dbg_stack.initialize(BASE);
+    }
+  }
+
 
   std::ostream &operator<<(std::ostream &os, Pipeline_t p)
   {
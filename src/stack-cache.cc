@@ -35,9 +35,11 @@
 //
 #include "stack-cache.h"
 
+#include "checkpoint.h"
 #include "memory.h"
 #include "exception.h"
 #include "simulation-core.h"
+#include "stats-counters.h"
 
 #include <cmath>
 #include <ostream>
@@ -223,6 +225,18 @@ uword_t ideal_stack_cache_t::size() const
   return Content.size();
 }
 
+void ideal_stack_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write<uint64_t>(Content.size());
+  cw.write(Content.data(), Content.size());
+}
+
+void ideal_stack_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  Content.resize(cr.read<uint64_t>());
+  cr.read(Content.data(), Content.size());
+}
+
 
 
 bool proxy_stack_cache_t::read(simulator_t &s, uword_t address, byte_t *value, uword_t size, bool is_fetch)
@@ -240,6 +254,18 @@ void proxy_stack_cache_t::read_peek(simulator_t &s, uword_t address, byte_t *val
   return Memory.read_peek(s, stack_top + address, value, size, is_fetch);
 }
 
+void proxy_stack_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  ideal_stack_cache_t::save_state(cw);
+  cw.write(stack_top);
+}
+
+void proxy_stack_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  ideal_stack_cache_t::restore_state(cr);
+  cr.read(stack_top);
+}
+
 
 
 
@@ -609,6 +635,13 @@ bool block_stack_cache_t::write(simulator_t &s, uword_t address, byte_t *value,
   return true;
 }
 
+void block_stack_cache_t::skip_cycles(simulator_t &s, uint64_t cycles)
+{
+  // a pending spill or fill counts a stall cycle whenever it is retried
+  if (Phase != IDLE)
+    Num_stall_cycles += cycles;
+}
+
 void block_stack_cache_t::print(const simulator_t &s, std::ostream &os) const
 {
   uword_t reserved_blocks = Content.size() / Num_block_bytes;
@@ -669,6 +702,42 @@ void block_stack_cache_t::reset_stats()
   Num_stall_cycles = 0;
 }
 
+void block_stack_cache_t::add_counters(stats_counters_t &counters)
+{
+  counters.add("blocks_spilled", Num_blocks_spilled);
+  counters.add("max_blocks_spilled", Max_blocks_spilled, true);
+  counters.add("blocks_filled", Num_blocks_filled);
+  counters.add("max_blocks_filled", Max_blocks_filled, true);
+  counters.add("blocks_reserved", Num_blocks_reserved);
+  counters.add("max_blocks_reserved", Max_blocks_reserved, true);
+  counters.add("reads", Num_read_accesses);
+  counters.add("bytes_read", Num_bytes_read);
+  counters.add("writes", Num_write_accesses);
+  counters.add("bytes_written", Num_bytes_written);
+  counters.add("emptying_frees", Num_free_empty);
+  counters.add("stall_cycles", Num_stall_cycles);
+}
+
+void block_stack_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write_config(Num_blocks);
+  cw.write_config(Num_block_bytes);
+
+  ideal_stack_cache_t::save_state(cw);
+  cw.write(Phase);
+  cw.write(Buffer, Num_blocks * Num_block_bytes);
+}
+
+void block_stack_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.check_config(Num_blocks, "stack cache size");
+  cr.check_config(Num_block_bytes, "stack cache block size");
+
+  ideal_stack_cache_t::restore_state(cr);
+  cr.read(Phase);
+  cr.read(Buffer, Num_blocks * Num_block_bytes);
+}
+
 block_aligned_stack_cache_t::block_aligned_stack_cache_t(memory_t &memory,
                           unsigned int num_blocks, unsigned int num_block_bytes)
   : block_stack_cache_t(memory, (num_blocks*num_block_bytes)/4, 4),
@@ -679,6 +748,18 @@ block_aligned_stack_cache_t::block_aligned_stack_cache_t(memory_t &memory,
 {
 }
 
+void block_aligned_stack_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  cw.write_config(Num_transfer_block_bytes);
+  block_stack_cache_t::save_state(cw);
+}
+
+void block_aligned_stack_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  cr.check_config(Num_transfer_block_bytes, "stack cache transfer size");
+  block_stack_cache_t::restore_state(cr);
+}
+
 word_t block_aligned_stack_cache_t::prepare_reserve(simulator_t &s,
                                                     uword_t size,
                                                     uword_t &stack_spill,
@@ -832,6 +913,18 @@ void block_aligned_stack_cache_t::reset_stats()
   Max_words_free_filled = 0;
 }
 
+void block_aligned_stack_cache_t::add_counters(stats_counters_t &counters)
+{
+  block_stack_cache_t::add_counters(counters);
+
+  counters.add("words_spilled", Num_words_spilled);
+  counters.add("max_words_spilled", Max_words_spilled, true);
+  counters.add("words_filled", Num_words_filled);
+  counters.add("max_words_filled", Max_words_filled, true);
+  counters.add("words_free_filled", Num_words_free_filled);
+  counters.add("max_words_free_filled", Max_words_free_filled, true);
+}
+
 block_lazy_stack_cache_t::block_lazy_stack_cache_t(memory_t &memory,
                                                  unsigned int num_blocks,
                                                  unsigned int num_block_bytes) :
@@ -1014,3 +1107,27 @@ void block_lazy_stack_cache_t::reset_stats()
   Num_blocks_not_spilled = 0;
   Max_blocks_not_spilled = 0;
 }
+
+void block_lazy_stack_cache_t::add_counters(stats_counters_t &counters)
+{
+  block_stack_cache_t::add_counters(counters);
+
+  counters.add("blocks_not_spilled", Num_blocks_not_spilled);
+  counters.add("max_blocks_not_spilled", Max_blocks_not_spilled, true);
+}
+
+void block_lazy_stack_cache_t::save_state(checkpoint_writer_t &cw) const
+{
+  block_stack_cache_t::save_state(cw);
+  cw.write(Lazy_pointer);
+  cw.write(Next_Lazy_pointer);
+  cw.write(Num_blocks_to_evict);
+}
+
+void block_lazy_stack_cache_t::restore_state(checkpoint_reader_t &cr)
+{
+  block_stack_cache_t::restore_state(cr);
+  cr.read(Lazy_pointer);
+  cr.read(Next_Lazy_pointer);
+  cr.read(Num_blocks_to_evict);
+}
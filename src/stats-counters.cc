@@ -0,0 +1,295 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Named counters of the simulator's components and sampling of their
+// values in fixed intervals of cycles.
+//
+
+#include "stats-counters.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <boost/format.hpp>
+
+namespace patmos
+{
+  /// Write a name as a quoted JSON string.
+  /// @param os The stream to write to.
+  /// @param name The name.
+  static void write_json_string(std::ostream &os, const std::string &name)
+  {
+    os << '"';
+    for(unsigned int i = 0; i < name.size(); i++)
+    {
+      if (name[i] == '"' || name[i] == '\\')
+        os << '\\';
+      os << name[i];
+    }
+    os << '"';
+  }
+
+  /// Write a name as a CSV field, quoted if it contains separators.
+  /// @param os The stream to write to.
+  /// @param name The name.
+  static void write_csv_field(std::ostream &os, const std::string &name)
+  {
+    if (name.find_first_of(",\"\n") == std::string::npos)
+    {
+      os << name;
+      return;
+    }
+
+    os << '"';
+    for(unsigned int i = 0; i < name.size(); i++)
+    {
+      if (name[i] == '"')
+        os << '"';
+      os << name[i];
+    }
+    os << '"';
+  }
+
+  /// Write the names and values of counters as a table.
+  /// @param os The stream to write to.
+  /// @param counters The counters.
+  /// @param values The values to write for the counters.
+  static void write_text(std::ostream &os, const stats_counters_t &counters,
+                         const std::vector<uint64_t> &values)
+  {
+    unsigned int width = 0;
+    for(unsigned int i = 0; i < counters.size(); i++)
+    {
+      width = std::max<unsigned int>(width, counters.name(i).size());
+    }
+
+    for(unsigned int i = 0; i < counters.size(); i++)
+    {
+      const std::string &name(counters.name(i));
+      os << boost::format("   %1%%2% : %3$10d\n")
+          % name % std::string(width - name.size(), ' ') % values[i];
+    }
+  }
+
+  void stats_counters_t::add(const std::string &name,
+                             const unsigned int &counter, bool is_level)
+  {
+    counter_t c = {Prefix + name, &counter, NULL, 0, is_level};
+    Counters.push_back(c);
+  }
+
+  void stats_counters_t::add(const std::string &name, const uint64_t &counter,
+                             bool is_level)
+  {
+    counter_t c = {Prefix + name, NULL, &counter, 0, is_level};
+    Counters.push_back(c);
+  }
+
+  void stats_counters_t::add_value(const std::string &name, uint64_t value)
+  {
+    counter_t c = {Prefix + name, NULL, NULL, value, true};
+    Counters.push_back(c);
+  }
+
+  bool stats_counters_t::find(const std::string &name,
+                              unsigned int &index) const
+  {
+    for(unsigned int i = 0; i < Counters.size(); i++)
+    {
+      if (Counters[i].Name == name)
+      {
+        index = i;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void stats_counters_t::write(std::ostream &os, stats_format_e format) const
+  {
+    switch (format)
+    {
+      case SF_TEXT:
+      {
+        std::vector<uint64_t> values(Counters.size());
+        for(unsigned int i = 0; i < Counters.size(); i++)
+        {
+          values[i] = value(i);
+        }
+        write_text(os, *this, values);
+        break;
+      }
+      case SF_CSV:
+      {
+        os << "name,value\n";
+        for(unsigned int i = 0; i < Counters.size(); i++)
+        {
+          write_csv_field(os, Counters[i].Name);
+          os << ',' << value(i) << '\n';
+        }
+        break;
+      }
+      case SF_JSON:
+      {
+        // the objects enclosing the previous counter
+        std::vector<std::string> objects;
+        bool is_first = true;
+
+        os << '{';
+        for(unsigned int i = 0; i < Counters.size(); i++)
+        {
+          // split the name into the enclosing objects and the counter
+          std::vector<std::string> path;
+          std::string::size_type start = 0, dot;
+          while ((dot = Counters[i].Name.find('.', start)) != std::string::npos)
+          {
+            path.push_back(Counters[i].Name.substr(start, dot - start));
+            start = dot + 1;
+          }
+
+          // close the objects not enclosing this counter
+          unsigned int common = 0;
+          while (common < objects.size() && common < path.size() &&
+                 objects[common] == path[common])
+          {
+            common++;
+          }
+          while (objects.size() > common)
+          {
+            objects.pop_back();
+            os << '\n' << std::string(2 * objects.size() + 2, ' ') << '}';
+            is_first = false;
+          }
+
+          // open the objects enclosing this counter
+          for(; common < path.size(); common++)
+          {
+            os << (is_first ? "\n" : ",\n")
+               << std::string(2 * objects.size() + 2, ' ');
+            write_json_string(os, path[common]);
+            os << ": {";
+            objects.push_back(path[common]);
+            is_first = true;
+          }
+
+          os << (is_first ? "\n" : ",\n")
+             << std::string(2 * objects.size() + 2, ' ');
+          write_json_string(os, Counters[i].Name.substr(start));
+          os << ": " << value(i);
+          is_first = false;
+        }
+        while (!objects.empty())
+        {
+          objects.pop_back();
+          os << '\n' << std::string(2 * objects.size() + 2, ' ') << '}';
+        }
+        os << "\n}\n";
+        break;
+      }
+    }
+  }
+
+  stats_sampler_t::stats_sampler_t(std::ostream &os, stats_format_e format,
+                                   uint64_t interval) :
+      Os(os), Format(format), Interval(interval), Last_cycle(0),
+      Is_header_written(false)
+  {
+    assert(interval != 0);
+  }
+
+  void stats_sampler_t::start(uint64_t cycle)
+  {
+    Last_values.resize(Counters.size());
+    for(unsigned int i = 0; i < Counters.size(); i++)
+    {
+      Last_values[i] = Counters.value(i);
+    }
+
+    Last_cycle = cycle;
+  }
+
+  void stats_sampler_t::sample(uint64_t cycle)
+  {
+    std::vector<uint64_t> values(Counters.size());
+    for(unsigned int i = 0; i < Counters.size(); i++)
+    {
+      uint64_t value = Counters.value(i);
+      if (Counters.is_level(i))
+        values[i] = value;
+      else
+        values[i] = value >= Last_values[i] ? value - Last_values[i] : value;
+      Last_values[i] = value;
+    }
+
+    switch (Format)
+    {
+      case SF_TEXT:
+        Os << boost::format("Cycles %1% - %2%:\n") % Last_cycle % cycle;
+        write_text(Os, Counters, values);
+        Os << '\n';
+        break;
+      case SF_CSV:
+        if (!Is_header_written)
+        {
+          Os << "start,end";
+          for(unsigned int i = 0; i < Counters.size(); i++)
+          {
+            Os << ',';
+            write_csv_field(Os, Counters.name(i));
+          }
+          Os << '\n';
+          Is_header_written = true;
+        }
+
+        Os << Last_cycle << ',' << cycle;
+        for(unsigned int i = 0; i < Counters.size(); i++)
+        {
+          Os << ',' << values[i];
+        }
+        Os << '\n';
+        break;
+      case SF_JSON:
+        Os << "{\"start\": " << Last_cycle << ", \"end\": " << cycle;
+        for(unsigned int i = 0; i < Counters.size(); i++)
+        {
+          Os << ", ";
+          write_json_string(Os, Counters.name(i));
+          Os << ": " << values[i];
+        }
+        Os << "}\n";
+        break;
+    }
+
+    Last_cycle = cycle;
+  }
+}
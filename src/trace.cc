@@ -0,0 +1,268 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Compact binary format of the instruction trace (see DF_TRACE).
+//
+
+#include "trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <new>
+#include <string>
+
+#ifdef ZSTD
+#include <zstd.h>
+#endif
+
+namespace patmos
+{
+  /// Magic number at the start of a trace.
+  static const char TRACE_MAGIC[4] = { 'P', 'T', 'R', 'C' };
+
+  /// Version of the trace format, incremented on incompatible changes.
+  static const uint8_t TRACE_VERSION = 1;
+
+  /// Flag in the header marking a trace compressed with zstd.
+  static const uint8_t TRACE_ZSTD = 1;
+
+  /// Size of the trace header.
+  static const unsigned int TRACE_HEADER_BYTES = 8;
+
+  /// Maximal size of an encoded record.
+  static const unsigned int TRACE_RECORD_BYTES = 3 * 10;
+
+  trace_writer_t::trace_writer_t(std::ostream &stream)
+    : Stream(stream), Buffer(TRACE_BUFFER_BYTES), Buffer_size(0),
+      Compressor(NULL), Unterminated(false),
+      Last_address(0), Last_cycle(0), Last_count(0)
+  {
+#ifdef ZSTD
+    Compressor = ZSTD_createCCtx();
+    if (!Compressor)
+      throw std::bad_alloc();
+    Compressed.resize(ZSTD_CStreamOutSize());
+#endif
+
+    char header[TRACE_HEADER_BYTES] = { 0 };
+    std::memcpy(header, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header[4] = TRACE_VERSION;
+    header[5] = Compressor ? TRACE_ZSTD : 0;
+    Stream.write(header, TRACE_HEADER_BYTES);
+  }
+
+  trace_writer_t::~trace_writer_t()
+  {
+    // errors are reported by explicit calls to flush
+    try
+    {
+      flush();
+    }
+    catch (const std::ios_base::failure &)
+    {
+    }
+
+#ifdef ZSTD
+    ZSTD_freeCCtx((ZSTD_CCtx*)Compressor);
+#endif
+  }
+
+  void trace_writer_t::write_buffer(bool end)
+  {
+#ifdef ZSTD
+    if (Compressor)
+    {
+      // a frame is only terminated if records have been written since the
+      // end of the last one
+      if (end && !Unterminated && Buffer_size == 0)
+        return;
+
+      ZSTD_inBuffer in = { &Buffer[0], Buffer_size, 0 };
+      ZSTD_EndDirective mode = end ? ZSTD_e_end : ZSTD_e_continue;
+      size_t remaining;
+      do
+      {
+        ZSTD_outBuffer out = { &Compressed[0], Compressed.size(), 0 };
+        remaining = ZSTD_compressStream2((ZSTD_CCtx*)Compressor, &out, &in,
+                                         mode);
+        if (ZSTD_isError(remaining))
+        {
+          throw std::ios_base::failure(std::string("Failed to compress "
+                                       "trace: ") + ZSTD_getErrorName(remaining));
+        }
+        Stream.write((const char*)&Compressed[0], out.pos);
+      } while (end ? remaining != 0 : in.pos != in.size);
+
+      Unterminated = !end;
+      Buffer_size = 0;
+    }
+    else
+#endif
+    {
+      Stream.write((const char*)&Buffer[0], Buffer_size);
+      Buffer_size = 0;
+    }
+
+    if (!Stream)
+      throw std::ios_base::failure("Failed to write trace.");
+  }
+
+  void trace_writer_t::flush()
+  {
+    write_buffer(true);
+    Stream.flush();
+  }
+
+  trace_reader_t::trace_reader_t(std::istream &stream)
+    : Stream(stream), Buffer(TRACE_BUFFER_BYTES), Buffer_size(0),
+      Buffer_pos(0), Compressed_pos(0), Compressed_size(0),
+      Decompressor(NULL), Last_address(0), Last_cycle(0), Last_count(0)
+  {
+    char header[TRACE_HEADER_BYTES];
+    Stream.read(header, TRACE_HEADER_BYTES);
+    if (Stream.gcount() != TRACE_HEADER_BYTES ||
+        std::memcmp(header, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0)
+    {
+      throw std::ios_base::failure("Not a binary trace.");
+    }
+    else if (header[4] != TRACE_VERSION)
+    {
+      throw std::ios_base::failure("Unsupported version of binary trace.");
+    }
+
+    if (header[5] & TRACE_ZSTD)
+    {
+#ifdef ZSTD
+      Decompressor = ZSTD_createDCtx();
+      if (!Decompressor)
+        throw std::bad_alloc();
+      Compressed.resize(ZSTD_DStreamInSize());
+#else
+      throw std::ios_base::failure("Binary trace is compressed, but support "
+                                   "for zstd is not available.");
+#endif
+    }
+  }
+
+  trace_reader_t::~trace_reader_t()
+  {
+#ifdef ZSTD
+    ZSTD_freeDCtx((ZSTD_DCtx*)Decompressor);
+#endif
+  }
+
+  bool trace_reader_t::fill_buffer()
+  {
+    // move the remainder of the last record to the start of the buffer
+    std::copy(Buffer.begin() + Buffer_pos, Buffer.begin() + Buffer_size,
+              Buffer.begin());
+    Buffer_size -= Buffer_pos;
+    Buffer_pos = 0;
+
+    unsigned int old_size = Buffer_size;
+
+#ifdef ZSTD
+    if (Decompressor)
+    {
+      while (Buffer_size == old_size)
+      {
+        if (Compressed_pos == Compressed_size)
+        {
+          Stream.read((char*)&Compressed[0], Compressed.size());
+          Compressed_pos = 0;
+          Compressed_size = Stream.gcount();
+          if (Compressed_size == 0)
+            break;
+        }
+
+        ZSTD_inBuffer in = { &Compressed[0], Compressed_size, Compressed_pos };
+        ZSTD_outBuffer out = { &Buffer[0], Buffer.size(), Buffer_size };
+        size_t result = ZSTD_decompressStream((ZSTD_DCtx*)Decompressor,
+                                              &out, &in);
+        if (ZSTD_isError(result))
+        {
+          throw std::ios_base::failure(std::string("Failed to decompress "
+                                       "trace: ") + ZSTD_getErrorName(result));
+        }
+
+        Compressed_pos = in.pos;
+        Buffer_size = out.pos;
+      }
+
+      return Buffer_size != old_size;
+    }
+#endif
+
+    Stream.read((char*)&Buffer[Buffer_size], Buffer.size() - Buffer_size);
+    Buffer_size += Stream.gcount();
+
+    return Buffer_size != old_size;
+  }
+
+  uint64_t trace_reader_t::get()
+  {
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      if (Buffer_pos == Buffer_size)
+        break;
+
+      uint8_t byte = Buffer[Buffer_pos++];
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+
+    throw std::ios_base::failure("Truncated binary trace.");
+  }
+
+  bool trace_reader_t::read(uword_t &address, uint64_t &cycle, uint64_t &count)
+  {
+    if (Buffer_size - Buffer_pos < TRACE_RECORD_BYTES)
+      fill_buffer();
+
+    if (Buffer_pos == Buffer_size)
+      return false;
+
+    uint64_t delta = get();
+    Last_address += (uword_t)(delta >> 1) ^ -(uword_t)(delta & 1);
+    Last_cycle += get();
+    Last_count += get();
+
+    address = Last_address;
+    cycle = Last_cycle;
+    count = Last_count;
+    return true;
+  }
+}
@@ -0,0 +1,265 @@
+/*
+   Copyright 2012 Technical University of Denmark, DTU Compute.
+   All rights reserved.
+
+   This file is part of the Patmos simulator.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+      1. Redistributions of source code must retain the above copyright notice,
+         this list of conditions and the following disclaimer.
+
+      2. Redistributions in binary form must reproduce the above copyright
+         notice, this list of conditions and the following disclaimer in the
+         documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY EXPRESS
+   OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+   NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   The views and conclusions contained in the software and documentation are
+   those of the authors and should not be interpreted as representing official
+   policies, either expressed or implied, of the copyright holder.
+ */
+
+//
+// Sets of watched addresses used by the debug output.
+//
+
+#include "watch.h"
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <ios>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace patmos
+{
+  void watch_set_t::add(uword_t first, uword_t last, unsigned int kinds)
+  {
+    range_t range = { first, last, kinds };
+    Ranges.push_back(range);
+    Kinds |= kinds;
+    Is_built = false;
+  }
+
+  void watch_set_t::hash_add(uword_t address, unsigned int kinds)
+  {
+    unsigned int mask = Hash_kinds.size() - 1;
+    unsigned int i = hash(address);
+    while (Hash_kinds[i] && Hash_addresses[i] != address)
+      i = (i + 1) & mask;
+
+    Hash_addresses[i] = address;
+    Hash_kinds[i] |= kinds;
+  }
+
+  void watch_set_t::build()
+  {
+    // collect the watched addresses per kind
+    std::vector<uword_t> addresses[3];
+    Large_ranges.clear();
+    for(std::vector<range_t>::const_iterator r = Ranges.begin(),
+        re = Ranges.end(); r != re; r++)
+    {
+      if (r->Last - r->First >= WATCH_RANGE_BYTES)
+      {
+        Large_ranges.push_back(*r);
+        continue;
+      }
+
+      for(unsigned int k = 0; k < 3; k++)
+      {
+        if (r->Kinds & (1 << k))
+        {
+          for(uint64_t a = r->First; a <= r->Last; a++)
+            addresses[k].push_back(a);
+        }
+      }
+    }
+
+    // put the densest region of each kind into a bitmap
+    std::vector<std::pair<uword_t, unsigned int> > others;
+    for(unsigned int k = 0; k < 3; k++)
+    {
+      std::vector<uword_t> &a = addresses[k];
+      std::sort(a.begin(), a.end());
+      a.erase(std::unique(a.begin(), a.end()), a.end());
+
+      unsigned int first = 0, last = 0;
+      for(unsigned int i = 0, j = 0; j < a.size(); j++)
+      {
+        while (a[j] - a[i] >= WATCH_BITMAP_BYTES)
+          i++;
+        if (j + 1 - i > last - first)
+        {
+          first = i;
+          last = j + 1;
+        }
+      }
+
+      bitmap_t &b = Bitmaps[k];
+      b.Base = b.Size = 0;
+      b.Bits.clear();
+      if (last - first >= WATCH_BITMAP_ADDRESSES)
+      {
+        b.Base = a[first];
+        b.Size = a[last - 1] - b.Base + 1;
+        b.Bits.resize((b.Size + 63) / 64);
+        for(unsigned int i = first; i < last; i++)
+        {
+          uword_t offset = a[i] - b.Base;
+          b.Bits[offset / 64] |= (uint64_t)1 << (offset % 64);
+        }
+      }
+      else
+      {
+        first = last = 0;
+      }
+
+      for(unsigned int i = 0; i < a.size(); i++)
+      {
+        if (i < first || i >= last)
+          others.push_back(std::make_pair(a[i], 1 << k));
+      }
+    }
+
+    // put the other addresses into the hash table, at most half full
+    unsigned int size = 2;
+    Hash_shift = 31;
+    while (size < 2 * others.size())
+    {
+      size *= 2;
+      Hash_shift--;
+    }
+    Hash_addresses.assign(size, 0);
+    Hash_kinds.assign(size, 0);
+    for(unsigned int i = 0; i < others.size(); i++)
+      hash_add(others[i].first, others[i].second);
+
+    Is_built = true;
+  }
+
+  bool watch_set_t::lookup(uword_t address, watch_kind_e kind)
+  {
+    if (!Is_built)
+      build();
+
+    // the bitmap holds all watched addresses in its region
+    const bitmap_t &b = Bitmaps[kind >> 1];
+    uword_t offset = address - b.Base;
+    if (offset < b.Size)
+    {
+      if ((b.Bits[offset / 64] >> (offset % 64)) & 1)
+        return true;
+    }
+    else
+    {
+      unsigned int mask = Hash_kinds.size() - 1;
+      for(unsigned int i = hash(address); Hash_kinds[i]; i = (i + 1) & mask)
+      {
+        if (Hash_addresses[i] == address)
+        {
+          if (Hash_kinds[i] & kind)
+            return true;
+          break;
+        }
+      }
+    }
+
+    for(std::vector<range_t>::const_iterator r = Large_ranges.begin(),
+        re = Large_ranges.end(); r != re; r++)
+    {
+      if (r->First <= address && address <= r->Last && (r->Kinds & kind))
+        return true;
+    }
+
+    return false;
+  }
+
+  /// Parse an address, decimal or hexadecimal if prefixed with 0x.
+  static bool parse_address(const std::string &str, uword_t &address)
+  {
+    bool is_hex = str.size() > 2 && str[0] == '0' &&
+                  (str[1] == 'x' || str[1] == 'X');
+
+    std::string digits = is_hex ? str.substr(2) : str;
+    if (digits.empty() || digits.size() > 16 ||
+        digits.find_first_not_of(is_hex ? "0123456789abcdefABCDEF"
+                                        : "0123456789") != std::string::npos)
+      return false;
+
+    uint64_t value = std::stoull(digits, NULL, is_hex ? 16 : 10);
+    if (value > 0xffffffffull)
+      return false;
+
+    address = value;
+    return true;
+  }
+
+  void watch_set_t::read(std::istream &in)
+  {
+    std::string line;
+    for(unsigned int n = 1; std::getline(in, line); n++)
+    {
+      std::istringstream fields(line);
+      std::string range, kinds_str, rest;
+      fields >> range >> kinds_str >> rest;
+
+      // skip empty lines and comments
+      if (range.empty() || range[0] == '#')
+        continue;
+
+      uword_t first, last;
+      std::string::size_type sep = range.find_first_of("-+");
+      bool is_valid = parse_address(range.substr(0, sep), first);
+      if (sep == std::string::npos)
+      {
+        last = first;
+      }
+      else if (range[sep] == '-')
+      {
+        is_valid = is_valid && parse_address(range.substr(sep + 1), last) &&
+                   first <= last;
+      }
+      else
+      {
+        uword_t size = 0;
+        is_valid = is_valid && parse_address(range.substr(sep + 1), size) &&
+                   size > 0 && size - 1 <= 0xffffffffu - first;
+        last = first + size - 1;
+      }
+
+      unsigned int kinds = kinds_str.empty() ? WK_EXEC : 0;
+      for(unsigned int i = 0; i < kinds_str.size(); i++)
+      {
+        switch (kinds_str[i])
+        {
+          case 'r': kinds |= WK_READ; break;
+          case 'w': kinds |= WK_WRITE; break;
+          case 'x': kinds |= WK_EXEC; break;
+          default: is_valid = false;
+        }
+      }
+
+      if (!is_valid || !rest.empty())
+      {
+        throw std::ios_base::failure((boost::format(
+                             "Invalid watchpoint in line %1%: %2%") % n % line).str());
+      }
+
+      add(first, last, kinds);
+    }
+  }
+}
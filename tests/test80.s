@@ -0,0 +1,30 @@
+#
+# Tests the multi-core simulation: core 1 stores a value to the global memory
+# which core 0 is waiting for.
+# Expected Result (with --multicore and two cores): r1 = 0x2a on core 0
+#
+
+                .word   100;
+                add     r1  = r0, 0xF0000000;
+                lwl     r2  = [r1 + 0];
+                add     r3  = r0, 0x10000;
+                cmpneq  p1  = r2, r0;
+           (p1) br      store;
+                nop;
+                nop;
+wait:           lwm     r1  = [r3 + 0];
+                nop;
+                cmpeq   p2  = r1, r0;
+           (p2) br      wait;
+                nop;
+                nop;
+                halt;
+                nop;
+                nop;
+                nop;
+store:          addi    r4  = r0, 42;
+                swm     [r3 + 0] = r4;
+                halt;
+                nop;
+                nop;
+                nop;
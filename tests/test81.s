@@ -0,0 +1,22 @@
+#
+# Tests the performance counters: two loads to the same data cache line, the
+# first misses, the second hits. Then the counters are read.
+# Expected Result: r7 = 1 (D-Cache hits), r8 = 1 (D-Cache misses),
+#                  r9 = 1 (memory reads)
+#
+
+                .word   64;
+                add     r1  = r0, 0xF0060000;
+                add     r3  = r0, 0x10000;
+                lwc     r5  = [r3 + 0];
+                nop;
+                lwc     r6  = [r3 + 1];
+                nop;
+                lwl     r7  = [r1 + 2];
+                lwl     r8  = [r1 + 3];
+                lwl     r9  = [r1 + 8];
+                nop;
+                halt;
+                nop;
+                nop;
+                nop;
@@ -0,0 +1,18 @@
+#
+# Tests a store bypassing the data cache to a cached line: the second load
+# hits in the data cache and has to see the stored value.
+# Expected Result: r5 = 0, r6 = 5
+#
+
+                .word   48;
+                add     r3  = r0, 0x10000;
+                addi    r4  = r0, 5;
+                lwc     r5  = [r3 + 0];
+                nop;
+                swm     [r3 + 0] = r4;
+                lwc     r6  = [r3 + 0];
+                nop;
+                halt;
+                nop;
+                nop;
+                nop;